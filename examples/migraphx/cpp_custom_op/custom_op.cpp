@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// MIGraphX C++ API
+#include <migraphx/migraphx.hpp>
+
+// A hand written kernel that MIGraphX does not provide: x * tanh(log(1 + exp(x)))
+static void mish(const float* x, float* y, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; i++)
+        y[i] = x[i] * std::tanh(std::log1p(std::exp(x[i])));
+}
+
+struct mish_op final : migraphx::experimental_custom_op_base
+{
+    virtual std::string name() const override { return "mish"; }
+    virtual migraphx::shape compute_shape(migraphx::shapes inputs) const override
+    {
+        if(inputs.size() != 1)
+            throw std::runtime_error("mish takes one input");
+        return inputs.front();
+    }
+    virtual migraphx::argument compute(migraphx::context,
+                                       migraphx::argument output,
+                                       migraphx::arguments inputs) const override
+    {
+        // The arguments view buffers owned by the program, so nothing is copied
+        mish(reinterpret_cast<const float*>(inputs[0].data()),
+             reinterpret_cast<float*>(output.data()),
+             output.get_shape().bytes() / sizeof(float));
+        return output;
+    }
+    // The kernel keeps no state, so evals can call it at the same time
+    virtual bool thread_safe() const override { return true; }
+};
+
+static migraphx::instruction
+add_layer(migraphx::module& m, const migraphx::instruction& x, const migraphx::instruction& w)
+{
+    auto dot = m.add_instruction(migraphx::operation("dot"), {x, w});
+    return m.add_instruction(migraphx::operation("relu"), {dot});
+}
+
+template <class F>
+static double time_ms(F f, int iterations)
+{
+    f();
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++)
+        f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    std::string target_name = argc > 1 ? argv[1] : "ref";
+    std::size_t batch       = argc > 2 ? std::stoul(argv[2]) : 64;
+    int iterations          = argc > 3 ? std::stoi(argv[3]) : 100;
+    std::size_t width       = 256;
+
+    mish_op op;
+    migraphx::register_experimental_custom_op(op);
+
+    migraphx::shape xs{migraphx_shape_float_type, {batch, width}};
+    migraphx::shape ws{migraphx_shape_float_type, {width, width}};
+    std::vector<float> w1(width * width, 0.001f);
+    std::vector<float> w2(width * width, -0.002f);
+    std::vector<float> x(batch * width);
+    for(std::size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 17) - 8.0f;
+
+    // One program with the custom op between the two layers
+    migraphx::program fused;
+    {
+        auto m  = fused.get_main_module();
+        auto in = m.add_parameter("x", xs);
+        auto l1 = add_layer(m, in, m.add_literal(ws, w1.data()));
+        auto y  = m.add_instruction(migraphx::operation("mish"), {l1});
+        m.add_return({add_layer(m, y, m.add_literal(ws, w2.data()))});
+    }
+    fused.compile(migraphx::target(target_name.c_str()));
+
+    // The workaround: split the model around the op, and copy the tensors
+    // in and out of MIGraphX at the boundaries
+    migraphx::program first;
+    {
+        auto m  = first.get_main_module();
+        auto in = m.add_parameter("x", xs);
+        m.add_return({add_layer(m, in, m.add_literal(ws, w1.data()))});
+    }
+    first.compile(migraphx::target(target_name.c_str()));
+    migraphx::program second;
+    {
+        auto m  = second.get_main_module();
+        auto in = m.add_parameter("y", xs);
+        m.add_return({add_layer(m, in, m.add_literal(ws, w2.data()))});
+    }
+    second.compile(migraphx::target(target_name.c_str()));
+
+    auto x_arg = migraphx::argument(xs, x.data());
+    migraphx::argument fused_result;
+    auto fused_ms = time_ms([&] { fused_result = fused.eval({{"x", x_arg}})[0]; }, iterations);
+
+    std::vector<float> boundary(x.size());
+    std::vector<float> y(x.size());
+    migraphx::argument split_result;
+    auto split_ms = time_ms(
+        [&] {
+            auto l1 = first.eval({{"x", x_arg}})[0];
+            std::memcpy(boundary.data(), l1.data(), xs.bytes());
+            mish(boundary.data(), y.data(), y.size());
+            split_result = second.eval({{"y", migraphx::argument(xs, y.data())}})[0];
+        },
+        iterations);
+
+    std::cout << "target: " << target_name << ", batch: " << batch << std::endl;
+    std::cout << "custom op:   " << fused_ms << "ms" << std::endl;
+    std::cout << "split graph: " << split_ms << "ms" << std::endl;
+    if(fused_result != split_result)
+    {
+        std::cout << "Error: the results are different" << std::endl;
+        return 1;
+    }
+    return 0;
+}
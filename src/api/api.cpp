@@ -2,6 +2,7 @@
 #include <migraphx/rank.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/executor.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -15,7 +16,10 @@
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cstdarg>
+#include <future>
+#include <mutex>
 
 namespace migraphx {
 
@@ -207,6 +211,28 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(program& p, const parameter_binding& binding) { return p.eval(binding); }
+
+// The result of a run that can be copied by the handles
+struct async_result
+{
+    std::shared_future<std::vector<argument>> future;
+};
+
+async_result run_async(executor& e, const parameter_map& params)
+{
+    return {e.eval_async(params).share()};
+}
+
+bool ready(const async_result& r)
+{
+    return r.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void wait(const async_result& r) { r.future.wait(); }
+
+std::vector<argument> get(const async_result& r) { return r.future.get(); }
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
@@ -224,26 +250,81 @@ struct experimental_custom_op
 template <class CustomOp>
 struct custom_operation
 {
+    CustomOp op;
+    // Set by the lowering of a target when the buffer of the output is
+    // passed as the last input, so it is part of the memory planning
+    bool output_buffer = false;
+    // Calls of ops that are not thread safe are serialized. The mutex is
+    // shared by every copy of the op.
+    bool thread_safe                  = false;
+    std::shared_ptr<std::mutex> guard = std::make_shared<std::mutex>();
+
     template <class Self, class F>
-    static auto reflect(Self&, F)
+    static auto reflect(Self& self, F f)
     {
-        return pack();
+        return pack(f(self.output_buffer, "output_buffer"));
     }
-    CustomOp op;
+
     std::string name() const { return op.xobject.name; }
 
+    value attributes() const { return {{"custom_op", true}}; }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
+        if(output_buffer)
+            inputs.pop_back();
         return op.compute_shape(std::move(inputs));
     }
 
-    argument compute(const std::vector<argument>&) const { MIGRAPHX_THROW("Not computable"); }
+    std::ptrdiff_t custom_alias(std::vector<shape> inputs) const
+    {
+        if(op.output_alias_f == nullptr)
+            return -1;
+        auto i = op.output_alias(std::move(inputs));
+        return i < 0 ? -1 : i;
+    }
+
+    std::ptrdiff_t output_alias(std::vector<shape> inputs) const
+    {
+        if(output_buffer)
+        {
+            inputs.pop_back();
+            auto i = custom_alias(inputs);
+            return i < 0 ? std::ptrdiff_t(inputs.size()) : i;
+        }
+        return custom_alias(std::move(inputs));
+    }
+
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> inputs) const
+    {
+        argument output;
+        if(output_buffer)
+        {
+            output = inputs.back();
+            inputs.pop_back();
+        }
+        else
+        {
+            std::vector<shape> shapes(inputs.size());
+            std::transform(inputs.begin(), inputs.end(), shapes.begin(), [](const auto& a) {
+                return a.get_shape();
+            });
+            auto i = custom_alias(shapes);
+            output = i < 0 ? argument{output_shape} : inputs.at(i);
+        }
+        if(thread_safe)
+            return op.compute(ctx, output, std::move(inputs));
+        std::lock_guard<std::mutex> lock(*guard);
+        return op.compute(ctx, output, std::move(inputs));
+    }
 };
 
 template <class CustomOp>
 void register_custom_op(const CustomOp& op)
 {
-    register_op(custom_operation<CustomOp>{op});
+    custom_operation<CustomOp> x{op};
+    x.thread_safe = op.thread_safe_f != nullptr and op.thread_safe();
+    register_op(x);
 }
 
 migraphx::context get_context(const program& p) { return p.get_context(); }
@@ -441,6 +522,17 @@ struct migraphx_module
     migraphx::module object;
 };
 
+extern "C" struct migraphx_parameter_binding;
+struct migraphx_parameter_binding
+{
+    template <class... Ts>
+    migraphx_parameter_binding(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::parameter_binding object;
+};
+
 extern "C" struct migraphx_program;
 struct migraphx_program
 {
@@ -452,6 +544,28 @@ struct migraphx_program
     migraphx::program object;
 };
 
+extern "C" struct migraphx_async_result;
+struct migraphx_async_result
+{
+    template <class... Ts>
+    migraphx_async_result(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::async_result object;
+};
+
+extern "C" struct migraphx_executor;
+struct migraphx_executor
+{
+    template <class... Ts>
+    migraphx_executor(Ts&&... xs)
+        : object(std::forward<Ts>(xs)...) // NOLINT(readability-redundant-member-init)
+    {
+    }
+    migraphx::executor object;
+};
+
 extern "C" struct migraphx_operation;
 struct migraphx_operation
 {
@@ -554,6 +668,24 @@ struct migraphx_experimental_custom_op
     manage_generic_ptr<migraphx_experimental_custom_op_copy, migraphx_experimental_custom_op_delete>
         object_ptr = nullptr;
     migraphx::experimental_custom_op xobject;
+    migraphx_experimental_custom_op_compute compute_f = nullptr;
+    migraphx::argument compute(migraphx::context& ctx,
+                               migraphx::argument output,
+                               std::vector<migraphx::argument> inputs) const
+    {
+        std::remove_pointer_t<migraphx_argument_t> out;
+        if(compute_f == nullptr)
+            throw std::runtime_error("compute function is missing.");
+        auto api_error_result = compute_f(&out,
+                                          object_ptr.data,
+                                          object_cast<migraphx_context_t>(&(ctx)),
+                                          object_cast<migraphx_argument_t>(&(output)),
+                                          object_cast<migraphx_arguments_t>(&(inputs)));
+        if(api_error_result != migraphx_status_success)
+            throw std::runtime_error("Error in compute.");
+        return (&out)->object;
+    }
+
     migraphx_experimental_custom_op_compute_shape compute_shape_f = nullptr;
     migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
     {
@@ -566,6 +698,31 @@ struct migraphx_experimental_custom_op
             throw std::runtime_error("Error in compute_shape.");
         return (&out)->object;
     }
+
+    migraphx_experimental_custom_op_output_alias output_alias_f = nullptr;
+    int64_t output_alias(std::vector<migraphx::shape> inputs) const
+    {
+        std::remove_pointer_t<int64_t*> out;
+        if(output_alias_f == nullptr)
+            throw std::runtime_error("output_alias function is missing.");
+        auto api_error_result =
+            output_alias_f(&out, object_ptr.data, object_cast<migraphx_shapes_t>(&(inputs)));
+        if(api_error_result != migraphx_status_success)
+            throw std::runtime_error("Error in output_alias.");
+        return out;
+    }
+
+    migraphx_experimental_custom_op_thread_safe thread_safe_f = nullptr;
+    bool thread_safe() const
+    {
+        std::remove_pointer_t<bool*> out;
+        if(thread_safe_f == nullptr)
+            throw std::runtime_error("thread_safe function is missing.");
+        auto api_error_result = thread_safe_f(&out, object_ptr.data);
+        if(api_error_result != migraphx_status_success)
+            throw std::runtime_error("Error in thread_safe.");
+        return out;
+    }
 };
 
 extern "C" migraphx_status migraphx_shape_destroy(migraphx_shape_t shape)
@@ -1118,6 +1275,37 @@ extern "C" migraphx_status migraphx_module_add_return(migraphx_instruction_t* ou
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_parameter_binding_destroy(migraphx_parameter_binding_t parameter_binding)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((parameter_binding)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_parameter_binding_assign_to(migraphx_parameter_binding_t output,
+                                     const_migraphx_parameter_binding_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status
+migraphx_parameter_binding_create(migraphx_parameter_binding_t* parameter_binding,
+                                  const_migraphx_program_t program,
+                                  migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(program == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter program: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *parameter_binding = object_cast<migraphx_parameter_binding_t>(
+            allocate<migraphx::parameter_binding>((program->object), (params->object)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_program_destroy(migraphx_program_t program)
 {
     auto api_error_result = migraphx::try_([&] { destroy((program)); });
@@ -1234,6 +1422,20 @@ extern "C" migraphx_status migraphx_program_run(migraphx_arguments_t* out,
     return api_error_result;
 }
 
+extern "C" migraphx_status migraphx_program_run_bound(migraphx_arguments_t* out,
+                                                      migraphx_program_t program,
+                                                      const_migraphx_parameter_binding_t binding)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(program == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter program: Null pointer");
+        if(binding == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter binding: Null pointer");
+        *out = allocate<migraphx_arguments_t>(migraphx::run((program->object), (binding->object)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status
 migraphx_program_equal(bool* out, const_migraphx_program_t program, const_migraphx_program_t x)
 {
@@ -1258,6 +1460,92 @@ migraphx_program_experimental_get_context(migraphx_context_t* out, const_migraph
     return api_error_result;
 }
 
+extern "C" migraphx_status migraphx_async_result_destroy(migraphx_async_result_t async_result)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((async_result)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_async_result_assign_to(migraphx_async_result_t output,
+                                                           const_migraphx_async_result_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_async_result_ready(bool* out,
+                                                       const_migraphx_async_result_t async_result)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(async_result == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter async_result: Null pointer");
+        *out = migraphx::ready((async_result->object));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_async_result_wait(const_migraphx_async_result_t async_result)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(async_result == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter async_result: Null pointer");
+        migraphx::wait((async_result->object));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_async_result_get(migraphx_arguments_t* out,
+                                                     const_migraphx_async_result_t async_result)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(async_result == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter async_result: Null pointer");
+        *out = allocate<migraphx_arguments_t>(migraphx::get((async_result->object)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_executor_destroy(migraphx_executor_t executor)
+{
+    auto api_error_result = migraphx::try_([&] { destroy((executor)); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_executor_assign_to(migraphx_executor_t output,
+                                                       const_migraphx_executor_t input)
+{
+    auto api_error_result = migraphx::try_([&] { *output = *input; });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_executor_create(migraphx_executor_t* executor,
+                                                    const_migraphx_program_t program,
+                                                    size_t workers)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(program == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter program: Null pointer");
+        *executor = object_cast<migraphx_executor_t>(
+            allocate<migraphx::executor>((program->object), (workers)));
+    });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_executor_run_async(migraphx_async_result_t* out,
+                                                       migraphx_executor_t executor,
+                                                       migraphx_program_parameters_t params)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(executor == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter executor: Null pointer");
+        if(params == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter params: Null pointer");
+        *out = allocate<migraphx_async_result_t>(
+            migraphx::run_async((executor->object), (params->object)));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_operation_destroy(migraphx_operation_t operation)
 {
     auto api_error_result = migraphx::try_([&] { destroy((operation)); });
@@ -1700,6 +1988,17 @@ extern "C" migraphx_status migraphx_quantize_int8(migraphx_program_t prog,
     return api_error_result;
 }
 
+extern "C" migraphx_status
+migraphx_quantize_weights(migraphx_program_t prog, size_t bits, size_t group_size)
+{
+    auto api_error_result = migraphx::try_([&] {
+        if(prog == nullptr)
+            MIGRAPHX_THROW(migraphx_status_bad_param, "Bad parameter prog: Null pointer");
+        migraphx::quantize_weights((prog->object), (bits), (group_size));
+    });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_context_finish(const_migraphx_context_t context)
 {
     auto api_error_result = migraphx::try_([&] {
@@ -1749,6 +2048,13 @@ migraphx_experimental_custom_op_create(migraphx_experimental_custom_op_t* experi
     return api_error_result;
 }
 
+extern "C" migraphx_status migraphx_experimental_custom_op_set_compute(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_compute input)
+{
+    auto api_error_result = migraphx::try_([&] { (obj)->compute_f = (input); });
+    return api_error_result;
+}
+
 extern "C" migraphx_status migraphx_experimental_custom_op_set_compute_shape(
     migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_compute_shape input)
 {
@@ -1756,6 +2062,20 @@ extern "C" migraphx_status migraphx_experimental_custom_op_set_compute_shape(
     return api_error_result;
 }
 
+extern "C" migraphx_status migraphx_experimental_custom_op_set_output_alias(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_output_alias input)
+{
+    auto api_error_result = migraphx::try_([&] { (obj)->output_alias_f = (input); });
+    return api_error_result;
+}
+
+extern "C" migraphx_status migraphx_experimental_custom_op_set_thread_safe(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_thread_safe input)
+{
+    auto api_error_result = migraphx::try_([&] { (obj)->thread_safe_f = (input); });
+    return api_error_result;
+}
+
 extern "C" migraphx_status
 migraphx_experimental_custom_op_register(migraphx_experimental_custom_op_t experimental_custom_op)
 {
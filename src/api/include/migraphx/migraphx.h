@@ -76,9 +76,18 @@ typedef const struct migraphx_modules* const_migraphx_modules_t;
 typedef struct migraphx_module* migraphx_module_t;
 typedef const struct migraphx_module* const_migraphx_module_t;
 
+typedef struct migraphx_parameter_binding* migraphx_parameter_binding_t;
+typedef const struct migraphx_parameter_binding* const_migraphx_parameter_binding_t;
+
 typedef struct migraphx_program* migraphx_program_t;
 typedef const struct migraphx_program* const_migraphx_program_t;
 
+typedef struct migraphx_async_result* migraphx_async_result_t;
+typedef const struct migraphx_async_result* const_migraphx_async_result_t;
+
+typedef struct migraphx_executor* migraphx_executor_t;
+typedef const struct migraphx_executor* const_migraphx_executor_t;
+
 typedef struct migraphx_operation* migraphx_operation_t;
 typedef const struct migraphx_operation* const_migraphx_operation_t;
 
@@ -106,10 +115,22 @@ typedef const struct migraphx_context* const_migraphx_context_t;
 typedef struct migraphx_experimental_custom_op* migraphx_experimental_custom_op_t;
 typedef const struct migraphx_experimental_custom_op* const_migraphx_experimental_custom_op_t;
 
+typedef migraphx_status (*migraphx_experimental_custom_op_compute)(migraphx_argument_t out,
+                                                                   void* obj,
+                                                                   migraphx_context_t ctx,
+                                                                   migraphx_argument_t output,
+                                                                   migraphx_arguments_t inputs);
+
 typedef migraphx_status (*migraphx_experimental_custom_op_compute_shape)(migraphx_shape_t out,
                                                                          void* obj,
                                                                          migraphx_shapes_t inputs);
 
+typedef migraphx_status (*migraphx_experimental_custom_op_output_alias)(int64_t* out,
+                                                                        void* obj,
+                                                                        migraphx_shapes_t inputs);
+
+typedef migraphx_status (*migraphx_experimental_custom_op_thread_safe)(bool* out, void* obj);
+
 typedef migraphx_status (*migraphx_experimental_custom_op_copy)(void** out, void* input);
 
 typedef migraphx_status (*migraphx_experimental_custom_op_delete)(void* input);
@@ -272,6 +293,15 @@ migraphx_status migraphx_module_add_return(migraphx_instruction_t* out,
                                            migraphx_module_t module,
                                            migraphx_instructions_t args);
 
+migraphx_status migraphx_parameter_binding_destroy(migraphx_parameter_binding_t parameter_binding);
+
+migraphx_status migraphx_parameter_binding_assign_to(migraphx_parameter_binding_t output,
+                                                     const_migraphx_parameter_binding_t input);
+
+migraphx_status migraphx_parameter_binding_create(migraphx_parameter_binding_t* parameter_binding,
+                                                  const_migraphx_program_t program,
+                                                  migraphx_program_parameters_t params);
+
 migraphx_status migraphx_program_destroy(migraphx_program_t program);
 
 migraphx_status migraphx_program_assign_to(migraphx_program_t output,
@@ -304,12 +334,41 @@ migraphx_status migraphx_program_run(migraphx_arguments_t* out,
                                      migraphx_program_t program,
                                      migraphx_program_parameters_t params);
 
+migraphx_status migraphx_program_run_bound(migraphx_arguments_t* out,
+                                           migraphx_program_t program,
+                                           const_migraphx_parameter_binding_t binding);
+
 migraphx_status
 migraphx_program_equal(bool* out, const_migraphx_program_t program, const_migraphx_program_t x);
 
 migraphx_status migraphx_program_experimental_get_context(migraphx_context_t* out,
                                                           const_migraphx_program_t program);
 
+migraphx_status migraphx_async_result_destroy(migraphx_async_result_t async_result);
+
+migraphx_status migraphx_async_result_assign_to(migraphx_async_result_t output,
+                                                const_migraphx_async_result_t input);
+
+migraphx_status migraphx_async_result_ready(bool* out, const_migraphx_async_result_t async_result);
+
+migraphx_status migraphx_async_result_wait(const_migraphx_async_result_t async_result);
+
+migraphx_status migraphx_async_result_get(migraphx_arguments_t* out,
+                                          const_migraphx_async_result_t async_result);
+
+migraphx_status migraphx_executor_destroy(migraphx_executor_t executor);
+
+migraphx_status migraphx_executor_assign_to(migraphx_executor_t output,
+                                            const_migraphx_executor_t input);
+
+migraphx_status migraphx_executor_create(migraphx_executor_t* executor,
+                                         const_migraphx_program_t program,
+                                         size_t workers);
+
+migraphx_status migraphx_executor_run_async(migraphx_async_result_t* out,
+                                            migraphx_executor_t executor,
+                                            migraphx_program_parameters_t params);
+
 migraphx_status migraphx_operation_destroy(migraphx_operation_t operation);
 
 migraphx_status migraphx_operation_assign_to(migraphx_operation_t output,
@@ -436,6 +495,9 @@ migraphx_status migraphx_quantize_int8(migraphx_program_t prog,
                                        migraphx_target_t target,
                                        migraphx_quantize_int8_options_t options);
 
+migraphx_status
+migraphx_quantize_weights(migraphx_program_t prog, size_t bits, size_t group_size);
+
 migraphx_status migraphx_context_finish(const_migraphx_context_t context);
 
 migraphx_status migraphx_context_get_queue(void** out, migraphx_context_t context);
@@ -454,9 +516,18 @@ migraphx_experimental_custom_op_create(migraphx_experimental_custom_op_t* experi
                                        migraphx_experimental_custom_op_delete d,
                                        const char* name);
 
+migraphx_status migraphx_experimental_custom_op_set_compute(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_compute input);
+
 migraphx_status migraphx_experimental_custom_op_set_compute_shape(
     migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_compute_shape input);
 
+migraphx_status migraphx_experimental_custom_op_set_output_alias(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_output_alias input);
+
+migraphx_status migraphx_experimental_custom_op_set_thread_safe(
+    migraphx_experimental_custom_op_t obj, migraphx_experimental_custom_op_thread_safe input);
+
 migraphx_status
 migraphx_experimental_custom_op_register(migraphx_experimental_custom_op_t experimental_custom_op);
 
@@ -2,6 +2,7 @@
 #define MIGRAPHX_GUARD_API_RTGLIB_MIGRAPHX_HPP
 
 #include "migraphx.h"
+#include <array>
 #include <initializer_list>
 #include <migraphx/migraphx.h>
 #include <memory>
@@ -393,7 +394,7 @@ struct interface_base : Base
     template <class T, class U>
     void auto_assign(rank<0>, T* out, U x)
     {
-        return *out = x;
+        *out = x;
     }
 
     template <class T, class U>
@@ -785,7 +786,7 @@ struct module
     std::shared_ptr<migraphx_module> mm;
 };
 
-struct context
+struct context : handle_lookup<context, migraphx_context>
 {
     context(migraphx_context* p, borrow) : ctx(std::shared_ptr<migraphx_context*>(), p) {}
 
@@ -832,6 +833,8 @@ struct compile_options : MIGRAPHX_HANDLE_BASE(compile_options)
     }
 };
 
+struct parameter_binding;
+
 /// A program represents the all computation graphs to be compiled and executed
 struct program : MIGRAPHX_HANDLE_BASE(program)
 {
@@ -881,6 +884,9 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
         return arguments(pout, own{});
     }
 
+    /// Run the program using parameters that were bound to it before
+    arguments eval(const parameter_binding& pbinding) const;
+
     void print() const { call(&migraphx_program_print, this->get_handle_ptr()); }
 
     program sort()
@@ -920,6 +926,80 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
     friend bool operator!=(const program& px, const program& py) { return !(px == py); }
 };
 
+/// Arguments bound to the parameters of a program. The names and shapes of
+/// the parameters are checked once, so the binding can be run many times.
+/// The buffers of the arguments are used by every run, so new inputs can be
+/// written into them between runs. Output parameters, which are named
+/// #output_N, can be bound so the outputs are written into the caller's
+/// buffers, otherwise each run allocates them.
+struct parameter_binding : MIGRAPHX_HANDLE_BASE(parameter_binding)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(parameter_binding);
+
+    parameter_binding(const program& p, const program_parameters& pparams)
+    {
+        this->make_handle(
+            &migraphx_parameter_binding_create, p.get_handle_ptr(), pparams.get_handle_ptr());
+    }
+};
+
+inline arguments program::eval(const parameter_binding& pbinding) const
+{
+    migraphx_arguments_t pout;
+    call(&migraphx_program_run_bound, &pout, this->get_handle_ptr(), pbinding.get_handle_ptr());
+    return arguments(pout, own{});
+}
+
+/// The outputs of a program that runs asynchronously. Copies share the same
+/// result.
+struct async_result : MIGRAPHX_HANDLE_BASE(async_result)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(async_result);
+
+    /// Whether the run has finished, so get does not block
+    bool ready() const
+    {
+        bool pout;
+        call(&migraphx_async_result_ready, &pout, this->get_handle_ptr());
+        return pout;
+    }
+
+    void wait() const { call(&migraphx_async_result_wait, this->get_handle_ptr()); }
+
+    /// Wait for the run to finish and return its outputs, or throw the error
+    /// of the run
+    arguments get() const
+    {
+        migraphx_arguments_t pout;
+        call(&migraphx_async_result_get, &pout, this->get_handle_ptr());
+        return arguments(pout, own{});
+    }
+};
+
+/// Runs a compiled program asynchronously. The runs are queued and done in
+/// order by a pool of worker threads, each with its own copy of the program,
+/// so the caller can prepare the next inputs, or read the last outputs, while
+/// a run is going on. The workers finish the queued runs when the last copy
+/// of the executor is destroyed.
+struct executor : MIGRAPHX_HANDLE_BASE(executor)
+{
+    MIGRAPHX_HANDLE_CONSTRUCTOR(executor);
+
+    executor(const program& p, size_t workers = 1)
+    {
+        this->make_handle(&migraphx_executor_create, p.get_handle_ptr(), workers);
+    }
+
+    /// Queue a run of the program. The buffers of the parameters must stay
+    /// valid until the run has finished.
+    async_result run_async(const program_parameters& pparams) const
+    {
+        migraphx_async_result_t pout;
+        call(&migraphx_executor_run_async, &pout, this->get_handle_ptr(), pparams.get_handle_ptr());
+        return async_result(pout, own{});
+    }
+};
+
 // options for migraphx file format options
 struct file_options : MIGRAPHX_HANDLE_BASE(file_options)
 {
@@ -1152,11 +1232,32 @@ quantize_int8(const program& prog, const target& ptarget, const quantize_int8_op
          options.get_handle_ptr());
 }
 
+/// Store the weights of dot as int8 or int4, with a scale for each group of
+/// group_size weights, or for each output channel when it is 0
+inline void quantize_weights(const program& prog, size_t bits = 8, size_t group_size = 0)
+{
+    call(&migraphx_quantize_weights, prog.get_handle_ptr(), bits, group_size);
+}
+
 struct experimental_custom_op_base
 {
     virtual std::string name() const                 = 0;
     virtual shape compute_shape(shapes inputs) const = 0;
-    virtual ~experimental_custom_op_base()           = default;
+    /// Compute the result into the output buffer, which is sized for the
+    /// shape returned by compute_shape. The arguments only view memory owned
+    /// by the program, so they must not be kept after compute returns. Ops
+    /// that are only used to compute shapes do not need to override it.
+    virtual argument compute(context, argument, arguments) const
+    {
+        throw std::runtime_error("not computable");
+    }
+    /// Index of the input that the output is written into, or -1 if the
+    /// output gets its own buffer
+    virtual int64_t output_alias(shapes) const { return -1; }
+    /// Whether compute can be called from several evals at the same time.
+    /// Otherwise the calls are serialized.
+    virtual bool thread_safe() const { return false; }
+    virtual ~experimental_custom_op_base() = default;
 };
 
 struct experimental_custom_op : interface_base<MIGRAPHX_HANDLE_BASE(experimental_custom_op)>
@@ -1165,7 +1266,10 @@ struct experimental_custom_op : interface_base<MIGRAPHX_HANDLE_BASE(experimental
     experimental_custom_op(T& obj)
     {
         this->make_interface(&migraphx_experimental_custom_op_create, obj, obj.name().c_str());
+        MIGRAPHX_INTERFACE_LIFT(T, experimental_custom_op, compute);
         MIGRAPHX_INTERFACE_LIFT(T, experimental_custom_op, compute_shape);
+        MIGRAPHX_INTERFACE_LIFT(T, experimental_custom_op, output_alias);
+        MIGRAPHX_INTERFACE_LIFT(T, experimental_custom_op, thread_safe);
     }
 
     void register_op() { call(&migraphx_experimental_custom_op_register, this->get_handle_ptr()); }
@@ -223,6 +223,14 @@ def module(h):
              returns='migraphx::instruction_ref')
 
 
+@api.handle('migraphx_parameter_binding', 'migraphx::parameter_binding')
+def parameter_binding(h):
+    h.constructor(
+        'create',
+        api.params(program='const migraphx::program&',
+                   params='std::unordered_map<std::string, migraphx::argument>'))
+
+
 @auto_handle()
 def program(h):
     h.constructor('create')
@@ -246,6 +254,10 @@ def program(h):
                  params='std::unordered_map<std::string, migraphx::argument>'),
              invoke='migraphx::run($@)',
              returns='std::vector<migraphx::argument>')
+    h.method('run_bound',
+             api.params(binding='const migraphx::parameter_binding&'),
+             invoke='migraphx::run($@)',
+             returns='std::vector<migraphx::argument>')
     h.method('equal',
              api.params(x='const migraphx::program&'),
              invoke='migraphx::equal($@)',
@@ -257,6 +269,28 @@ def program(h):
              returns='migraphx::context')
 
 
+@auto_handle()
+def async_result(h):
+    h.method('ready', invoke='migraphx::ready($@)', returns='bool', const=True)
+    h.method('wait', invoke='migraphx::wait($@)', const=True)
+    h.method('get',
+             invoke='migraphx::get($@)',
+             returns='std::vector<migraphx::argument>',
+             const=True)
+
+
+@auto_handle()
+def executor(h):
+    h.constructor(
+        'create',
+        api.params(program='const migraphx::program&', workers='size_t'))
+    h.method('run_async',
+             api.params(
+                 params='std::unordered_map<std::string, migraphx::argument>'),
+             invoke='migraphx::run_async($@)',
+             returns='migraphx::async_result')
+
+
 @auto_handle()
 def operation(h):
     h.constructor('create',
@@ -402,6 +436,12 @@ api.add_function('migraphx_quantize_int8',
                             options='migraphx::quantize_int8_options'),
                  fname='migraphx::quantize_int8_wrap')
 
+api.add_function('migraphx_quantize_weights',
+                 api.params(prog='migraphx::program&',
+                            bits='size_t',
+                            group_size='size_t'),
+                 fname='migraphx::quantize_weights')
+
 
 @auto_handle(ref=True)
 def context(h):
@@ -413,7 +453,16 @@ def context(h):
                'migraphx::experimental_custom_op')
 def experimental_custom_op(h):
     h.constructor('create', api.params(name='const char*'))
+    h.virtual('compute',
+              api.params(ctx='migraphx::context&',
+                         output='migraphx::argument',
+                         inputs='std::vector<migraphx::argument>'),
+              returns='migraphx::argument')
     h.virtual('compute_shape',
               api.params(inputs='std::vector<migraphx::shape>'),
               returns='migraphx::shape')
+    h.virtual('output_alias',
+              api.params(inputs='std::vector<migraphx::shape>'),
+              returns='int64_t')
+    h.virtual('thread_safe', returns='bool')
     h.method('register', invoke='migraphx::register_custom_op($@)')
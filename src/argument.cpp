@@ -1,5 +1,9 @@
 #include <migraphx/argument.hpp>
+#include <migraphx/argument_pool.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <numeric>
 #include <unordered_map>
 
 namespace migraphx {
@@ -7,7 +11,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 argument::argument(const shape& s) : m_shape(s)
 {
-    auto buffer = make_shared_array<char>(s.bytes());
+    auto* pool  = get_argument_pool();
+    auto buffer = pool == nullptr ? make_shared_array<char>(s.bytes()) : pool->allocate(s.bytes());
     assign_buffer({[=]() mutable { return buffer.get(); }});
 }
 
@@ -104,10 +109,48 @@ bool argument::empty() const { return not m_data.get and m_data.sub.empty(); }
 
 const shape& argument::get_shape() const { return this->m_shape; }
 
+// Maps the extent to the reshaped lens, when the padding is only on one axis
+// and the data is standard, so the values are in the same place. Otherwise
+// the extent is dropped, which is still correct since the padding is zero.
+static std::vector<std::size_t>
+reshape_extent(const shape& from, const shape& to, const std::vector<std::size_t>& extent)
+{
+    if(extent.empty() or from == to)
+        return extent;
+    if(not from.standard() or not to.standard())
+        return {};
+    const auto& lens = from.lens();
+    // The axis that is padded
+    auto it = std::mismatch(extent.begin(), extent.end(), lens.begin()).first;
+    auto p  = it - extent.begin();
+    if(not std::equal(extent.begin() + p + 1, extent.end(), lens.begin() + p + 1))
+        return {};
+    auto product = [](auto start, auto last) {
+        return std::accumulate(start, last, std::size_t{1}, std::multiplies<>{});
+    };
+    auto outer        = product(lens.begin(), lens.begin() + p);
+    auto inner        = product(lens.begin() + p + 1, lens.end());
+    const auto& rlens = to.lens();
+    for(std::size_t k = 0; k < rlens.size(); k++)
+    {
+        if(product(rlens.begin(), rlens.begin() + k) != outer)
+            continue;
+        auto rinner = product(rlens.begin() + k + 1, rlens.end());
+        if(rlens[k] * rinner != lens[p] * inner or (extent[p] * inner) % rinner != 0)
+            continue;
+        auto result = rlens;
+        result[k]   = extent[p] * inner / rinner;
+        return result;
+    }
+    return {};
+}
+
 argument argument::reshape(const shape& s) const
 {
     assert(s.element_space() <= this->get_shape().element_space());
-    return {s, this->m_data};
+    auto d   = this->m_data;
+    d.extent = reshape_extent(this->get_shape(), s, d.extent);
+    return {s, d};
 }
 
 argument::data_t argument::data_t::share() const
@@ -118,6 +161,7 @@ argument::data_t argument::data_t::share() const
         auto self  = std::make_shared<data_t>(*this);
         result.get = [self]() mutable { return self->get(); };
     }
+    result.extent = extent;
     std::transform(sub.begin(), sub.end(), std::back_inserter(result.sub), [](const auto& d) {
         return d.share();
     });
@@ -138,6 +182,7 @@ argument argument::copy() const
     argument result{this->get_shape()};
     auto* src = this->data();
     std::copy(src, src + this->get_shape().bytes(), result.data());
+    result.m_data.extent = m_data.extent;
     return result;
 }
 
@@ -165,5 +210,28 @@ argument argument::element(std::size_t i) const
     return argument{shape{this->get_shape().type()}, this->data() + offset};
 }
 
+std::vector<std::size_t> argument::extent() const
+{
+    if(m_data.extent.empty())
+        return m_shape.lens();
+    return m_data.extent;
+}
+
+bool argument::padded() const { return not m_data.extent.empty(); }
+
+argument argument::with_extent(std::vector<std::size_t> e) const
+{
+    const auto& lens = m_shape.lens();
+    if(e.size() != lens.size() or
+       not std::equal(e.begin(), e.end(), lens.begin(), std::less_equal<>{}))
+        MIGRAPHX_THROW("WITH_EXTENT: Extent must fit in the shape");
+    auto d = m_data;
+    if(e == lens)
+        d.extent.clear();
+    else
+        d.extent = std::move(e);
+    return {m_shape, d};
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
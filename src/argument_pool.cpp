@@ -0,0 +1,198 @@
+#include <migraphx/argument_pool.hpp>
+#include <migraphx/env.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_ARGUMENT_POOL)
+
+const std::size_t min_class_bits = 6;
+// Larger buffers are not cached
+const std::size_t max_pooled_size = std::size_t{1} << 30;
+
+std::size_t argument_pool::size_class(std::size_t n)
+{
+    if(n <= (std::size_t{1} << min_class_bits))
+        return 0;
+    // n - 1 is in [2^k, 2^(k+1))
+    std::size_t k    = 63 - __builtin_clzll(n - 1);
+    std::size_t step = ((n - 1) - (std::size_t{1} << k)) >> (k - 2);
+    return 1 + (k - min_class_bits) * 4 + step;
+}
+
+std::size_t argument_pool::class_size(std::size_t c)
+{
+    if(c == 0)
+        return std::size_t{1} << min_class_bits;
+    std::size_t k    = min_class_bits + (c - 1) / 4;
+    std::size_t step = (c - 1) % 4;
+    return (std::size_t{1} << k) + ((step + 1) << (k - 2));
+}
+
+struct argument_pool::impl
+{
+    static const std::size_t nshards = 8;
+    struct shard
+    {
+        std::mutex m;
+        std::vector<std::vector<char*>> buffers;
+    };
+    std::array<shard, nshards> shards;
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::size_t> reused{0};
+    std::atomic<std::size_t> cached{0};
+    std::atomic<std::size_t> in_use{0};
+    std::atomic<std::size_t> peak{0};
+
+    impl()
+    {
+        auto nclasses = size_class(max_pooled_size) + 1;
+        for(auto& s : shards)
+            s.buffers.resize(nclasses);
+    }
+
+    impl(const impl&) = delete;
+    impl& operator=(const impl&) = delete;
+
+    ~impl()
+    {
+        for(auto& s : shards)
+        {
+            for(auto& b : s.buffers)
+            {
+                for(auto* p : b)
+                    delete[] p; // NOLINT
+            }
+        }
+    }
+
+    static std::size_t thread_shard()
+    {
+        thread_local const std::size_t id =
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) % nshards;
+        return id;
+    }
+
+    char* take(std::size_t c)
+    {
+        auto first = thread_shard();
+        // Look in the shard of this thread first, and then steal from the others
+        for(std::size_t i = 0; i < nshards; i++)
+        {
+            auto& s = shards[(first + i) % nshards];
+            std::lock_guard<std::mutex> lock(s.m);
+            auto& b = s.buffers[c];
+            if(b.empty())
+                continue;
+            auto* p = b.back();
+            b.pop_back();
+            cached -= class_size(c);
+            return p;
+        }
+        return nullptr;
+    }
+
+    void give(char* p, std::size_t c)
+    {
+        auto& s = shards[thread_shard()];
+        std::lock_guard<std::mutex> lock(s.m);
+        s.buffers[c].push_back(p);
+        cached += class_size(c);
+    }
+
+    void update_peak()
+    {
+        auto n = in_use.load();
+        auto p = peak.load();
+        while(n > p and not peak.compare_exchange_weak(p, n))
+        {
+        }
+    }
+
+    void trim(std::size_t limit)
+    {
+        // Free the largest buffers first
+        for(auto c = shards.front().buffers.size(); c > 0 and cached > limit; c--)
+        {
+            for(auto& s : shards)
+            {
+                std::lock_guard<std::mutex> lock(s.m);
+                auto& b = s.buffers[c - 1];
+                while(not b.empty() and cached > limit)
+                {
+                    delete[] b.back(); // NOLINT
+                    b.pop_back();
+                    cached -= class_size(c - 1);
+                }
+            }
+        }
+    }
+};
+
+argument_pool::argument_pool() : pimpl(std::make_shared<impl>()) {}
+
+std::shared_ptr<char> argument_pool::allocate(std::size_t n)
+{
+    pimpl->allocations++;
+    pimpl->bytes += n;
+    if(n > max_pooled_size)
+        return std::shared_ptr<char>(new char[n](), std::default_delete<char[]>()); // NOLINT
+    auto c    = size_class(n);
+    auto size = class_size(c);
+    assert(size >= n);
+    char* p = pimpl->take(c);
+    if(p == nullptr)
+    {
+        p = new char[size](); // NOLINT
+    }
+    else
+    {
+        pimpl->reused++;
+        std::memset(p, 0, n);
+    }
+    pimpl->in_use += size;
+    pimpl->update_peak();
+    // The deleter keeps the pool alive, so buffers can outlive the pool object
+    auto self = pimpl;
+    return std::shared_ptr<char>(p, [self, c, size](char* x) {
+        self->in_use -= size;
+        self->give(x, c);
+    });
+}
+
+argument_pool_stats argument_pool::stats() const
+{
+    argument_pool_stats result;
+    result.allocations  = pimpl->allocations;
+    result.bytes        = pimpl->bytes;
+    result.reused       = pimpl->reused;
+    result.cached_bytes = pimpl->cached;
+    return result;
+}
+
+void argument_pool::trim(std::size_t limit) { pimpl->trim(limit); }
+
+void argument_pool::end_eval()
+{
+    pimpl->trim(pimpl->peak.load());
+    pimpl->peak = pimpl->in_use.load();
+}
+
+argument_pool* get_argument_pool()
+{
+    static std::unique_ptr<argument_pool> pool =
+        enabled(MIGRAPHX_DISABLE_ARGUMENT_POOL{}) ? nullptr : std::make_unique<argument_pool>();
+    return pool.get();
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,28 @@
+#include <migraphx/dot_weights.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+instruction_ref get_dot_weights(instruction_ref b)
+{
+    auto w = b;
+    while(contains({"contiguous", "multibroadcast"}, w->name()) and
+          w->get_shape().lens().size() > 2)
+        w = w->inputs().front();
+    auto lens = b->get_shape().lens();
+    if(w->get_shape().lens().size() != 2 or
+       not std::equal(lens.end() - 2, lens.end(), w->get_shape().lens().begin()))
+        return b;
+    return w;
+}
+
+bool is_float(const shape& s)
+{
+    return contains({shape::float_type, shape::half_type, shape::double_type}, s.type());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -184,7 +184,7 @@ struct argument_parser
     MIGRAPHX_DRIVER_STATIC auto append()
     {
         return write_action([](auto&, auto& x, auto& params) {
-            using type = typename bare<decltype(params)>::value_type;
+            using type = typename bare<decltype(x)>::value_type;
             std::transform(params.begin(),
                            params.end(),
                            std::inserter(x, x.end()),
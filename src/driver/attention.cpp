@@ -0,0 +1,39 @@
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include "models.hpp"
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// A single multi-head attention block, with 12 heads of size 64
+migraphx::program attention(unsigned batch, unsigned seq_len)
+{
+    const std::size_t heads = 12;
+    const std::size_t depth = 64;
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {batch, heads, seq_len, depth}};
+    migraphx::shape ms{migraphx::shape::float_type, {batch, 1, 1, seq_len}};
+    auto q    = mm->add_parameter("q", s);
+    auto k    = mm->add_parameter("k", s);
+    auto v    = mm->add_parameter("v", s);
+    auto mask = mm->add_parameter("mask", ms);
+    auto kt =
+        mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+    auto scores = mm->add_instruction(migraphx::make_op("dot"), q, kt);
+    std::vector<std::size_t> lens{batch, heads, seq_len, seq_len};
+    auto scale = mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}),
+                                     mm->add_literal(0.125f));
+    auto scaled = mm->add_instruction(migraphx::make_op("mul"), scores, scale);
+    auto mask_mbcast =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}), mask);
+    auto masked = mm->add_instruction(migraphx::make_op("add"), scaled, mask_mbcast);
+    auto probs  = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), masked);
+    mm->add_instruction(migraphx::make_op("dot"), probs, v);
+    return p;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
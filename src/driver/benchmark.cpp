@@ -0,0 +1,303 @@
+#include "benchmark.hpp"
+
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/time.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+using seconds      = std::chrono::duration<double>;
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    // Nearest-rank percentile
+    auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+
+latency_stats compute_latency_stats(std::vector<double> samples)
+{
+    latency_stats result;
+    if(samples.empty())
+        return result;
+    std::sort(samples.begin(), samples.end());
+    auto n       = samples.size();
+    result.count = n;
+    result.mean  = std::accumulate(samples.begin(), samples.end(), 0.0) / n;
+    if(n > 1)
+    {
+        double ss = std::accumulate(samples.begin(), samples.end(), 0.0, [&](double acc, double x) {
+            return acc + (x - result.mean) * (x - result.mean);
+        });
+        result.stddev = std::sqrt(ss / (n - 1));
+        result.ci95   = 1.96 * result.stddev / std::sqrt(n);
+    }
+    result.min = samples.front();
+    result.max = samples.back();
+    result.p50 = percentile(samples, 50);
+    result.p90 = percentile(samples, 90);
+    result.p99 = percentile(samples, 99);
+    return result;
+}
+
+static double run_once(const program& p, const parameter_map& params)
+{
+    return time<milliseconds>([&] {
+        p.eval(params);
+        p.get_context().finish();
+    });
+}
+
+static std::string read_first_line(const std::string& filename)
+{
+    std::ifstream is(filename);
+    std::string line;
+    std::getline(is, line);
+    return line;
+}
+
+// Current frequency of the first cpu in kHz, or 0 when it is not available
+static double cpu_frequency()
+{
+    auto line = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+    if(line.empty())
+        return 0;
+    return std::stod(line);
+}
+
+static double median(std::vector<double> x)
+{
+    std::sort(x.begin(), x.end());
+    return percentile(x, 50);
+}
+
+// The numa node is only set on contexts that support it, and -1 runs on
+// the whole machine
+static void set_numa_node(const program& p, int node)
+{
+    auto& ctx = p.get_context();
+    auto v    = ctx.to_value();
+    if(not v.is_object() or not v.contains("numa_node"))
+        return;
+    v["numa_node"] = node;
+    ctx.from_value(v);
+}
+
+static std::size_t numa_node_count(const program& p)
+{
+    auto v = p.get_context().to_value();
+    if(not v.is_object())
+        return 1;
+    return std::max<std::size_t>(v.get("numa_nodes", std::size_t{1}), 1);
+}
+
+static benchmark_run run_concurrent(const program& p,
+                                    const parameter_map& params,
+                                    std::size_t n,
+                                    std::size_t iterations,
+                                    const benchmark_options& options,
+                                    std::vector<std::string>& warnings)
+{
+    n                      = std::max<std::size_t>(n, 1);
+    std::size_t per_thread = (iterations + n - 1) / n;
+    // Each client gets its own copy of the program so the evals do not share
+    // any execution state
+    std::vector<program> programs(n - 1, p);
+    if(options.numa)
+    {
+        auto nodes = numa_node_count(p);
+        set_numa_node(p, 0);
+        for(std::size_t i = 1; i < n; i++)
+            set_numa_node(programs[i - 1], i % nodes);
+    }
+    std::vector<std::vector<double>> samples(n);
+    auto client = [&](std::size_t i) -> const program& {
+        return i == 0 ? p : programs[i - 1];
+    };
+    auto run_client = [&](const program& cp, std::vector<double>& s) {
+        timer t{};
+        s.reserve(per_thread);
+        while(s.size() < per_thread)
+        {
+            // Bound the run in case the estimate was too optimistic
+            if(options.duration > 0 and t.record<seconds>() > 2 * options.duration)
+                break;
+            s.push_back(run_once(cp, params));
+        }
+    };
+    if(options.numa)
+    {
+        // The weights are replicated on each node the first time it runs
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < n; i++)
+            threads.emplace_back([&, i] { run_once(client(i), params); });
+        for(auto&& thread : threads)
+            thread.join();
+    }
+    timer t{};
+    std::vector<std::thread> threads;
+    // A thread stays bound to its numa node, so the calling thread is not
+    // used as a client in numa mode
+    for(std::size_t i = options.numa ? 0 : 1; i < n; i++)
+        threads.emplace_back([&, i] { run_client(client(i), samples[i]); });
+    if(not options.numa)
+        run_client(p, samples[0]);
+    for(auto&& thread : threads)
+        thread.join();
+    double wall = t.record<seconds>();
+    if(options.numa)
+        set_numa_node(p, -1);
+
+    // Timings that trend over the run usually mean frequency scaling or
+    // thermal throttling
+    const auto& first = samples.front();
+    if(first.size() >= 20)
+    {
+        auto mid     = first.begin() + first.size() / 2;
+        double early = median({first.begin(), mid});
+        double late  = median({mid, first.end()});
+        double drift = std::abs(late - early) / early;
+        if(drift > 0.05)
+            warnings.push_back("Latency drifted by " + std::to_string(int(drift * 100)) +
+                               "% during the run at concurrency " + std::to_string(n));
+    }
+
+    std::vector<double> all;
+    for(auto&& s : samples)
+        all.insert(all.end(), s.begin(), s.end());
+    benchmark_run result;
+    result.concurrency = n;
+    result.latency     = compute_latency_stats(all);
+    result.throughput  = all.size() * options.batch / wall;
+    if(result.latency.mean > 0 and result.latency.stddev / result.latency.mean > 0.1)
+        warnings.push_back("High variance at concurrency " + std::to_string(n) + ": stddev is " +
+                           std::to_string(int(100 * result.latency.stddev / result.latency.mean)) +
+                           "% of the mean");
+    return result;
+}
+
+benchmark_result
+run_benchmark(const program& p, const parameter_map& params, const benchmark_options& options)
+{
+    benchmark_result result;
+    result.batch = options.batch;
+
+    auto governor = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    if(not governor.empty() and governor != "performance")
+        result.warnings.push_back("CPU frequency governor is " + governor +
+                                  " instead of performance");
+    double start_freq = cpu_frequency();
+
+    for(std::size_t i = 0; i < options.warmup; i++)
+        run_once(p, params);
+
+    std::size_t iterations = options.iterations;
+    if(options.duration > 0)
+    {
+        double estimate = std::max(run_once(p, params), 1e-3);
+        iterations =
+            std::max(iterations, static_cast<std::size_t>(options.duration * 1000.0 / estimate));
+    }
+
+    for(auto n : options.concurrency)
+        result.runs.push_back(run_concurrent(p, params, n, iterations, options, result.warnings));
+
+    double end_freq = cpu_frequency();
+    if(start_freq > 0 and end_freq > 0 and std::abs(end_freq - start_freq) / start_freq > 0.05)
+        result.warnings.push_back("CPU frequency changed from " +
+                                  std::to_string(int(start_freq / 1000)) + "MHz to " +
+                                  std::to_string(int(end_freq / 1000)) + "MHz");
+    return result;
+}
+
+void print_benchmark(std::ostream& os, const benchmark_result& result)
+{
+    for(auto&& run : result.runs)
+    {
+        const auto& l = run.latency;
+        os << "Concurrency: " << run.concurrency << std::endl;
+        os << "    Iterations: " << l.count << std::endl;
+        os << "    Throughput: " << run.throughput << "/sec" << std::endl;
+        os << "    Latency: " << l.mean << "ms +/- " << l.ci95 << "ms (95% CI), stddev "
+           << l.stddev << "ms" << std::endl;
+        os << "    Min: " << l.min << "ms, p50: " << l.p50 << "ms, p90: " << l.p90
+           << "ms, p99: " << l.p99 << "ms, max: " << l.max << "ms" << std::endl;
+    }
+    for(auto&& w : result.warnings)
+        os << "Warning: " << w << std::endl;
+}
+
+void save_benchmark(const std::string& filename, const benchmark_result& result)
+{
+    auto s = to_pretty_json_string(to_value(result));
+    write_buffer(filename, s.data(), s.size());
+}
+
+benchmark_result load_benchmark(const std::string& filename)
+{
+    return from_value<benchmark_result>(from_json_string(read_string(filename)));
+}
+
+static double percent_change(double baseline, double current)
+{
+    if(baseline == 0)
+        return 0;
+    return 100.0 * (current - baseline) / baseline;
+}
+
+bool compare_benchmarks(std::ostream& os,
+                        const benchmark_result& baseline,
+                        const benchmark_result& current,
+                        double threshold)
+{
+    bool passed = true;
+    os << std::fixed << std::setprecision(2);
+    for(auto&& run : current.runs)
+    {
+        auto it = std::find_if(baseline.runs.begin(), baseline.runs.end(), [&](auto&& b) {
+            return b.concurrency == run.concurrency;
+        });
+        if(it == baseline.runs.end())
+        {
+            os << "Concurrency " << run.concurrency << ": missing from baseline" << std::endl;
+            continue;
+        }
+        const auto& bl = it->latency;
+        const auto& cl = run.latency;
+        // Only report latency changes that are outside of the confidence intervals
+        bool significant = std::abs(cl.mean - bl.mean) > bl.ci95 + cl.ci95;
+        os << "Concurrency " << run.concurrency << ":" << std::endl;
+        auto report = [&](const std::string& name, double b, double c, bool lower_is_better) {
+            double change = percent_change(b, c);
+            bool regressed =
+                (lower_is_better ? change > threshold : change < -threshold) and significant;
+            os << "    " << name << ": " << b << " -> " << c << " (" << std::showpos << change
+               << std::noshowpos << "%)";
+            if(regressed)
+                os << " REGRESSION";
+            os << std::endl;
+            passed &= not regressed;
+        };
+        report("mean", bl.mean, cl.mean, true);
+        report("p50", bl.p50, cl.p50, true);
+        report("p90", bl.p90, cl.p90, true);
+        report("p99", bl.p99, cl.p99, true);
+        report("throughput", it->throughput, run.throughput, false);
+    }
+    return passed;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,109 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_BENCHMARK_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_BENCHMARK_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/reflect.hpp>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct benchmark_options
+{
+    // Minimum number of timed iterations per concurrency level
+    std::size_t iterations = 100;
+    // Untimed iterations run before measuring
+    std::size_t warmup = 10;
+    // When non-zero, the iteration count is scaled so each level runs for
+    // about this many seconds
+    double duration = 0;
+    std::vector<std::size_t> concurrency = {1};
+    std::size_t batch                    = 1;
+    // Pin each concurrent client to a numa node in turn, when the target
+    // supports it
+    bool numa = false;
+};
+
+struct latency_stats
+{
+    std::size_t count = 0;
+    double mean       = 0;
+    double stddev     = 0;
+    // Half-width of the 95% confidence interval of the mean
+    double ci95 = 0;
+    double min  = 0;
+    double max  = 0;
+    double p50  = 0;
+    double p90  = 0;
+    double p99  = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.count, "count"),
+                    f(self.mean, "mean"),
+                    f(self.stddev, "stddev"),
+                    f(self.ci95, "ci95"),
+                    f(self.min, "min"),
+                    f(self.max, "max"),
+                    f(self.p50, "p50"),
+                    f(self.p90, "p90"),
+                    f(self.p99, "p99"));
+    }
+};
+
+latency_stats compute_latency_stats(std::vector<double> samples);
+
+struct benchmark_run
+{
+    std::size_t concurrency = 1;
+    // Latency of each eval in milliseconds
+    latency_stats latency;
+    // Inferences (evals times batch) per second
+    double throughput = 0;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.concurrency, "concurrency"),
+                    f(self.latency, "latency"),
+                    f(self.throughput, "throughput"));
+    }
+};
+
+struct benchmark_result
+{
+    std::size_t batch = 1;
+    std::vector<benchmark_run> runs;
+    std::vector<std::string> warnings;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.batch, "batch"), f(self.runs, "runs"), f(self.warnings, "warnings"));
+    }
+};
+
+benchmark_result
+run_benchmark(const program& p, const parameter_map& params, const benchmark_options& options);
+
+void print_benchmark(std::ostream& os, const benchmark_result& result);
+
+void save_benchmark(const std::string& filename, const benchmark_result& result);
+benchmark_result load_benchmark(const std::string& filename);
+
+/// Prints the change of every metric between two results and returns false
+/// if the latency or throughput regressed by more than threshold percent
+bool compare_benchmarks(std::ostream& os,
+                        const benchmark_result& baseline,
+                        const benchmark_result& current,
+                        double threshold = 5);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,51 @@
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include "models.hpp"
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Post processing of a detection network: nonmaxsuppression and topk over
+// 5000 boxes in 80 classes, and roialign of 1000 rois per image
+migraphx::program detection(unsigned batch)
+{
+    const std::size_t boxes   = 5000;
+    const std::size_t classes = 80;
+    const std::size_t rois    = 1000;
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto b   = mm->add_parameter("boxes", {migraphx::shape::float_type, {batch, boxes, 4}});
+    auto s =
+        mm->add_parameter("scores", {migraphx::shape::float_type, {batch, classes, boxes}});
+    auto x = mm->add_parameter("x", {migraphx::shape::float_type, {batch, 256, 64, 64}});
+    auto r = mm->add_parameter("rois", {migraphx::shape::float_type, {batch * rois, 4}});
+    std::vector<int64_t> indices(batch * rois);
+    for(std::size_t i = 0; i < indices.size(); i++)
+        indices[i] = i / rois;
+    auto ind = mm->add_literal(
+        migraphx::literal{migraphx::shape{migraphx::shape::int64_type, {batch * rois}}, indices});
+    auto nms = mm->add_instruction(migraphx::make_op("nonmaxsuppression"),
+                                   b,
+                                   s,
+                                   mm->add_literal(int64_t{100}),
+                                   mm->add_literal(0.5f),
+                                   mm->add_literal(0.05f));
+    auto topk = mm->add_instruction(
+        migraphx::make_op("topk", {{"k", 300}, {"axis", 2}, {"largest", true}}), s);
+    auto values = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), topk);
+    auto align  = mm->add_instruction(migraphx::make_op("roialign",
+                                                       {{"output_height", 7},
+                                                        {"output_width", 7},
+                                                        {"sampling_ratio", 2},
+                                                        {"spatial_scale", 0.25}}),
+                                     x,
+                                     r,
+                                     ind);
+    mm->add_return({nms, values, align});
+    return p;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,69 @@
+#include "extent.hpp"
+#include "benchmark.hpp"
+#include "perf.hpp"
+
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static program mask_program(const extent_options& options)
+{
+    program p;
+    auto* mm   = p.get_main_module();
+    auto l     = options.length;
+    auto h     = options.hidden;
+    auto mask  = mm->add_parameter("mask", shape{shape::float_type, {l}});
+    std::vector<float> rows;
+    generate_literal(shape{shape::float_type, {l, h}}, 1).visit([&](auto v) {
+        rows.assign(v.begin(), v.end());
+    });
+    // The padding of the indices gathers the first row, which is zero so the
+    // gathered rows stay padding
+    std::fill(rows.begin(), rows.begin() + h, 0);
+    auto table = mm->add_literal(literal{shape{shape::float_type, {l, h}}, rows});
+    auto w     = mm->add_literal(generate_literal(shape{shape::float_type, {h, h}}, 2));
+    // The indices are padded to the length of the mask
+    auto nz  = mm->add_instruction(make_op("nonzero"), mask);
+    auto idx = mm->add_instruction(make_op("reshape", {{"dims", {l}}}), nz);
+    auto x   = mm->add_instruction(make_op("gather", {{"axis", 0}}), table, idx);
+    auto y   = mm->add_instruction(make_op("dot"), x, w);
+    auto r   = mm->add_instruction(make_op("relu"), y);
+    mm->add_instruction(make_op("reduce_sum", {{"axes", {1}}}), r);
+    return p;
+}
+
+void run_extent_sweep(std::ostream& os, const target& t, const extent_options& options)
+{
+    auto p = mask_program(options);
+    p.compile(t);
+    benchmark_options bo;
+    bo.iterations = options.iterations;
+    os << std::setw(10) << "ratio" << std::setw(12) << "time(ms)" << std::setw(10) << "speedup"
+       << std::endl;
+    double full_time = 0;
+    for(auto ratio : options.ratios)
+    {
+        std::vector<float> mask(options.length, 0);
+        std::fill(mask.begin(), mask.begin() + std::size_t(ratio * options.length), 1);
+        parameter_map m;
+        m["mask"] = argument{shape{shape::float_type, {options.length}}, mask.data()};
+        fill_param_map(m, p, t);
+        auto time = run_benchmark(p, m, bo).runs.front().latency.mean;
+        // The speedup is against the first ratio
+        if(full_time == 0)
+            full_time = time;
+        os << std::fixed << std::setprecision(3) << std::setw(10) << ratio << std::setw(12)
+           << time << std::setw(10) << full_time / time << std::endl;
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
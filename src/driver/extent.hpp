@@ -0,0 +1,33 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_EXTENT_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_EXTENT_HPP
+
+#include <migraphx/target.hpp>
+#include <iosfwd>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct extent_options
+{
+    // Fractions of the mask that are set, which is how much of the output of
+    // nonzero holds indices
+    std::vector<double> ratios = {1, 0.75, 0.5, 0.25, 0.1, 0.01};
+    // Length of the mask
+    std::size_t length = 4096;
+    // Width of the rows that are gathered for each index
+    std::size_t hidden     = 256;
+    std::size_t iterations = 100;
+};
+
+/// Times a program that gathers the rows selected by a mask with nonzero,
+/// and runs them through a dot, a relu and a reduction, for each fraction of
+/// the mask that is set
+void run_extent_sweep(std::ostream& os, const target& t, const extent_options& options);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
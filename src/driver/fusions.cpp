@@ -0,0 +1,51 @@
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include "models.hpp"
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Chains of pointwise ops, and reductions of them, like the ones between the
+// convolutions and gemms of a model. The cpu runs each op of a chain on its
+// own, or fuses the chain into one generated kernel when
+// MIGRAPHX_ENABLE_CPU_JIT is set, so the two can be compared.
+migraphx::program fusions(unsigned batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {batch, 64, 56, 56}};
+    auto x    = mm->add_parameter("x", s);
+    auto y    = mm->add_parameter("y", s);
+    auto bias = mm->add_instruction(
+        migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", s.lens()}}),
+        mm->add_parameter("bias", migraphx::shape{migraphx::shape::float_type, {64}}));
+    auto scalar = [&](float v) {
+        return mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}),
+                                   mm->add_literal(v));
+    };
+    auto op = [&](const std::string& name, auto... xs) {
+        return mm->add_instruction(migraphx::make_op(name), xs...);
+    };
+    auto reduce = [&](const std::string& name, std::vector<std::int64_t> axes, auto input) {
+        return mm->add_instruction(migraphx::make_op(name, {{"axes", axes}}), input);
+    };
+    // x * sigmoid(x) + bias
+    auto swish = op("add", op("mul", x, op("sigmoid", x)), bias);
+    // min(max(x * y + bias, 0), 6)
+    auto relu6 = op("min", op("relu", op("add", op("mul", x, y), bias)), scalar(6.0f));
+    // Residual add of a scaled input
+    auto residual = op("add", op("mul", x, scalar(0.5f)), op("tanh", y));
+    mm->add_return({swish,
+                    relu6,
+                    residual,
+                    reduce("reduce_sum", {2, 3}, op("exp", op("sub", x, y))),
+                    reduce("reduce_mean", {3}, op("sqdiff", x, y)),
+                    reduce("reduce_max", {1}, op("abs", op("add", x, bias)))});
+    return p;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
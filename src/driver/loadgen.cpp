@@ -0,0 +1,220 @@
+#include "loadgen.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+using clock_type   = std::chrono::steady_clock;
+using milliseconds = std::chrono::duration<double, std::milli>;
+using seconds      = std::chrono::duration<double>;
+
+struct request
+{
+    std::size_t id = 0;
+    clock_type::time_point arrival;
+};
+
+struct request_queue
+{
+    void push(const request& r)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            requests.push_back(r);
+        }
+        // Wake every worker, since one may be waiting for its batch to fill up
+        cv.notify_all();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            closed = true;
+        }
+        cv.notify_all();
+    }
+
+    // Waits for a request, and then for up to max_batch requests until the
+    // timeout after the first one arrived. Returns false once the queue is
+    // closed and empty.
+    bool pop(std::vector<request>& batch, std::size_t max_batch, clock_type::duration timeout)
+    {
+        batch.clear();
+        std::unique_lock<std::mutex> lock(m);
+        while(batch.empty())
+        {
+            cv.wait(lock, [&] { return closed or not requests.empty(); });
+            if(requests.empty())
+                return false;
+            if(max_batch > 1)
+            {
+                auto deadline = requests.front().arrival + timeout;
+                cv.wait_until(
+                    lock, deadline, [&] { return closed or requests.size() >= max_batch; });
+            }
+            // Another worker may have taken the requests while this one waited
+            auto n = std::min(max_batch, requests.size());
+            batch.assign(requests.begin(), requests.begin() + n);
+            requests.erase(requests.begin(), requests.begin() + n);
+        }
+        return true;
+    }
+
+    private:
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<request> requests;
+    bool closed = false;
+};
+
+static void run_eval(const program& p, const parameter_map& params)
+{
+    p.eval(params);
+    p.get_context().finish();
+}
+
+loadgen_result
+run_loadgen(const program& p, const parameter_map& params, const loadgen_options& options)
+{
+    if(options.arrival != "closed" and options.arrival != "open")
+        throw std::runtime_error("Unknown arrival model: " + options.arrival);
+    if(options.arrival == "open" and options.rate <= 0)
+        throw std::runtime_error("The open loop needs a positive rate");
+    bool closed_loop  = options.arrival == "closed";
+    auto clients      = std::max<std::size_t>(options.clients, 1);
+    auto workers      = options.workers == 0 ? clients : options.workers;
+    auto max_batch    = std::max<std::size_t>(options.max_batch, 1);
+    std::size_t total = options.requests;
+    auto timeout =
+        std::chrono::duration_cast<clock_type::duration>(milliseconds{options.batch_timeout});
+
+    // Each worker gets its own copy of the program so the evals do not share
+    // any execution state
+    std::vector<program> programs(workers - 1, p);
+    auto worker_program = [&](std::size_t i) -> const program& {
+        return i == 0 ? p : programs[i - 1];
+    };
+    for(std::size_t i = 0; i < workers; i++)
+    {
+        for(std::size_t j = 0; j < options.warmup; j++)
+            run_eval(worker_program(i), params);
+    }
+
+    request_queue queue;
+    std::vector<std::promise<void>> responses(total);
+    std::vector<double> latency(total);
+    std::vector<double> queue_delay(total);
+    std::vector<std::vector<std::size_t>> batch_sizes(workers);
+    std::vector<std::thread> worker_threads;
+    for(std::size_t i = 0; i < workers; i++)
+    {
+        worker_threads.emplace_back([&, i] {
+            std::vector<request> batch;
+            while(queue.pop(batch, max_batch, timeout))
+            {
+                auto start = clock_type::now();
+                run_eval(worker_program(i), params);
+                auto end = clock_type::now();
+                for(auto&& r : batch)
+                {
+                    queue_delay[r.id] = milliseconds{start - r.arrival}.count();
+                    latency[r.id]     = milliseconds{end - r.arrival}.count();
+                    responses[r.id].set_value();
+                }
+                batch_sizes[i].push_back(batch.size());
+            }
+        });
+    }
+
+    auto start   = clock_type::now();
+    auto expired = [&](clock_type::time_point t) {
+        return options.duration > 0 and seconds{t - start}.count() > options.duration;
+    };
+    std::atomic<std::size_t> sent{0};
+    if(closed_loop)
+    {
+        std::vector<std::thread> client_threads;
+        for(std::size_t i = 0; i < clients; i++)
+        {
+            client_threads.emplace_back([&] {
+                for(;;)
+                {
+                    auto now = clock_type::now();
+                    if(expired(now))
+                        break;
+                    auto id = sent++;
+                    if(id >= total)
+                        break;
+                    auto response = responses[id].get_future();
+                    queue.push({id, now});
+                    response.wait();
+                }
+            });
+        }
+        for(auto&& thread : client_threads)
+            thread.join();
+        sent = std::min<std::size_t>(sent.load(), total);
+    }
+    else
+    {
+        // The arrival is the scheduled time, so a request that could not be
+        // sent on time still counts its delay instead of hiding it
+        std::mt19937 gen(options.seed);
+        std::exponential_distribution<double> interval(options.rate);
+        auto arrival = start;
+        for(std::size_t id = 0; id < total; id++)
+        {
+            arrival += std::chrono::duration_cast<clock_type::duration>(seconds{interval(gen)});
+            if(expired(arrival))
+                break;
+            std::this_thread::sleep_until(arrival);
+            queue.push({id, arrival});
+            sent++;
+        }
+    }
+    queue.close();
+    for(auto&& thread : worker_threads)
+        thread.join();
+    double wall = seconds{clock_type::now() - start}.count();
+
+    std::size_t n = sent;
+    latency.resize(n);
+    queue_delay.resize(n);
+    std::vector<std::size_t> all_batches;
+    for(auto&& b : batch_sizes)
+        all_batches.insert(all_batches.end(), b.begin(), b.end());
+
+    loadgen_result result;
+    result.arrival       = options.arrival;
+    result.clients       = closed_loop ? clients : 0;
+    result.rate          = closed_loop ? 0 : options.rate;
+    result.workers       = workers;
+    result.max_batch     = max_batch;
+    result.batch_timeout = options.batch_timeout;
+    result.duration      = wall;
+    result.evals         = all_batches.size();
+    result.throughput    = wall > 0 ? n / wall : 0;
+    if(not all_batches.empty())
+        result.mean_batch = std::accumulate(all_batches.begin(), all_batches.end(), 0.0) /
+                            all_batches.size();
+    result.latency     = compute_latency_stats(latency);
+    result.queue_delay = compute_latency_stats(queue_delay);
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
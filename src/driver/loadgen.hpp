@@ -0,0 +1,87 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_LOADGEN_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_LOADGEN_HPP
+
+#include "benchmark.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/reflect.hpp>
+#include <string>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct loadgen_options
+{
+    // "closed": each client sends a request and waits for its response
+    // before sending the next one
+    // "open": requests arrive at random times at an average rate, whether
+    // or not earlier requests have finished
+    std::string arrival = "closed";
+    // Number of clients for the closed loop
+    std::size_t clients = 1;
+    // Average requests per second for the open loop
+    double rate = 100;
+    // Number of evals that run at the same time, each on its own copy of
+    // the program. Defaults to the number of clients.
+    std::size_t workers = 0;
+    // Number of requests to send after the warmup
+    std::size_t requests = 1000;
+    // Stop sending requests after this many seconds, when non-zero
+    double duration = 0;
+    // Group up to this many queued requests into one eval
+    std::size_t max_batch = 1;
+    // How long to wait for a batch to fill up, in milliseconds
+    double batch_timeout = 1;
+    std::size_t warmup   = 10;
+    std::size_t seed     = 0;
+};
+
+struct loadgen_result
+{
+    std::string arrival;
+    std::size_t clients   = 0;
+    double rate           = 0;
+    std::size_t workers   = 0;
+    std::size_t max_batch = 0;
+    double batch_timeout  = 0;
+    // Seconds from the first request until the last response
+    double duration   = 0;
+    std::size_t evals = 0;
+    // Responses per second
+    double throughput = 0;
+    double mean_batch = 0;
+    // Time from the arrival of a request until its response, in milliseconds
+    latency_stats latency;
+    // Time from the arrival of a request until its eval started
+    latency_stats queue_delay;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.arrival, "arrival"),
+                    f(self.clients, "clients"),
+                    f(self.rate, "rate"),
+                    f(self.workers, "workers"),
+                    f(self.max_batch, "max_batch"),
+                    f(self.batch_timeout, "batch_timeout"),
+                    f(self.duration, "duration"),
+                    f(self.evals, "evals"),
+                    f(self.throughput, "throughput"),
+                    f(self.mean_batch, "mean_batch"),
+                    f(self.latency, "latency"),
+                    f(self.queue_delay, "queue_delay"));
+    }
+};
+
+/// Sends requests to a compiled program from several threads and measures
+/// the latency of each request. A batched eval runs the program once for up
+/// to max_batch requests, so the program should be compiled with a batch
+/// size of max_batch.
+loadgen_result
+run_loadgen(const program& p, const parameter_map& params, const loadgen_options& options);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
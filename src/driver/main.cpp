@@ -3,6 +3,11 @@
 #include "command.hpp"
 #include "precision.hpp"
 #include "perf.hpp"
+#include "benchmark.hpp"
+#include "loadgen.hpp"
+#include "sparsity.hpp"
+#include "extent.hpp"
+#include "split.hpp"
 #include "models.hpp"
 #include "marker_roctx.hpp"
 
@@ -11,6 +16,13 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/load_save.hpp>
 #include <migraphx/json.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/marker.hpp>
+#include <migraphx/timeline.hpp>
+#include <migraphx/time.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/instruction.hpp>
 #include <migraphx/version.h>
 
 #include <migraphx/dead_code_elimination.hpp>
@@ -26,6 +38,7 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/register_target.hpp>
 
+#include <cstdlib>
 #include <fstream>
 
 namespace migraphx {
@@ -38,6 +51,7 @@ struct loader
     std::string file;
     std::string file_type;
     unsigned batch              = 1;
+    unsigned seq_len            = 128;
     bool is_nhwc                = true;
     unsigned trim               = 0;
     bool optimize               = false;
@@ -48,15 +62,30 @@ struct loader
     std::vector<std::string> param_dims;
     std::vector<std::string> output_names;
 
+    static std::vector<std::string> model_names()
+    {
+        return {"resnet50",
+                "inceptionv3",
+                "alexnet",
+                "attention",
+                "detection",
+                "reductions",
+                "fusions"};
+    }
+
     void parse(argument_parser& ap)
     {
         ap(file, {}, ap.metavar("<input file>"));
-        ap(model, {"--model"}, ap.help("Load model"), ap.type("resnet50|inceptionv3|alexnet"));
+        ap(model,
+           {"--model"},
+           ap.help("Load model"),
+           ap.type(join_strings(model_names(), "|")));
         ap(file_type, {"--onnx"}, ap.help("Load as onnx"), ap.set_value("onnx"));
         ap(file_type, {"--tf"}, ap.help("Load as tensorflow"), ap.set_value("tf"));
         ap(file_type, {"--migraphx"}, ap.help("Load as MIGraphX"), ap.set_value("migraphx"));
         ap(file_type, {"--migraphx-json"}, ap.help("Load as MIGraphX JSON"), ap.set_value("json"));
         ap(batch, {"--batch"}, ap.help("Set batch size for model"));
+        ap(seq_len, {"--seq-len"}, ap.help("Set sequence length for the attention model"));
         ap(is_nhwc, {"--nhwc"}, ap.help("Treat tensorflow format as nhwc"), ap.set_value(true));
         ap(skip_unknown_operators,
            {"--skip-unknown-operators"},
@@ -178,6 +207,14 @@ struct loader
                 p = inceptionv3(batch);
             else if(model == "alexnet")
                 p = alexnet(batch);
+            else if(model == "attention")
+                p = attention(batch, seq_len);
+            else if(model == "detection")
+                p = detection(batch);
+            else if(model == "reductions")
+                p = reductions(batch);
+            else if(model == "fusions")
+                p = fusions(batch);
             else
                 MIGRAPHX_THROW("Unknown model: " + model);
         }
@@ -292,9 +329,12 @@ struct compiler
     loader l;
     program_params parameters;
     compiler_target ct;
-    bool offload_copy  = false;
-    bool fast_math     = true;
-    precision quantize = precision::fp32;
+    bool offload_copy       = false;
+    bool fast_math          = true;
+    precision quantize      = precision::fp32;
+    std::size_t weight_bits = 0;
+    std::size_t group_size  = 0;
+    std::size_t split_batch = 1;
 
     std::vector<std::string> fill0;
     std::vector<std::string> fill1;
@@ -313,6 +353,20 @@ struct compiler
            ap.set_value(false));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
         ap(quantize, {"--int8"}, ap.help("Quantize for int8"), ap.set_value(precision::int8));
+        ap(weight_bits,
+           {"--weight-int8"},
+           ap.help("Store the weights of dot as int8, without calibration"),
+           ap.set_value(8));
+        ap(weight_bits,
+           {"--weight-int4"},
+           ap.help("Store the weights of dot as int4, without calibration"),
+           ap.set_value(4));
+        ap(group_size,
+           {"--group-size"},
+           ap.help("Number of weights that share a scale, or 0 for one per output channel"));
+        ap(split_batch,
+           {"--split-batch"},
+           ap.help("Split the batch into this many sub-batches that run at the same time"));
     }
 
     auto params(const program& p) { return parameters.generate(p, ct.get_target(), offload_copy); }
@@ -332,9 +386,17 @@ struct compiler
         {
             quantize_int8(p, t, {params(p)});
         }
+        if(weight_bits > 0)
+        {
+            auto bytes = literal_bytes(p);
+            quantize_weights(p, weight_bits, group_size);
+            std::cout << "Weights: " << bytes / (1024.0 * 1024.0) << "MiB -> "
+                      << literal_bytes(p) / (1024.0 * 1024.0) << "MiB" << std::endl;
+        }
         compile_options options;
         options.offload_copy = offload_copy;
         options.fast_math    = fast_math;
+        options.split_batch  = split_batch;
         p.compile(t, options);
         l.save(p);
         return p;
@@ -344,11 +406,36 @@ struct compiler
 struct read : command<read>
 {
     loader l;
-    void parse(argument_parser& ap) { l.parse(ap); }
+    bool print_time = false;
+    void parse(argument_parser& ap)
+    {
+        l.parse(ap);
+        ap(print_time,
+           {"--time"},
+           ap.help("Print how long it takes to read the model instead of the program"),
+           ap.set_value(true));
+    }
 
     void run()
     {
-        auto p = l.load();
+        program p;
+        auto ms = time<std::chrono::duration<double, std::milli>>([&] { p = l.load(); });
+        if(print_time)
+        {
+            std::size_t literals = 0;
+            std::size_t bytes    = 0;
+            for(auto ins : iterator_for(*p.get_main_module()))
+            {
+                if(ins->name() != "@literal")
+                    continue;
+                literals++;
+                bytes += ins->get_shape().bytes();
+            }
+            std::cout << "Read time: " << ms << "ms" << std::endl;
+            std::cout << "Literals: " << literals << " (" << bytes / (1024 * 1024) << "MiB)"
+                      << std::endl;
+            return;
+        }
         l.save(p);
     }
 };
@@ -371,12 +458,16 @@ struct verify : command<verify>
     loader l;
     program_params parameters;
     compiler_target ct;
-    double tolerance     = 80;
-    bool per_instruction = false;
-    bool reduce          = false;
-    bool offload_copy    = false;
-    bool fast_math       = true;
-    precision quantize   = precision::fp32;
+    double tolerance        = 80;
+    bool per_instruction    = false;
+    bool reduce             = false;
+    bool lockstep           = false;
+    bool bisect             = false;
+    bool offload_copy       = false;
+    bool fast_math          = true;
+    precision quantize      = precision::fp32;
+    std::size_t weight_bits = 0;
+    std::size_t group_size  = 0;
     void parse(argument_parser& ap)
     {
         l.parse(ap);
@@ -396,7 +487,26 @@ struct verify : command<verify>
            ap.help("Verify each instruction"),
            ap.set_value(true));
         ap(reduce, {"-r", "--reduce"}, ap.help("Reduce program and verify"), ap.set_value(true));
+        ap(lockstep,
+           {"-l", "--lockstep"},
+           ap.help("Verify each instruction in order to find the first divergent one"),
+           ap.set_value(true));
+        ap(bisect,
+           {"-b", "--bisect"},
+           ap.help("Bisect the program to find the first divergent instruction"),
+           ap.set_value(true));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
+        ap(weight_bits,
+           {"--weight-int8"},
+           ap.help("Store the weights of dot as int8, without calibration"),
+           ap.set_value(8));
+        ap(weight_bits,
+           {"--weight-int4"},
+           ap.help("Store the weights of dot as int4, without calibration"),
+           ap.set_value(4));
+        ap(group_size,
+           {"--group-size"},
+           ap.help("Number of weights that share a scale, or 0 for one per output channel"));
     }
 
     void run()
@@ -411,7 +521,11 @@ struct verify : command<verify>
         auto t               = ct.get_target();
         auto m               = parameters.generate(p, t, true);
 
-        if(per_instruction)
+        if(weight_bits > 0)
+        {
+            verify_quantized_weights(p, t, options, m, weight_bits, group_size);
+        }
+        else if(per_instruction)
         {
             verify_instructions(p, t, options, quantize, tolerance);
         }
@@ -419,6 +533,14 @@ struct verify : command<verify>
         {
             verify_reduced_program(p, t, options, quantize, m, tolerance);
         }
+        else if(lockstep)
+        {
+            verify_lockstep_program(p, t, options, quantize, m, tolerance);
+        }
+        else if(bisect)
+        {
+            verify_bisected_program(p, t, options, quantize, m, tolerance);
+        }
         else
         {
             verify_program(l.file, p, t, options, quantize, m, tolerance);
@@ -439,12 +561,22 @@ struct version : command<version>
 struct compile : command<compile>
 {
     compiler c;
-    void parse(argument_parser& ap) { c.parse(ap); }
+    bool print_time = false;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(print_time,
+           {"--time"},
+           ap.help("Print how long it takes to compile"),
+           ap.set_value(true));
+    }
 
     void run()
     {
         std::cout << "Compiling ... " << std::endl;
-        c.compile();
+        auto ms = time<std::chrono::duration<double, std::milli>>([&] { c.compile(); });
+        if(print_time)
+            std::cout << "Compile time: " << ms << "ms" << std::endl;
     }
 };
 
@@ -468,10 +600,46 @@ struct perf : command<perf>
 {
     compiler c;
     unsigned n = 100;
+    benchmark_options options;
+    std::vector<std::size_t> concurrency;
+    std::string report;
+    std::string trace;
+    bool latency      = false;
+    bool latency_only = false;
     void parse(argument_parser& ap)
     {
         c.parse(ap);
         ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to run for perf report"));
+        ap(options.warmup, {"--warmup"}, ap.help("Number of untimed iterations to run first"));
+        ap(options.duration,
+           {"--duration"},
+           ap.help("Scale the iterations to run for this many seconds per concurrency level"));
+        ap(concurrency,
+           {"--concurrency"},
+           ap.help("Number of concurrent evals to measure throughput with (format: \"1 2 4\")"),
+           ap.append(),
+           ap.nargs(2));
+        ap(options.numa,
+           {"--numa"},
+           ap.help("Pin each concurrent eval to a numa node in turn on the cpu target"),
+           ap.set_value(true));
+        ap(report, {"--report"}, ap.help("Write the latency statistics to a json file"));
+        ap(trace,
+           {"--trace"},
+           ap.help("Write a timeline of one run to a Chrome trace json file"));
+        ap(latency,
+           {"--latency"},
+           ap.help("Measure the latency statistics after the perf report"),
+           ap.set_value(true));
+        ap(latency_only,
+           {"--latency-only"},
+           ap.help("Measure the latency statistics and skip the per instruction report"),
+           ap.set_value(true));
+    }
+
+    bool measure_latency() const
+    {
+        return latency or latency_only or not concurrency.empty() or not report.empty();
     }
 
     void run()
@@ -480,8 +648,192 @@ struct perf : command<perf>
         auto p = c.compile();
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
-        std::cout << "Running performance report ... " << std::endl;
-        p.perf_report(std::cout, n, m, c.l.batch);
+        if(not latency_only)
+        {
+            std::cout << "Running performance report ... " << std::endl;
+            p.perf_report(std::cout, n, m, c.l.batch);
+        }
+        if(measure_latency())
+        {
+            std::cout << "Measuring latency ... " << std::endl;
+            options.iterations = n;
+            options.batch      = c.l.batch;
+            if(not concurrency.empty())
+                options.concurrency = concurrency;
+            auto result = run_benchmark(p, m, options);
+            print_benchmark(std::cout, result);
+            if(not report.empty())
+                save_benchmark(report, result);
+        }
+        if(not trace.empty())
+        {
+            std::cout << "Recording timeline ... " << std::endl;
+            timeline t;
+            p.mark(m, make_timeline_marker(t));
+            t.write_chrome_trace(trace);
+        }
+    }
+};
+
+struct perf_compare : command<perf_compare>
+{
+    std::vector<std::string> files;
+    double threshold = 5;
+    void parse(argument_parser& ap)
+    {
+        ap(files, {}, ap.metavar("<baseline json> <current json>"), ap.append());
+        ap(threshold,
+           {"--threshold"},
+           ap.help("Percent change that is reported as a regression"));
+    }
+
+    void run()
+    {
+        if(files.size() != 2)
+            throw std::runtime_error("perf_compare needs a baseline and a current report");
+        auto baseline = load_benchmark(files[0]);
+        auto current  = load_benchmark(files[1]);
+        if(compare_benchmarks(std::cout, baseline, current, threshold))
+        {
+            std::cout << "No regressions" << std::endl;
+            return;
+        }
+        std::cout << "FAILED: Performance regressed" << std::endl;
+        // Exit with an error so scripts can gate on the comparison
+        std::exit(EXIT_FAILURE);
+    }
+};
+
+struct loadgen : command<loadgen>
+{
+    compiler c;
+    loadgen_options options;
+    std::string report;
+    void parse(argument_parser& ap)
+    {
+        c.parse(ap);
+        ap(options.arrival,
+           {"--arrival"},
+           ap.help("Arrival model of the requests: closed or open (Default: closed)"));
+        ap(options.clients,
+           {"--clients"},
+           ap.help("Number of clients that each wait for a response before sending the next "
+                   "request with the closed arrival model"));
+        ap(options.rate,
+           {"--rate"},
+           ap.help("Average requests per second of the open arrival model, which arrive at "
+                   "exponentially distributed intervals"));
+        ap(options.workers,
+           {"--workers"},
+           ap.help("Number of evals that run at the same time (Default: the number of clients)"));
+        ap(options.requests, {"--requests"}, ap.help("Number of requests to send"));
+        ap(options.duration,
+           {"--duration"},
+           ap.help("Stop sending requests after this many seconds"));
+        ap(options.max_batch,
+           {"--max-batch"},
+           ap.help("Run up to this many queued requests in one eval, which should be the batch "
+                   "size the program was compiled with"));
+        ap(options.batch_timeout,
+           {"--batch-timeout"},
+           ap.help("Milliseconds to wait for a batch to fill up before running it"));
+        ap(options.warmup, {"--warmup"}, ap.help("Number of untimed evals per worker"));
+        ap(options.seed, {"--seed"}, ap.help("Seed of the open arrival model"));
+        ap(report, {"--report"}, ap.help("Write the results to a json file"));
+    }
+
+    void run()
+    {
+        if(options.max_batch > c.l.batch)
+            throw std::runtime_error("--max-batch is larger than --batch");
+        std::cout << "Compiling ... " << std::endl;
+        auto p = c.compile();
+        std::cout << "Allocating params ... " << std::endl;
+        auto m = c.params(p);
+        std::cout << "Generating load ... " << std::endl;
+        auto result = run_loadgen(p, m, options);
+        auto json   = to_pretty_json_string(to_value(result));
+        std::cout << json << std::endl;
+        if(not report.empty())
+            write_buffer(report, json.data(), json.size());
+    }
+};
+
+struct sparsity : command<sparsity>
+{
+    compiler_target ct;
+    sparsity_options options;
+    void parse(argument_parser& ap)
+    {
+        ct.parse(ap);
+        ap(options.levels,
+           {"--levels"},
+           ap.help("Fractions of the blocks of the weights to set to zero (format: \"0.5 0.9\")"),
+           ap.append(),
+           ap.nargs(2));
+        ap(options.batch, {"--batch"}, ap.help("Batch size of the dot and the convolution"));
+        ap(options.k, {"--k"}, ap.help("Rows of the weights of the dot"));
+        ap(options.n, {"--n"}, ap.help("Columns of the weights of the dot"));
+        ap(options.channels, {"--channels"}, ap.help("Channels of the convolution"));
+        ap(options.block_rows, {"--block-rows"}, ap.help("Output channels in a block"));
+        ap(options.block_cols, {"--block-cols"}, ap.help("Input channels in a block"));
+        ap(options.iterations, {"--iterations"}, ap.help("Number of timed iterations"));
+    }
+
+    void run() const { run_sparsity_sweep(std::cout, ct.get_target(), options); }
+};
+
+struct extent : command<extent>
+{
+    compiler_target ct;
+    extent_options options;
+    void parse(argument_parser& ap)
+    {
+        ct.parse(ap);
+        ap(options.ratios,
+           {"--ratios"},
+           ap.help("Fractions of the mask that are set (format: \"1 0.5\")"),
+           ap.append(),
+           ap.nargs(2));
+        ap(options.length, {"--length"}, ap.help("Length of the mask"));
+        ap(options.hidden, {"--hidden"}, ap.help("Width of the gathered rows"));
+        ap(options.iterations, {"--iterations"}, ap.help("Number of timed iterations"));
+    }
+
+    void run() const { run_extent_sweep(std::cout, ct.get_target(), options); }
+};
+
+struct split : command<split>
+{
+    loader l;
+    compiler_target ct;
+    split_options options;
+    void parse(argument_parser& ap)
+    {
+        l.parse(ap);
+        ct.parse(ap);
+        ap(options.batches,
+           {"--batches"},
+           ap.help("Batch sizes to time (format: \"1 16 64\")"),
+           ap.append(),
+           ap.nargs(2));
+        ap(options.splits, {"--splits"}, ap.help("Number of sub-batches"));
+        ap(options.iterations, {"--iterations"}, ap.help("Number of timed iterations"));
+    }
+
+    void run()
+    {
+        if(l.model.empty() and l.file.empty())
+            l.model = "fusions";
+        run_split_sweep(
+            std::cout,
+            ct.get_target(),
+            [&](std::size_t batch) {
+                auto bl  = l;
+                bl.batch = batch;
+                return bl.load();
+            },
+            options);
     }
 };
 
@@ -8,6 +8,10 @@ inline namespace MIGRAPHX_INLINE_NS {
 migraphx::program resnet50(unsigned batch);
 migraphx::program inceptionv3(unsigned batch);
 migraphx::program alexnet(unsigned batch);
+migraphx::program attention(unsigned batch, unsigned seq_len);
+migraphx::program detection(unsigned batch);
+migraphx::program reductions(unsigned batch);
+migraphx::program fusions(unsigned batch);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
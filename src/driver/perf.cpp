@@ -1,6 +1,8 @@
 #include "perf.hpp"
 
 #include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
 #include <migraphx/register_target.hpp>
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
@@ -87,6 +89,20 @@ target get_target(bool gpu)
 
 void compile_program(program& p, bool gpu) { p.compile(get_target(gpu)); }
 
+std::size_t literal_bytes(const program& p)
+{
+    std::size_t bytes = 0;
+    for(const auto* m : p.get_modules())
+    {
+        for(auto ins : iterator_for(*m))
+        {
+            if(ins->name() == "@literal")
+                bytes += ins->get_shape().bytes();
+        }
+    }
+    return bytes;
+}
+
 } // namespace  MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -15,6 +15,7 @@ parameter_map fill_param_map(parameter_map& m, const program& p, bool gpu);
 parameter_map create_param_map(const program& p, bool gpu = true);
 target get_target(bool gpu);
 void compile_program(program& p, bool gpu = true);
+std::size_t literal_bytes(const program& p);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
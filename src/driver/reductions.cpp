@@ -0,0 +1,68 @@
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include "models.hpp"
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static migraphx::instruction_ref
+add_layernorm(migraphx::module& m, migraphx::instruction_ref x, std::vector<std::int64_t> axes)
+{
+    auto lens = x->get_shape().lens();
+    auto mean = m.add_instruction(migraphx::make_op("reduce_mean", {{"axes", axes}}), x);
+    auto mean_mbcast =
+        m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}), mean);
+    auto sub = m.add_instruction(migraphx::make_op("sub"), x, mean_mbcast);
+    auto exponent =
+        m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}),
+                          m.add_literal(migraphx::literal{migraphx::shape::float_type, {2.0f}}));
+    auto pow      = m.add_instruction(migraphx::make_op("pow"), sub, exponent);
+    auto variance = m.add_instruction(migraphx::make_op("reduce_mean", {{"axes", axes}}), pow);
+    auto epsilon  = m.add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", variance->get_shape().lens()}}),
+        m.add_literal(migraphx::literal{migraphx::shape::float_type, {1e-12f}}));
+    auto add  = m.add_instruction(migraphx::make_op("add"), variance, epsilon);
+    auto sqrt = m.add_instruction(migraphx::make_op("sqrt"), add);
+    auto sqrt_mbcast =
+        m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}), sqrt);
+    return m.add_instruction(migraphx::make_op("div"), sub, sqrt_mbcast);
+}
+
+// Reductions, softmax, layernorm and scans of one NCHW tensor over different
+// axes, so the time of each one can be compared. Reducing the last axis reads
+// contiguous rows, reducing the channels reads columns of the spatial
+// dimensions, and reducing everything but the channels is strided.
+migraphx::program reductions(unsigned batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter(
+        "x", migraphx::shape{migraphx::shape::float_type, {batch, 64, 56, 56}});
+    auto reduce = [&](const std::string& name, std::vector<std::int64_t> axes) {
+        return mm->add_instruction(migraphx::make_op(name, {{"axes", axes}}), x);
+    };
+    auto axis_op = [&](const std::string& name, std::int64_t axis) {
+        return mm->add_instruction(migraphx::make_op(name, {{"axis", axis}}), x);
+    };
+    mm->add_return({reduce("reduce_sum", {3}),
+                    reduce("reduce_sum", {2}),
+                    reduce("reduce_sum", {1}),
+                    reduce("reduce_mean", {2, 3}),
+                    reduce("reduce_max", {0, 2, 3}),
+                    reduce("reduce_prod", {1}),
+                    axis_op("argmax", 1),
+                    axis_op("argmin", 3),
+                    axis_op("softmax", 3),
+                    axis_op("softmax", 1),
+                    axis_op("logsoftmax", 1),
+                    axis_op("prefix_scan_sum", 2),
+                    add_layernorm(*mm, x, {3}),
+                    add_layernorm(*mm, x, {1})});
+    return p;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,134 @@
+#include "sparsity.hpp"
+#include "benchmark.hpp"
+#include "perf.hpp"
+
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/sparsify_weights.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Sets a random level of the blocks of the {rows, cols} weights to zero.
+// The element at (i, j) is at i * row_stride + j * col_stride.
+static std::vector<float> prune(std::vector<float> w,
+                                std::size_t rows,
+                                std::size_t cols,
+                                std::size_t row_stride,
+                                std::size_t col_stride,
+                                double level,
+                                const sparsity_options& options)
+{
+    std::mt19937 gen(rows * cols);
+    std::uniform_real_distribution<> dist;
+    for(std::size_t r = 0; r < rows; r += options.block_rows)
+    {
+        for(std::size_t c = 0; c < cols; c += options.block_cols)
+        {
+            if(dist(gen) >= level)
+                continue;
+            for(std::size_t i = r; i < std::min(rows, r + options.block_rows); i++)
+            {
+                for(std::size_t j = c; j < std::min(cols, c + options.block_cols); j++)
+                    w[i * row_stride + j * col_stride] = 0;
+            }
+        }
+    }
+    return w;
+}
+
+static std::vector<float> generate_weights(const shape& s)
+{
+    std::vector<float> w;
+    generate_literal(s, 1).visit([&](auto x) { w.assign(x.begin(), x.end()); });
+    return w;
+}
+
+static program dot_program(double level, const sparsity_options& options)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    shape ws{shape::float_type, {options.k, options.n}};
+    auto x = mm->add_parameter("x", shape{shape::float_type, {options.batch, options.k}});
+    // The blocks are taken from the transposed {n, k} weights
+    auto w = mm->add_literal(literal{
+        ws, prune(generate_weights(ws), options.n, options.k, 1, options.n, level, options)});
+    mm->add_instruction(make_op("dot"), x, w);
+    return p;
+}
+
+static program convolution_program(double level, const sparsity_options& options)
+{
+    program p;
+    auto* mm = p.get_main_module();
+    auto c   = options.channels;
+    shape ws{shape::float_type, {c, c, 3, 3}};
+    auto x = mm->add_parameter("x", shape{shape::float_type, {options.batch, c, 28, 28}});
+    auto w = mm->add_literal(
+        literal{ws, prune(generate_weights(ws), c, c * 9, c * 9, 1, level, options)});
+    mm->add_instruction(make_op("convolution", {{"padding", {1, 1}}}), x, w);
+    return p;
+}
+
+static double time_program(program p, const target& t, const sparsity_options& options)
+{
+    p.compile(t);
+    parameter_map m;
+    fill_param_map(m, p, t);
+    benchmark_options bo;
+    bo.iterations = options.iterations;
+    bo.batch      = options.batch;
+    return run_benchmark(p, m, bo).runs.front().latency.mean;
+}
+
+template <class F>
+static void sweep(std::ostream& os,
+                  const std::string& name,
+                  const target& t,
+                  const sparsity_options& options,
+                  F make_program)
+{
+    os << name << ":" << std::endl;
+    os << std::setw(10) << "sparsity" << std::setw(12) << "dense(ms)" << std::setw(12)
+       << "sparse(ms)" << std::setw(10) << "speedup" << std::endl;
+    double crossover = -1;
+    for(auto level : options.levels)
+    {
+        auto p      = make_program(level, options);
+        auto sparse = p;
+        // Convert the weights whatever their sparsity, to time the sparse
+        // kernel at every level
+        run_passes(*sparse.get_main_module(),
+                   {sparsify_weights{0, options.block_rows, options.block_cols},
+                    dead_code_elimination{}});
+        auto dense_time  = time_program(p, t, options);
+        auto sparse_time = time_program(sparse, t, options);
+        if(crossover < 0 and sparse_time < dense_time)
+            crossover = level;
+        os << std::fixed << std::setprecision(3) << std::setw(10) << level << std::setw(12)
+           << dense_time << std::setw(12) << sparse_time << std::setw(10)
+           << dense_time / sparse_time << std::endl;
+    }
+    if(crossover < 0)
+        os << "The sparse kernel was never faster" << std::endl;
+    else
+        os << "The sparse kernel is faster from a sparsity of " << crossover << std::endl;
+    os << std::endl;
+}
+
+void run_sparsity_sweep(std::ostream& os, const target& t, const sparsity_options& options)
+{
+    sweep(os, "dot", t, options, &dot_program);
+    sweep(os, "convolution", t, options, &convolution_program);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
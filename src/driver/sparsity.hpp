@@ -0,0 +1,36 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_SPARSITY_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_SPARSITY_HPP
+
+#include <migraphx/target.hpp>
+#include <iosfwd>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct sparsity_options
+{
+    // Fractions of the blocks of the weights that are set to zero
+    std::vector<double> levels = {0, 0.25, 0.5, 0.6, 0.7, 0.8, 0.9, 0.95};
+    std::size_t batch          = 1;
+    // Size of the {k, n} weights of the dot
+    std::size_t k = 1024;
+    std::size_t n = 1024;
+    // Channels of the 3x3 convolution, which runs on a 28x28 image
+    std::size_t channels   = 64;
+    std::size_t block_rows = 4;
+    std::size_t block_cols = 8;
+    std::size_t iterations = 100;
+};
+
+/// Times a dot and a convolution with pruned weights at each level of
+/// sparsity, compiled as is and with the weights stored as block sparse
+/// rows, and prints where the sparse kernels start to be faster
+void run_sparsity_sweep(std::ostream& os, const target& t, const sparsity_options& options);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,70 @@
+#include "split.hpp"
+#include "benchmark.hpp"
+#include "perf.hpp"
+
+#include <migraphx/compile_options.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// The number of sub-batches of the compiled program, which is 1 when the
+// batch was not split
+static std::size_t sub_batches(const program& p)
+{
+    const auto* mm = p.get_main_module();
+    auto it        = std::find_if(mm->begin(), mm->end(), [](const auto& ins) {
+        return contains({"run_parallel", "cpu::run_parallel"}, ins.name());
+    });
+    if(it == mm->end())
+        return 1;
+    return it->module_inputs().size();
+}
+
+static double time_program(program& p,
+                           const target& t,
+                           std::size_t splits,
+                           std::size_t batch,
+                           const split_options& options)
+{
+    compile_options co;
+    co.split_batch = splits;
+    p.compile(t, co);
+    parameter_map m;
+    fill_param_map(m, p, t);
+    benchmark_options bo;
+    bo.iterations = options.iterations;
+    bo.batch      = batch;
+    return run_benchmark(p, m, bo).runs.front().latency.mean;
+}
+
+void run_split_sweep(std::ostream& os,
+                     const target& t,
+                     const std::function<program(std::size_t batch)>& load,
+                     const split_options& options)
+{
+    os << std::setw(8) << "batch" << std::setw(8) << "splits" << std::setw(12) << "whole(ms)"
+       << std::setw(12) << "split(ms)" << std::setw(14) << "whole(inf/s)" << std::setw(14)
+       << "split(inf/s)" << std::setw(10) << "speedup" << std::endl;
+    for(auto batch : options.batches)
+    {
+        auto whole      = load(batch);
+        auto split      = load(batch);
+        auto whole_time = time_program(whole, t, 1, batch, options);
+        auto split_time = time_program(split, t, options.splits, batch, options);
+        os << std::fixed << std::setprecision(3) << std::setw(8) << batch << std::setw(8)
+           << sub_batches(split) << std::setw(12) << whole_time << std::setw(12) << split_time
+           << std::setprecision(1) << std::setw(14) << batch * 1000.0 / whole_time
+           << std::setw(14) << batch * 1000.0 / split_time << std::setprecision(3)
+           << std::setw(10) << whole_time / split_time << std::endl;
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,34 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_SPLIT_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_SPLIT_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct split_options
+{
+    std::vector<std::size_t> batches = {1, 16, 64, 128, 256};
+    // Number of sub-batches the batch is split into
+    std::size_t splits     = 4;
+    std::size_t iterations = 20;
+};
+
+/// Times the program that load returns for each batch size, compiled as is
+/// and with the batch split into sub-batches that run at the same time, and
+/// prints the throughput of both
+void run_split_sweep(std::ostream& os,
+                     const target& t,
+                     const std::function<program(std::size_t batch)>& load,
+                     const split_options& options);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
@@ -3,15 +3,20 @@
 
 #include <migraphx/ref/target.hpp>
 #include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
 #include <migraphx/verify_args.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/quantization.hpp>
+#include <migraphx/time.hpp>
 
 namespace migraphx {
 namespace driver {
 inline namespace MIGRAPHX_INLINE_NS {
 
+using milliseconds = std::chrono::duration<double, std::milli>;
+
 std::vector<argument> run_ref(program p, const parameter_map& inputs)
 {
     p.compile(ref::target{});
@@ -47,7 +52,7 @@ std::vector<argument> run_target(program p,
     return output;
 }
 
-void verify_program(const std::string& name,
+bool verify_program(const std::string& name,
                     const program& p,
                     const target& t,
                     compile_options options,
@@ -55,14 +60,20 @@ void verify_program(const std::string& name,
                     const parameter_map& inputs,
                     double tolerance)
 {
-    auto x = run_ref(p, inputs);
-    auto y = run_target(p, t, options, quantize, inputs);
+    std::vector<argument> x;
+    std::vector<argument> y;
+    auto ref_time    = time<milliseconds>([&] { x = run_ref(p, inputs); });
+    auto target_time = time<milliseconds>([&] { y = run_target(p, t, options, quantize, inputs); });
+    std::cout << "Verify time for " << name << ": ref " << ref_time << "ms, " << t.name() << " "
+              << target_time << "ms" << std::endl;
 
+    bool passed            = true;
     std::size_t output_num = x.size();
     for(std::size_t i = 0; i < output_num; ++i)
     {
-        verify_args(name, x[i], y[i], tolerance);
+        passed &= verify_args(name, x[i], y[i], tolerance);
     }
+    return passed;
 }
 
 void verify_instructions(const program& prog,
@@ -142,6 +153,146 @@ void verify_reduced_program(const program& p,
     }
 }
 
+// The program that only returns the outputs of the instructions at the indices
+static program return_instructions(program p, const std::vector<std::size_t>& indices)
+{
+    auto* mm  = p.get_main_module();
+    auto last = std::prev(mm->end());
+    if(last->name() == "@return")
+        mm->remove_instruction(last);
+    std::vector<instruction_ref> outputs;
+    std::transform(indices.begin(),
+                   indices.end(),
+                   std::back_inserter(outputs),
+                   [&](auto i) { return std::next(mm->begin(), i); });
+    mm->add_return(outputs);
+    return p;
+}
+
+void verify_lockstep_program(const program& p,
+                             const target& t,
+                             compile_options options,
+                             precision quantize,
+                             const parameter_map& inputs,
+                             double tolerance)
+{
+    // The reference is run once and returns every intermediate. Each
+    // instruction is run on the target in a program that only returns its
+    // output, so the target compiles it the same way as in the original
+    // program. They are checked in program order, since an op such as relu,
+    // argmax or clip can hide a divergence in the instructions before it.
+    const auto* mm = p.get_main_module();
+    std::vector<std::size_t> indices;
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name().front() == '@' or ins->name() == "undefined")
+            continue;
+        indices.push_back(std::distance(mm->begin(), ins));
+    }
+    auto gold = run_ref(return_instructions(p, indices), inputs);
+    for(std::size_t k = 0; k < indices.size(); k++)
+    {
+        auto ins  = std::next(mm->begin(), indices[k]);
+        auto name = std::to_string(indices[k]) + ": " + ins->name();
+        std::cout << "Verify instruction " << name << std::endl;
+        auto result =
+            run_target(return_instructions(p, {indices[k]}), t, options, quantize, inputs);
+        if(verify_args(name, gold[k], result.front(), tolerance))
+            continue;
+        std::cout << "First divergent instruction:" << std::endl;
+        mm->debug_print(ins);
+        return;
+    }
+    std::cout << "All " << indices.size() << " instructions match" << std::endl;
+}
+
+// The index of the first of n steps that fails, or n when they all pass. This
+// needs O(log n) verifications, since it assumes that the failures are
+// monotonic: once a step fails, all of the steps after it fail as well.
+template <class F>
+static std::size_t find_first_failure(std::size_t n, F passes)
+{
+    if(n == 0 or passes(n - 1))
+        return n;
+    std::size_t first = 0;
+    std::size_t last  = n - 1;
+    while(first < last)
+    {
+        auto mid = first + (last - first) / 2;
+        if(passes(mid))
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return last;
+}
+
+static program take_instructions(program p, std::size_t n)
+{
+    auto* mm = p.get_main_module();
+    mm->remove_instructions(std::next(mm->begin(), n), mm->end());
+    return p;
+}
+
+void verify_bisected_program(const program& p,
+                             const target& t,
+                             compile_options options,
+                             precision quantize,
+                             const parameter_map& inputs,
+                             double tolerance)
+{
+    const auto* mm = p.get_main_module();
+    std::size_t n  = std::distance(mm->begin(), mm->end());
+    if(std::prev(mm->end())->name() == "@return")
+        n--;
+    // Step i verifies the program of the first i + 1 instructions
+    auto i = find_first_failure(n, [&](std::size_t k) {
+        std::cout << "Verify first " << k + 1 << " instructions" << std::endl;
+        return verify_program(std::to_string(k + 1),
+                              take_instructions(p, k + 1),
+                              t,
+                              options,
+                              quantize,
+                              inputs,
+                              tolerance);
+    });
+    if(i == n)
+    {
+        std::cout << "Program passed" << std::endl;
+        return;
+    }
+    std::cout << "First divergent instruction:" << std::endl;
+    mm->debug_print(std::next(mm->begin(), i));
+}
+
+void verify_quantized_weights(const program& p,
+                              const target& t,
+                              compile_options options,
+                              const parameter_map& inputs,
+                              std::size_t bits,
+                              std::size_t group_size)
+{
+    auto qp = p;
+    quantize_weights(qp, bits, group_size);
+    std::vector<argument> x;
+    std::vector<argument> y;
+    auto ref_time    = time<milliseconds>([&] { x = run_ref(p, inputs); });
+    auto target_time = time<milliseconds>(
+        [&] { y = run_target(qp, t, options, precision::fp32, inputs); });
+    std::cout << "Verify time: ref " << ref_time << "ms, " << t.name() << " " << target_time
+              << "ms" << std::endl;
+    std::cout << "Weights: " << literal_bytes(p) / (1024.0 * 1024.0) << "MiB -> "
+              << literal_bytes(qp) / (1024.0 * 1024.0) << "MiB with " << bits << " bits"
+              << std::endl;
+    for(std::size_t i = 0; i < x.size(); ++i)
+    {
+        visit_all(x[i], y[i])([&](auto ref, auto target) {
+            std::cout << "Output " << i << ": rms error " << rms_range(ref, target)
+                      << ", max diff " << max_diff(ref, target) << std::endl;
+        });
+    }
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -8,7 +8,7 @@ namespace migraphx {
 namespace driver {
 inline namespace MIGRAPHX_INLINE_NS {
 
-void verify_program(const std::string& name,
+bool verify_program(const std::string& name,
                     const program& p,
                     const target& t,
                     compile_options options     = compile_options{},
@@ -26,6 +26,26 @@ void verify_reduced_program(const program& p,
                             precision quantize          = precision::fp32,
                             const parameter_map& inputs = {},
                             double tolerance            = 80);
+void verify_lockstep_program(const program& p,
+                             const target& t,
+                             compile_options options     = compile_options{},
+                             precision quantize          = precision::fp32,
+                             const parameter_map& inputs = {},
+                             double tolerance            = 80);
+void verify_bisected_program(const program& p,
+                             const target& t,
+                             compile_options options     = compile_options{},
+                             precision quantize          = precision::fp32,
+                             const parameter_map& inputs = {},
+                             double tolerance            = 80);
+// Reports the error of the program with the weights of dot quantized to the
+// number of bits, against the unquantized program on ref
+void verify_quantized_weights(const program& p,
+                              const target& t,
+                              compile_options options,
+                              const parameter_map& inputs,
+                              std::size_t bits,
+                              std::size_t group_size);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
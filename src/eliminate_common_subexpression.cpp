@@ -5,11 +5,21 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/functional.hpp>
 
+#include <string>
 #include <unordered_set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Literals are bucketed by the hash of their contents as well, so only
+// literals that are likely to be equal are compared element by element
+static std::string cse_key(instruction_ref ins)
+{
+    if(ins->name() == "@literal")
+        return ins->name() + std::to_string(ins->get_literal().hash());
+    return ins->name();
+}
+
 template <class Range>
 void cse_range(module& m, Range&& r)
 {
@@ -22,7 +32,8 @@ void cse_range(module& m, Range&& r)
             continue;
 
         // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
+        auto key                = cse_key(ins);
+        auto found_instructions = range(instructions.equal_range(key));
         for(const auto& pp : found_instructions)
         {
             auto eq = pp.second;
@@ -43,7 +54,7 @@ void cse_range(module& m, Range&& r)
             });
             cse_range(m, outputs);
         }
-        instructions.emplace(ins->name(), ins);
+        instructions.emplace(key, ins);
     }
 }
 
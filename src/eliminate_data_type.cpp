@@ -17,7 +17,9 @@ void eliminate_data_type::apply(module& m) const
                                                            "roialign",
                                                            "scatternd_add",
                                                            "scatternd_mul",
-                                                           "scatternd_none"};
+                                                           "scatternd_none",
+                                                           "sparse_dot",
+                                                           "weight_dot"};
     for(auto ins : iterator_for(m))
     {
         if(ins->name()[0] == '@')
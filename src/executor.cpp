@@ -0,0 +1,123 @@
+#include <migraphx/executor.hpp>
+#include <migraphx/context.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct executor_impl
+{
+    struct request
+    {
+        parameter_map params;
+        executor::callback f;
+    };
+
+    std::vector<program> programs;
+    std::vector<std::thread> threads;
+    mutable std::mutex m;
+    std::condition_variable cv;
+    std::deque<request> requests;
+    std::size_t running = 0;
+    bool closed         = false;
+
+    ~executor_impl() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            closed = true;
+        }
+        cv.notify_all();
+        for(auto&& t : threads)
+            t.join();
+    }
+
+    // Returns false once the executor is closed and no request is left
+    bool pop(request& r)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return closed or not requests.empty(); });
+        if(requests.empty())
+            return false;
+        r = std::move(requests.front());
+        requests.pop_front();
+        running++;
+        return true;
+    }
+
+    void run(const program& p)
+    {
+        request r;
+        while(pop(r))
+        {
+            std::vector<argument> results;
+            std::exception_ptr error = nullptr;
+            try
+            {
+                results = p.eval(r.params);
+                if(p.is_compiled())
+                    p.get_context().finish();
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+            r.f(std::move(results), error);
+            // Release the parameters before the request counts as finished
+            r = request{};
+            std::lock_guard<std::mutex> lock(m);
+            running--;
+        }
+    }
+};
+
+executor::executor(const program& p, std::size_t workers)
+    : impl(std::make_shared<executor_impl>())
+{
+    impl->programs.resize(std::max<std::size_t>(workers, 1), p);
+    // The impl joins the threads before it is destroyed, so they can use it
+    auto* self = impl.get();
+    for(const auto& wp : impl->programs)
+    {
+        const auto* pp = &wp;
+        impl->threads.emplace_back([self, pp] { self->run(*pp); });
+    }
+}
+
+std::future<std::vector<argument>> executor::eval_async(parameter_map params)
+{
+    // A std::function must be copyable, so the promise is shared
+    auto p      = std::make_shared<std::promise<std::vector<argument>>>();
+    auto result = p->get_future();
+    this->eval_async(std::move(params), [p](std::vector<argument> results, std::exception_ptr e) {
+        if(e)
+            p->set_exception(e);
+        else
+            p->set_value(std::move(results));
+    });
+    return result;
+}
+
+void executor::eval_async(parameter_map params, callback f)
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->requests.push_back({std::move(params), std::move(f)});
+    }
+    impl->cv.notify_one();
+}
+
+std::size_t executor::pending() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->requests.size() + impl->running;
+}
+
+std::size_t executor::workers() const { return impl->programs.size(); }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
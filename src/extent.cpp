@@ -0,0 +1,88 @@
+#include <migraphx/extent.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/par_for.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+shape extent_shape(const shape& s, const std::vector<std::size_t>& extent)
+{
+    return {s.type(), extent, s.strides()};
+}
+
+std::vector<std::size_t> pointwise_extent(const shape& output,
+                                          const std::vector<argument>& inputs)
+{
+    if(inputs.empty())
+        return {};
+    auto result = inputs.front().extent();
+    for(const auto& input : inputs)
+    {
+        if(not input.padded() or input.get_shape().lens() != output.lens() or
+           input.extent() != result)
+            return {};
+    }
+    return result;
+}
+
+bool all_zero(const argument& a)
+{
+    bool result = true;
+    a.visit([&](auto v) {
+        result = std::all_of(v.begin(), v.end(), [](auto x) { return x == 0; });
+    });
+    return result;
+}
+
+// Copies value into each element of the padding, or sets it to zero when
+// value is null
+static void fill(const argument& a, const char* value)
+{
+    if(not a.padded() or a.get_shape().elements() == 0)
+        return;
+    const auto& s    = a.get_shape();
+    const auto& lens = s.lens();
+    auto extent      = a.extent();
+    auto n           = lens.back();
+    auto stride      = s.strides().back();
+    auto size        = s.type_size();
+    auto* data       = a.data();
+    par_for(s.elements() / n, std::max<std::size_t>(1, 4096 / n), [&](auto r) {
+        // The whole row is padding when it is past the extent on an outer axis
+        bool inside = true;
+        auto outer  = r;
+        for(auto i = lens.size() - 1; i > 0; i--)
+        {
+            inside = inside and outer % lens[i - 1] < extent[i - 1];
+            outer /= lens[i - 1];
+        }
+        auto start = inside ? extent.back() : 0;
+        auto* row  = data + s.index(r * n) * size;
+        if(value == nullptr and stride == 1)
+        {
+            std::memset(row + start * size, 0, (n - start) * size);
+            return;
+        }
+        for(auto j = start; j < n; j++)
+        {
+            if(value == nullptr)
+                std::memset(row + j * stride * size, 0, size);
+            else
+                std::memcpy(row + j * stride * size, value, size);
+        }
+    });
+}
+
+void zero_padding(const argument& a) { fill(a, nullptr); }
+
+void fill_padding(const argument& a, const argument& value)
+{
+    if(value.get_shape().type() != a.get_shape().type() or value.get_shape().elements() != 1)
+        MIGRAPHX_THROW("FILL_PADDING: Value must be one element of the type of the argument");
+    fill(a, value.data());
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -70,12 +70,25 @@ struct argument : raw_data<argument>
     /// Return the ith element
     argument element(std::size_t i) const;
 
+    /// The lens of the leading part of the data that holds values, when the
+    /// shape is the most an op can produce, such as the scan outputs of a
+    /// loop that stops early. The padding past it is zero. It is the lens of
+    /// the shape when the argument is not padded.
+    std::vector<std::size_t> extent() const;
+
+    /// Whether the extent is smaller than the shape
+    bool padded() const;
+
+    /// Make a copy of the argument that only holds values in the extent
+    argument with_extent(std::vector<std::size_t> e) const;
+
     private:
     void assign_buffer(std::function<char*()> d);
     struct data_t
     {
         std::function<char*()> get = nullptr;
         std::vector<data_t> sub = {};
+        std::vector<std::size_t> extent = {};
         data_t share() const;
         static data_t from_args(const std::vector<argument>& args);
     };
@@ -0,0 +1,61 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_ARGUMENT_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_ARGUMENT_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct argument_pool_stats
+{
+    // Buffers handed out by the pool and their requested size
+    std::size_t allocations = 0;
+    std::size_t bytes       = 0;
+    // Allocations that reused a cached buffer instead of allocating one
+    std::size_t reused = 0;
+    // Bytes of the buffers currently cached by the pool
+    std::size_t cached_bytes = 0;
+};
+
+/// Caches the buffers of arguments by size class, so arguments that are
+/// allocated on every eval reuse memory that is already mapped instead of
+/// going through malloc and page faulting fresh memory. Buffers are split
+/// into shards by thread to avoid contention between concurrent evals.
+struct argument_pool
+{
+    argument_pool();
+
+    /// A zero initialized buffer of at least n bytes, which is returned to
+    /// the pool when the last reference is released
+    std::shared_ptr<char> allocate(std::size_t n);
+
+    argument_pool_stats stats() const;
+
+    /// Free cached buffers until at most limit bytes are cached
+    void trim(std::size_t limit);
+
+    /// Free the cached buffers beyond the most bytes that were in use at
+    /// once since the last call, so the cache does not grow across evals
+    void end_eval();
+
+    /// Size classes are 64 bytes and then four steps between each power of
+    /// two, so at most a quarter of a buffer is wasted
+    static std::size_t size_class(std::size_t n);
+    static std::size_t class_size(std::size_t c);
+
+    struct impl;
+
+    private:
+    std::shared_ptr<impl> pimpl;
+};
+
+/// The pool used to allocate arguments, or nullptr when it is disabled by
+/// setting MIGRAPHX_DISABLE_ARGUMENT_POOL
+argument_pool* get_argument_pool();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
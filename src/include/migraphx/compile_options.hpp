@@ -11,6 +11,11 @@ struct compile_options
 {
     bool offload_copy = false;
     bool fast_math    = true;
+
+    /// Number of sub-batches the batch is split into, which run at the same
+    /// time on targets that support it
+    std::size_t split_batch = 1;
+
     tracer trace{};
 };
 
@@ -0,0 +1,21 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_DOT_WEIGHTS_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DOT_WEIGHTS_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/shape.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Returns the 2D weights that are broadcast over the batch of a dot to give
+/// its second input b, or b itself when it is not such a broadcast
+instruction_ref get_dot_weights(instruction_ref b);
+
+/// Whether the shape holds float, half or double values
+bool is_float(const shape& s);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
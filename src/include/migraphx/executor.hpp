@@ -0,0 +1,53 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_EXECUTOR_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_EXECUTOR_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct executor_impl;
+
+/**
+ * @brief Runs evals of a compiled program asynchronously
+ *
+ * Requests are queued and run in order by a pool of worker threads. Each
+ * worker evaluates its own copy of the program, so its context and the
+ * buffers it allocates are reused by every request it runs, and two requests
+ * never share execution state. The context is finished before a result is
+ * returned, so the outputs can be read right away. Copies of an executor
+ * share the same workers, which finish the queued requests once the last
+ * copy is destroyed.
+ */
+struct executor
+{
+    /// Called with the outputs of a request, or with the exception it threw
+    using callback = std::function<void(std::vector<argument> results, std::exception_ptr error)>;
+
+    explicit executor(const program& p, std::size_t workers = 1);
+
+    /// The buffers of the parameters must stay valid until the request is finished
+    std::future<std::vector<argument>> eval_async(parameter_map params);
+
+    /// The callback runs on the worker thread after the request is finished,
+    /// and must not throw
+    void eval_async(parameter_map params, callback f);
+
+    /// Number of requests that are queued or running
+    std::size_t pending() const;
+
+    std::size_t workers() const;
+
+    private:
+    std::shared_ptr<executor_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
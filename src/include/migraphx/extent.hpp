@@ -0,0 +1,34 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_EXTENT_HPP
+#define MIGRAPHX_GUARD_RTGLIB_EXTENT_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// The shape of the part of s in the extent, which keeps the strides of s so
+/// it can view the same data
+shape extent_shape(const shape& s, const std::vector<std::size_t>& extent);
+
+/// The extent of an output that is computed element by element from the
+/// inputs, when all of them have the lens of the output and are padded to the
+/// same extent, so each element of its padding is computed from zeros. It is
+/// empty otherwise.
+std::vector<std::size_t> pointwise_extent(const shape& output,
+                                          const std::vector<argument>& inputs);
+
+/// Whether every element of the argument is zero
+bool all_zero(const argument& a);
+
+/// Set the elements of the argument past its extent to zero
+void zero_padding(const argument& a);
+
+/// Set the elements of the argument past its extent to the one element of value
+void fill_padding(const argument& a, const argument& value);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -9,11 +9,14 @@
 #include <migraphx/make_shared_array.hpp>
 #include <migraphx/config.hpp>
 
+#include <atomic>
 #include <memory>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+std::size_t hash_literal_data(const shape& s, const char* data);
+
 /**
  * @brief Represents a raw literal
  * @details This stores the literal has a raw buffer that is owned by this class
@@ -58,6 +61,11 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Create a literal that refers to an existing buffer, which must not be modified
+    literal(const shape& s, std::shared_ptr<char> pbuffer) : buffer(std::move(pbuffer)), m_shape(s)
+    {
+    }
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -68,6 +76,18 @@ struct literal : raw_data<literal>
 
     std::vector<literal> get_sub_objects() const { return {}; }
 
+    /// Hash of the shape and the contents, which is computed once and then cached
+    std::size_t hash() const
+    {
+        auto h = m_hash.value.load(std::memory_order_relaxed);
+        if(h == 0)
+        {
+            h = empty() ? 1 : hash_literal_data(m_shape, buffer.get());
+            m_hash.value.store(h, std::memory_order_relaxed);
+        }
+        return h;
+    }
+
     /// Convert the data to an argument
     argument get_argument() const
     {
@@ -75,9 +95,25 @@ struct literal : raw_data<literal>
         return {m_shape, [b]() { return b.get(); }};
     }
 
+    friend literal share_literal(const literal& l);
+
     private:
+    struct cached_hash
+    {
+        cached_hash() = default;
+        cached_hash(const cached_hash& rhs) : value(rhs.value.load(std::memory_order_relaxed)) {}
+        cached_hash& operator=(const cached_hash& rhs)
+        {
+            value.store(rhs.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+        // Zero means the hash hasn't been computed yet
+        std::atomic<std::size_t> value{0};
+    };
+
     std::shared_ptr<char> buffer;
     shape m_shape;
+    mutable cached_hash m_hash;
 
     template <class Iterator>
     void fill(Iterator start, Iterator end)
@@ -0,0 +1,64 @@
+#ifndef MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
+#define MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/matcher.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace match {
+
+namespace detail {
+template <class F>
+struct attention_matcher
+{
+    F f;
+    auto input(const std::string& name) const
+    {
+        return skip(f("contiguous"))(any().bind(name));
+    }
+
+    auto scores() const
+    {
+        return f("dot")(used_once(), arg(0)(input("q")), arg(1)(input("k"))).bind("scores");
+    }
+
+    auto scale_scores() const
+    {
+        return any_of(
+            f("mul")(used_once(),
+                     either_arg(0, 1)(scores(), skip_broadcasts(is_constant().bind("scale")))),
+            scores());
+    }
+
+    auto mask_scores() const
+    {
+        return any_of(
+            f("add")(used_once(),
+                     either_arg(0, 1)(scale_scores(), none_of(scale_scores()).bind("mask"))),
+            scale_scores());
+    }
+
+    auto probs() const { return f("softmax")(used_once(), arg(0)(mask_scores())).bind("probs"); }
+
+    auto matcher() const { return f("dot")(arg(0)(probs()), arg(1)(input("v"))); }
+};
+} // namespace detail
+
+/// Matches dot(softmax(dot(q, k) * scale + mask), v), where the scale and the
+/// mask are optional
+template <class F>
+auto attention(F f)
+{
+    return detail::attention_matcher<F>{f}.matcher();
+}
+
+inline auto attention()
+{
+    return attention([](auto x) { return name(x); });
+}
+
+} // namespace match
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MATCH_ATTENTION_HPP
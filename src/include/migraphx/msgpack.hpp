@@ -3,14 +3,30 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
+#include <iosfwd>
+#include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+/// A non-owning reference to a binary payload
+using binary_ref = std::pair<const char*, std::size_t>;
+
 std::vector<char> to_msgpack(const value& v);
 value from_msgpack(const std::vector<char>& buffer);
 value from_msgpack(const char* buffer, std::size_t size);
 
+/// Write v where every binary in the literal of a node named @literal is a
+/// placeholder that is written from the next payload in binaries instead. This
+/// allows large payloads to be written without copying them into the value.
+/// Any other binary, such as an attribute of an operator, is written as is.
+std::vector<char> to_msgpack(const value& v, const std::vector<binary_ref>& binaries);
+void to_msgpack(std::ostream& os, const value& v, const std::vector<binary_ref>& binaries);
+/// Read a value without copying the binary payloads of the literal nodes. Each
+/// of these binaries is replaced by its index into binaries, which reference
+/// the memory in buffer. Any other binary is copied into the value.
+value from_msgpack(const char* buffer, std::size_t size, std::vector<binary_ref>& binaries);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
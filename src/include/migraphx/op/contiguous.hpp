@@ -42,7 +42,8 @@ struct contiguous
                 output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
             });
         });
-        return result;
+        // The copy holds values in the same part as the input
+        return result.with_extent(args[0].extent());
     }
 
     auto apply() const
@@ -0,0 +1,48 @@
+#ifndef MIGRAPHX_GUARD_OPERATORS_LAYOUT_HPP
+#define MIGRAPHX_GUARD_OPERATORS_LAYOUT_HPP
+
+#include <migraphx/op/unary.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/config.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/// The layout operator copies its input into a tensor with the same lens, whose
+/// dimensions are stored in the order given by the permutation. For example, a
+/// permutation of {0, 2, 3, 1} stores an NCHW tensor as NHWC. Unlike transpose,
+/// the dimensions of the tensor do not change, only its strides.
+struct layout : unary<layout>
+{
+    std::vector<int64_t> permutation;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.permutation, "permutation"));
+    }
+
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(1).only_dims(permutation.size());
+        auto lens = inputs.at(0).lens();
+        auto t    = inputs.at(0).type();
+        return shape::from_permutation(t, lens, permutation);
+    }
+
+    std::string point_op() const { return "${0}"; }
+
+    auto apply() const
+    {
+        return [](auto x) { return x; };
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -51,7 +51,8 @@ struct nonzero
             });
         });
 
-        return result;
+        // The indices past the number of nonzero elements are padding
+        return result.with_extent({output_shape.lens().front(), vec_idx.size()});
     }
 };
 
@@ -0,0 +1,152 @@
+#ifndef MIGRAPHX_GUARD_OPERATORS_RUN_PARALLEL_HPP
+#define MIGRAPHX_GUARD_OPERATORS_RUN_PARALLEL_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/**
+ * Runs each submodule on its own part of the inputs, and stacks their
+ * outputs along the first axis. Submodule i takes inputs
+ * [i * names.size(), (i + 1) * names.size()) as the parameters in names. The
+ * submodules do not depend on each other, so they are run at the same time.
+ */
+struct run_parallel
+{
+    std::vector<std::string> names;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.names, "names"));
+    }
+
+    std::string name() const { return "run_parallel"; }
+
+    shape compute_shape(const std::vector<shape>& inputs, std::vector<module_ref> mods) const
+    {
+        if(mods.empty())
+            MIGRAPHX_THROW("RUN_PARALLEL: there must be at least one submodule");
+        if(inputs.size() != mods.size() * names.size())
+            MIGRAPHX_THROW("RUN_PARALLEL: expected " + std::to_string(names.size()) +
+                           " inputs for each submodule, but there are " +
+                           std::to_string(inputs.size()) + " inputs");
+        auto outputs = mods.front()->get_output_shapes();
+        for(auto& s : outputs)
+        {
+            if(s.lens().empty())
+                MIGRAPHX_THROW("RUN_PARALLEL: outputs must have at least one dimension");
+            s = shape{s.type(), s.lens()};
+        }
+        std::for_each(mods.begin() + 1, mods.end(), [&](module_ref mod) {
+            auto mod_outputs = mod->get_output_shapes();
+            if(mod_outputs.size() != outputs.size())
+                MIGRAPHX_THROW("RUN_PARALLEL: submodules must have the same number of outputs");
+            for(std::size_t j = 0; j < outputs.size(); j++)
+            {
+                auto lens      = outputs[j].lens();
+                const auto& ms = mod_outputs[j];
+                if(ms.type() != outputs[j].type() or ms.lens().size() != lens.size() or
+                   not std::equal(lens.begin() + 1, lens.end(), ms.lens().begin() + 1))
+                    MIGRAPHX_THROW("RUN_PARALLEL: outputs of submodules must only differ in the "
+                                   "first dimension");
+                lens[0] += ms.lens()[0];
+                outputs[j] = shape{ms.type(), lens};
+            }
+        });
+        return shape{outputs};
+    }
+
+    using run_function = std::function<std::vector<argument>(
+        module_ref&, const std::unordered_map<std::string, argument>&)>;
+
+    // The part of each output that submodule i writes
+    static std::vector<argument> output_slices(const std::vector<argument>& outputs,
+                                               const std::vector<module_ref>& mods,
+                                               std::size_t i)
+    {
+        std::vector<argument> result;
+        for(std::size_t j = 0; j < outputs.size(); j++)
+        {
+            std::size_t start = 0;
+            for(std::size_t k = 0; k < i; k++)
+                start += mods[k]->get_output_shapes()[j].lens()[0];
+            const auto& s = outputs[j].get_shape();
+            auto lens     = s.lens();
+            lens[0]       = mods[i]->get_output_shapes()[j].lens()[0];
+            auto offset   = start * s.strides()[0] * s.type_size();
+            auto output   = outputs[j];
+            result.emplace_back(shape{s.type(), lens}, [=] { return output.data() + offset; });
+        }
+        return result;
+    }
+
+    // Run submodule i, which writes its outputs straight into the slices when
+    // it takes them as output parameters, like the ones the cpu target adds
+    void run_module(std::size_t i,
+                    const std::vector<argument>& args,
+                    const std::vector<module_ref>& mods,
+                    const std::vector<argument>& outputs,
+                    const run_function& run) const
+    {
+        auto mod = mods[i];
+        std::unordered_map<std::string, argument> params;
+        for(std::size_t k = 0; k < names.size(); k++)
+            params[names[k]] = args[i * names.size() + k];
+        auto slices = output_slices(outputs, mods, i);
+        for(std::size_t j = 0; j < slices.size(); j++)
+        {
+            auto output_name = mod->name() + ":#output_" + std::to_string(j);
+            auto param       = mod->get_parameter(output_name);
+            if(param == mod->end())
+                continue;
+            const auto& ps = param->get_shape();
+            const auto& ss = slices[j].get_shape();
+            if(ps.standard() and ps.type() == ss.type() and ps.elements() == ss.elements())
+                params[output_name] = slices[j].reshape(ps);
+            else
+                params[output_name] = argument{ps};
+        }
+        auto results = run(mod, params);
+        for(std::size_t j = 0; j < slices.size(); j++)
+        {
+            if(results[j].data() == slices[j].data() and results[j].get_shape().standard())
+                continue;
+            visit_all(slices[j], results[j])(
+                [&](auto output, auto x) { std::copy(x.begin(), x.end(), output.begin()); });
+        }
+    }
+
+    argument compute(const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const run_function& run) const
+    {
+        std::vector<argument> outputs;
+        std::transform(output_shape.sub_shapes().begin(),
+                       output_shape.sub_shapes().end(),
+                       std::back_inserter(outputs),
+                       [](const shape& s) { return argument{s}; });
+        par_for(mods.size(), 1, [&](auto i) { this->run_module(i, args, mods, outputs, run); });
+        return argument{outputs};
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
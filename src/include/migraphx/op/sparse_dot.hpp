@@ -0,0 +1,95 @@
+#ifndef MIGRAPHX_GUARD_OPERATORS_SPARSE_DOT_HPP
+#define MIGRAPHX_GUARD_OPERATORS_SPARSE_DOT_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/streamutils.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/config.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/// A dot of a with the weights b, which are stored as block sparse rows (BSR)
+/// of the transposed {n, k} weights. Only the blocks with a nonzero weight are
+/// stored in values, with the shape {nnzb, block_rows, block_cols}. indices
+/// has the block column of each stored block, and the blocks of the i-th row
+/// of blocks are the ones from offsets[i] to offsets[i + 1].
+struct sparse_dot
+{
+    std::size_t block_rows = 4;
+    std::size_t block_cols = 8;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.block_rows, "block_rows"), f(self.block_cols, "block_cols"));
+    }
+
+    std::string name() const { return "sparse_dot"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(4);
+        check_shapes{inputs.data() + 1, inputs.data() + inputs.size(), *this}.standard();
+        const shape& a       = inputs.at(0);
+        const shape& values  = inputs.at(1);
+        const shape& indices = inputs.at(2);
+        const shape& offsets = inputs.at(3);
+        if(a.lens().size() < 2)
+            MIGRAPHX_THROW("SPARSE_DOT: a must have at least 2 dims");
+        if(values.type() != a.type())
+            MIGRAPHX_THROW("SPARSE_DOT: values must have the type of a");
+        if(indices.type() != shape::int32_type or offsets.type() != shape::int32_type)
+            MIGRAPHX_THROW("SPARSE_DOT: indices and offsets must be int32");
+        if(values.lens().size() != 3 or indices.lens().size() != 1 or offsets.lens().size() != 1)
+            MIGRAPHX_THROW("SPARSE_DOT: values must be 3 dims, and indices and offsets 1 dim");
+        auto k = a.lens().back();
+        if(block_rows == 0 or block_cols == 0 or k % block_cols != 0 or
+           values.lens()[1] != block_rows or values.lens()[2] != block_cols or
+           values.lens()[0] != indices.elements() or offsets.elements() < 2)
+        {
+            MIGRAPHX_THROW("SPARSE_DOT: blocks do not match: {" + to_string_range(a.lens()) +
+                           "} with values {" + to_string_range(values.lens()) + "}");
+        }
+        auto out_lens   = a.lens();
+        out_lens.back() = (offsets.elements() - 1) * block_rows;
+        return {a.type(), out_lens};
+    }
+
+    argument compute(const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        const auto* indices = args[2].cast<std::int32_t>();
+        const auto* offsets = args[3].cast<std::int32_t>();
+        visit_all(result, args[0], args[1])([&](auto output, auto a, auto values) {
+            shape_for_each(output_shape, [&](const auto& idx) {
+                auto n   = idx.back();
+                auto r   = n / block_rows;
+                auto ai  = idx;
+                double x = 0;
+                for(auto j = offsets[r]; j < offsets[r + 1]; j++)
+                {
+                    const auto* block =
+                        values.data() + (j * block_rows + n % block_rows) * block_cols;
+                    for(std::size_t i = 0; i < block_cols; i++)
+                    {
+                        ai.back() = indices[j] * block_cols + i;
+                        x += a(ai.begin(), ai.end()) * block[i];
+                    }
+                }
+                output(idx.begin(), idx.end()) = x;
+            });
+        });
+        return result;
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
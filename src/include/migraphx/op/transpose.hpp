@@ -1,6 +1,7 @@
 #ifndef MIGRAPHX_GUARD_OPERATORS_TRANSPOSE_HPP
 #define MIGRAPHX_GUARD_OPERATORS_TRANSPOSE_HPP
 
+#include <algorithm>
 #include <array>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/argument.hpp>
@@ -54,7 +55,14 @@ struct transpose
     }
     argument compute(shape output_shape, std::vector<argument> args) const
     {
-        return args[0].reshape(output_shape);
+        auto result = args[0].reshape(output_shape);
+        if(not args[0].padded())
+            return result;
+        auto extent = args[0].extent();
+        std::vector<std::size_t> permuted(extent.size());
+        std::transform(
+            dims.begin(), dims.end(), permuted.begin(), [&](auto i) { return extent[i]; });
+        return result.with_extent(permuted);
     }
     std::ptrdiff_t output_alias(const std::vector<shape>&) const { return 0; }
 };
@@ -0,0 +1,100 @@
+#ifndef MIGRAPHX_GUARD_OPERATORS_WEIGHT_DOT_HPP
+#define MIGRAPHX_GUARD_OPERATORS_WEIGHT_DOT_HPP
+
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/streamutils.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/config.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace op {
+
+/// Unpacks the k-th weight from a row of weights with the number of bits
+inline std::int8_t unpack_weight(const std::int8_t* row, std::size_t k, std::size_t bits)
+{
+    if(bits == 8)
+        return row[k];
+    // Two signed 4-bit values per byte, with the even one in the low bits
+    auto x = static_cast<std::uint8_t>(row[k / 2]);
+    if(k % 2 == 0)
+        x <<= 4;
+    return static_cast<std::int8_t>(x) >> 4;
+}
+
+/// A dot of a with the weights b, which are quantized per group of k values.
+/// b has the shape {n, k} with 8 bits, or {n, k / 2} with two 4-bit values per
+/// byte, and the scales have the shape {n, k / group_size}.
+struct weight_dot
+{
+    std::size_t bits       = 8;
+    std::size_t group_size = 1;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.bits, "bits"), f(self.group_size, "group_size"));
+    }
+
+    std::string name() const { return "weight_dot"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(3);
+        const shape& a      = inputs.at(0);
+        const shape& b      = inputs.at(1);
+        const shape& scales = inputs.at(2);
+        if(bits != 4 and bits != 8)
+            MIGRAPHX_THROW("WEIGHT_DOT: only 4 and 8 bit weights are supported");
+        if(a.lens().size() < 2 or b.lens().size() != 2 or scales.lens().size() != 2)
+            MIGRAPHX_THROW("WEIGHT_DOT: weights and scales must be 2 dims, and a at least 2");
+        if(b.type() != shape::int8_type or not b.standard())
+            MIGRAPHX_THROW("WEIGHT_DOT: weights must be packed int8");
+        if(scales.type() != a.type())
+            MIGRAPHX_THROW("WEIGHT_DOT: scales must have the type of a");
+        auto k = a.lens().back();
+        auto n = b.lens()[0];
+        if(b.lens()[1] * (8 / bits) != k or group_size == 0 or k % group_size != 0 or
+           scales.lens() != std::vector<std::size_t>{n, k / group_size})
+        {
+            MIGRAPHX_THROW("WEIGHT_DOT: inner dimensions do not match: {" +
+                           to_string_range(a.lens()) + "} x {" + to_string_range(b.lens()) +
+                           "} with scales {" + to_string_range(scales.lens()) + "}");
+        }
+        auto out_lens   = a.lens();
+        out_lens.back() = n;
+        return {a.type(), out_lens};
+    }
+
+    argument compute(const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        auto k        = args[0].get_shape().lens().back();
+        auto row      = args[1].get_shape().lens()[1];
+        const auto* b = args[1].cast<std::int8_t>();
+        visit_all(result, args[0], args[2])([&](auto output, auto a, auto scales) {
+            shape_for_each(output_shape, [&](const auto& idx) {
+                auto n   = idx.back();
+                auto ai  = idx;
+                double x = 0;
+                for(std::size_t i = 0; i < k; i++)
+                {
+                    ai.back() = i;
+                    auto w    = unpack_weight(b + n * row, i, bits) * scales(n, i / group_size);
+                    x += a(ai.begin(), ai.end()) * w;
+                }
+                output(idx.begin(), idx.end()) = x;
+            });
+        });
+        return result;
+    }
+};
+
+} // namespace op
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
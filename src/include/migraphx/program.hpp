@@ -25,6 +25,8 @@ struct program_impl;
 
 struct marker;
 
+struct parameter_binding;
+
 /**
  * @brief Stores the instruction stream
  */
@@ -51,8 +53,13 @@ struct program
 
     std::unordered_map<std::string, shape> get_parameter_shapes() const;
 
+    /// Output parameters, which are named #output_N, that are not in params
+    /// are allocated by the eval. An output that returns the same instruction
+    /// as an earlier one has no parameter, and aliases the earlier output.
     std::vector<argument> eval(parameter_map params) const;
 
+    std::vector<argument> eval(const parameter_binding& binding) const;
+
     std::size_t size() const;
 
     std::vector<shape> get_output_shapes() const;
@@ -75,6 +82,11 @@ struct program
     value to_value() const;
     void from_value(const value& v);
 
+    /// Serialize the program where the value of each literal is produced by write_literal
+    value to_value(const std::function<value(const literal&)>& write_literal) const;
+    /// Deserialize the program where each literal is produced by read_literal
+    void from_value(const value& v, const std::function<literal(const value&)>& read_literal);
+
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
     void print(std::unordered_map<instruction_ref, std::string>& names,
@@ -117,6 +129,26 @@ struct program
     std::unique_ptr<program_impl> impl;
 };
 
+/**
+ * @brief Arguments bound to the parameters of the main module of a program
+ *
+ * The names and shapes are checked once when the binding is made, so it can
+ * be evaluated many times without looking up each parameter again. Every
+ * eval uses the same buffers, so new inputs can be written into them between
+ * evals, and bound outputs are written straight into the caller's memory. A
+ * binding can only be used with the program it was made for, and is no
+ * longer valid once that program is modified.
+ */
+struct parameter_binding
+{
+    parameter_binding(const program& p, const parameter_map& params);
+
+    const module* mod = nullptr;
+    std::unordered_map<instruction_ref, argument> arguments;
+    // Output parameters that are allocated by each eval
+    std::vector<instruction_ref> unbound_outputs;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
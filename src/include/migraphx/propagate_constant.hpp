@@ -11,9 +11,20 @@ struct module;
 
 /**
  * Replace instructions which take all literals with a literal of the computation.
+ * The instructions are evaluated once each in order, and an intermediate result
+ * is freed as soon as the last instruction that uses it has been evaluated.
  */
 struct propagate_constant
 {
+    // Bytes of intermediate results that can be held at once, which limits
+    // how many instructions are evaluated in parallel. One instruction is
+    // always evaluated, even when its result is larger.
+    std::size_t memory_budget = std::size_t{1} << 30;
+    // Directory to store the folded literals in, so later compiles of the
+    // same model can load them instead. When it is empty, the directory is
+    // read from MIGRAPHX_PROPAGATE_CONSTANT_CACHE, and nothing is stored
+    // when that is not set either.
+    std::string cache_dir = "";
     std::string name() const { return "propagate_constant"; }
     void apply(module& m) const;
 };
@@ -22,6 +22,11 @@ void quantize_int8(program& prog,
                    const std::vector<parameter_map>& calibration,
                    const std::vector<std::string>& ins_names = {"dot", "convolution"});
 
+// Store the constant weights of dot as int8 or int4 with a scale for each
+// group of group_size values, or for each output channel when it is 0. This
+// needs no calibration data, as the activations stay in floating point.
+void quantize_weights(program& prog, std::size_t bits = 8, std::size_t group_size = 0);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
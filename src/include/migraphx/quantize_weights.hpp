@@ -0,0 +1,28 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_QUANTIZE_WEIGHTS_HPP
+#define MIGRAPHX_GUARD_RTGLIB_QUANTIZE_WEIGHTS_HPP
+
+#include <string>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/**
+ * quantize the constant weights of dot to int8 or int4, with a scale for each
+ * group of group_size values along k, or for each output channel when the
+ * group_size is 0
+ */
+struct quantize_weights_pass
+{
+    std::size_t bits       = 8;
+    std::size_t group_size = 0;
+    std::string name() const { return "quantize_weights"; }
+    void apply(module& m) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
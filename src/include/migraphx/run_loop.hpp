@@ -106,6 +106,14 @@ argument run_loop(const LoopModel& model,
     std::copy(in_args.begin() + 2, in_args.end(), out_args.begin());
     model.set_zero(ctx, scan_outputs, iter);
 
+    // The scan outputs past the last iteration are padding
+    for(auto i : range(out_args.size() - scan_outputs.size(), out_args.size()))
+    {
+        auto extent    = out_args[i].get_shape().lens();
+        extent.front() = iter;
+        out_args[i]    = out_args[i].with_extent(extent);
+    }
+
     return {out_args};
 }
 
@@ -0,0 +1,34 @@
+#ifndef MIGRAPHX_GUARD_RTGLIB_SPARSIFY_WEIGHTS_HPP
+#define MIGRAPHX_GUARD_RTGLIB_SPARSIFY_WEIGHTS_HPP
+
+#include <string>
+#include <migraphx/config.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+struct argument;
+
+/// Returns the fraction of the block_rows x block_cols blocks of the {n, k}
+/// weights that are all zeros
+double block_sparsity(const argument& weights, std::size_t block_rows, std::size_t block_cols);
+
+/**
+ * Store the constant weights of dot and convolution as block sparse rows,
+ * and replace the op with sparse_dot, when at least threshold of their blocks
+ * are all zeros. Convolutions are done as a sparse_dot of im2col.
+ */
+struct sparsify_weights
+{
+    double threshold       = 0.5;
+    std::size_t block_rows = 4;
+    std::size_t block_cols = 8;
+    std::string name() const { return "sparsify_weights"; }
+    void apply(module& m) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
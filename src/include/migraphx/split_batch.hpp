@@ -0,0 +1,33 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_SPLIT_BATCH_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_SPLIT_BATCH_HPP
+
+#include <migraphx/config.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+struct module_pass_manager;
+
+/// Whether the module runs one sub-batch of the main module
+bool is_batch_module(const module& m);
+
+/**
+ * Split the main module along the batch into sub-batch modules, which are
+ * run at the same time by run_parallel. Each sub-batch module has its own
+ * instructions, so a target plans its memory separately. The batch is the
+ * first dimension that most of the parameters share, and the main module is
+ * left as it is when any instruction mixes the items of the batch, such as a
+ * reduction or a softmax over the first axis.
+ */
+struct split_batch
+{
+    std::size_t splits = 2;
+    std::string name() const { return "split_batch"; }
+    void apply(module_pass_manager& mpm) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_SPLIT_BATCH_HPP
@@ -0,0 +1,104 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_TIMELINE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_TIMELINE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/value.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct marker;
+
+struct timeline_event
+{
+    std::string name;
+    std::string category;
+    // Microseconds since the timeline was created
+    double start    = 0;
+    double duration = 0;
+    std::size_t tid   = 0;
+    std::size_t depth = 0;
+    std::size_t bytes = 0;
+};
+
+/// Records events into fixed size ring buffers so it can be left enabled
+/// for long running processes. Each thread records into its own buffer,
+/// which are merged when the events are read, and when a buffer is full the
+/// oldest events of that thread are overwritten.
+struct timeline
+{
+    explicit timeline(std::size_t capacity = 65536);
+    timeline(const timeline&) = delete;
+    timeline& operator=(const timeline&) = delete;
+    ~timeline();
+
+    double now() const;
+    std::size_t thread_id();
+
+    /// A view of the name that lives as long as the timeline, so it can be
+    /// recorded many times without copying it
+    std::string_view intern(std::string_view name);
+
+    /// Record an event of the calling thread
+    void record(const timeline_event& e);
+    /// The name and category must be interned or string literals
+    void record(std::string_view name,
+                std::string_view category,
+                double start,
+                double duration,
+                std::size_t depth = 0,
+                std::size_t bytes = 0);
+    std::vector<timeline_event> events() const;
+    std::size_t dropped() const;
+    void clear();
+
+    /// Events in the Chrome trace-event format, which can be loaded into
+    /// chrome://tracing or Perfetto
+    value to_chrome_trace() const;
+    void write_chrome_trace(const std::string& filename) const;
+
+    private:
+    struct thread_buffer;
+    thread_buffer& local();
+
+    std::size_t id;
+    std::size_t capacity;
+    std::chrono::steady_clock::time_point epoch;
+    // Only guards the list of buffers, which grows once for each thread
+    mutable std::mutex m;
+    std::vector<std::unique_ptr<thread_buffer>> buffers;
+};
+
+/// Time a scope, such as a compiler pass, and record it when it goes out of scope
+struct timeline_scope
+{
+    timeline_scope(timeline* pt, std::string name, std::string category);
+    timeline_scope(const timeline_scope&) = delete;
+    timeline_scope& operator=(const timeline_scope&) = delete;
+    ~timeline_scope();
+
+    private:
+    timeline* t;
+    timeline_event e;
+};
+
+/// Marker that records each instruction with its thread, nesting depth and
+/// the size of its output
+marker make_timeline_marker(timeline& t);
+
+/// The process wide timeline which is enabled by setting MIGRAPHX_TIMELINE to
+/// a file name. The file is written when the process exits. Returns nullptr
+/// when it is not enabled.
+timeline* get_timeline();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
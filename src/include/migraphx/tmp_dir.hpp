@@ -7,6 +7,9 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// A name that is unique across processes and threads
+std::string unique_string(const std::string& prefix);
+
 struct tmp_dir
 {
     fs::path path;
@@ -0,0 +1,28 @@
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_WEIGHT_STORE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_WEIGHT_STORE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/literal.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Literals are looked up by their contents in a process wide store, so
+ * programs loaded separately that have identical weights share one buffer.
+ * The store only holds weak references, so a buffer is freed once no
+ * literal uses it anymore. Sharing can be turned off by setting
+ * MIGRAPHX_DISABLE_WEIGHT_SHARING.
+ */
+literal share_literal(const literal& l);
+
+/// Same as above, but only copies the data when it is not already in the store
+literal share_literal(const shape& s, const char* data);
+
+/// Number of buffers in the store that are still in use
+std::size_t shared_literal_count();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -148,7 +148,12 @@ bool operator==(const instruction& x, const instruction& y)
     if(std::tie(x.result, x.op, x.module_args) != std::tie(y.result, y.op, y.module_args))
         return false;
     if(x.name() == "@literal")
+    {
+        // Literals that share a buffer are the same without comparing the contents
+        if(x.lit.data() == y.lit.data())
+            return true;
         return x.lit == y.lit;
+    }
     return true;
 }
 
@@ -0,0 +1,58 @@
+#include <migraphx/layout_nhwc.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/eliminate_contiguous.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static void transform_convolutions(module& m)
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "convolution")
+            continue;
+        if(ins->get_shape().lens().size() != 4)
+            continue;
+        // Only the input is changed, since the weights are packed into the
+        // layout the convolution prefers when they are constant
+        auto args    = ins->inputs();
+        args.front() = m.insert_instruction(
+            ins, make_op("layout", {{"permutation", {0, 2, 3, 1}}}), args.front());
+        // The output has the layout of the input, so it is made contiguous for
+        // now, and eliminate_contiguous removes it where the users accept NHWC
+        auto conv = m.insert_instruction(ins, ins->get_operator(), args);
+        m.replace_instruction(ins, make_op("contiguous"), conv);
+    }
+}
+
+static void remove_layouts(module& m)
+{
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "layout")
+            continue;
+        auto input = ins->inputs().front();
+        if(ins->get_shape() != input->get_shape())
+            continue;
+        m.replace_instruction(ins, input);
+    }
+}
+
+void layout_nhwc::apply(module_pass_manager& mpm) const
+{
+    transform_convolutions(mpm.get_module());
+    mpm.run_pass(dead_code_elimination{});
+    mpm.run_pass(eliminate_contiguous{"contiguous"});
+    mpm.run_pass(dead_code_elimination{});
+    // The input of a convolution that follows another one is already NHWC
+    remove_layouts(mpm.get_module());
+    mpm.run_pass(dead_code_elimination{});
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,40 @@
+#include <migraphx/literal.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::uint64_t hash_mix(std::uint64_t h, std::uint64_t x)
+{
+    h ^= x * 0x9E3779B97F4A7C15ULL;
+    h = (h << 27u) | (h >> 37u);
+    return h * 0x94D049BB133111EBULL;
+}
+
+std::size_t hash_literal_data(const shape& s, const char* data)
+{
+    std::uint64_t h = hash_mix(0, s.type());
+    for(auto len : s.lens())
+        h = hash_mix(h, len);
+    for(auto stride : s.strides())
+        h = hash_mix(h, stride);
+    // Hash eight bytes at a time so large weights are hashed at close to memory bandwidth
+    std::size_t n = s.bytes();
+    std::size_t i = 0;
+    for(; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = hash_mix(h, word);
+    }
+    std::uint64_t tail = n;
+    if(i < n)
+        std::memcpy(&tail, data + i, n - i);
+    h = hash_mix(h, tail);
+    // Zero is reserved for a hash that hasn't been computed
+    return h == 0 ? 1 : h;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -2,12 +2,45 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
-#include <migraphx/file_buffer.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/weight_store.hpp>
 #include <fstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// Literals are read directly from the buffer without copying them into a value first
+static program load_msgpack(const char* buffer, std::size_t size)
+{
+    std::vector<binary_ref> binaries;
+    value v = from_msgpack(buffer, size, binaries);
+    program p;
+    p.from_value(v, [&](const value& lv) {
+        auto s   = migraphx::from_value<shape>(lv.at("shape"));
+        auto bin = binaries.at(lv.at("data").to<std::size_t>());
+        if(bin.second != s.bytes())
+            MIGRAPHX_THROW("Invalid literal size: expected " + std::to_string(s.bytes()) +
+                           " bytes but got " + std::to_string(bin.second));
+        return share_literal(s, bin.first);
+    });
+    return p;
+}
+
+// Literals are written directly from their storage without copying them into a value first
+template <class F>
+static auto save_msgpack(const program& p, F write)
+{
+    std::vector<binary_ref> binaries;
+    value v = p.to_value([&](const literal& l) {
+        binaries.emplace_back(l.data(), l.get_shape().bytes());
+        value lv;
+        lv["shape"] = migraphx::to_value(l.get_shape());
+        lv["data"]  = value::binary{};
+        return lv;
+    });
+    return write(v, binaries);
+}
+
 program load(const std::string& filename, const file_options& options)
 {
     return load_buffer(read_buffer(filename), options);
@@ -21,11 +54,13 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     program p;
     if(options.format == "msgpack")
     {
-        p.from_value(from_msgpack(buffer, size));
+        p = load_msgpack(buffer, size);
     }
     else if(options.format == "json")
     {
-        p.from_value(from_json_string(buffer, size));
+        p.from_value(from_json_string(buffer, size), [](const value& lv) {
+            return share_literal(migraphx::from_value<literal>(lv));
+        });
     }
     else
     {
@@ -36,19 +71,27 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
 
 void save(const program& p, const std::string& filename, const file_options& options)
 {
+    if(options.format == "msgpack")
+    {
+        std::ofstream os(filename, std::ios::binary);
+        save_msgpack(p, [&](const auto& v, const auto& binaries) { to_msgpack(os, v, binaries); });
+        if(not os)
+            MIGRAPHX_THROW("Error writing file: " + filename);
+        return;
+    }
     write_buffer(filename, save_buffer(p, options));
 }
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
-    value v = p.to_value();
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        buffer = save_msgpack(
+            p, [](const auto& v, const auto& binaries) { return to_msgpack(v, binaries); });
     }
     else if(options.format == "json")
     {
-        std::string s = to_json_string(v);
+        std::string s = to_json_string(p.to_value());
         buffer        = std::vector<char>(s.begin(), s.end());
     }
     else
@@ -1,6 +1,156 @@
 #include <migraphx/msgpack.hpp>
 #include <migraphx/serialize.hpp>
 #include <msgpack.hpp>
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+#include <tuple>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static bool is_literal_node(const msgpack::object_map& m)
+{
+    return std::any_of(m.ptr, m.ptr + m.size, [](const msgpack::object_kv& p) {
+        return p.key.type == msgpack::type::STR and p.val.type == msgpack::type::STR and
+               p.key.as<std::string>() == "name" and p.val.as<std::string>() == "@literal";
+    });
+}
+
+static bool is_literal_node(const std::vector<value>& v)
+{
+    return std::any_of(v.begin(), v.end(), [](const value& x) {
+        return x.get_key() == "name" and x.is_string() and x.get_string() == "@literal";
+    });
+}
+
+// Converts a msgpack object to a value. When binaries is set, the BIN payloads
+// of the literal nodes are not copied, instead they are recorded in binaries
+// and the value holds the index of the payload. Other BIN payloads, such as
+// the attributes of an operator, are copied.
+struct value_reader
+{
+    std::vector<binary_ref>* binaries = nullptr;
+
+    value read(const msgpack::object& o, bool in_literal = false) const
+    {
+        switch(o.type)
+        {
+        case msgpack::type::NIL: return nullptr;
+        case msgpack::type::BOOLEAN: return o.as<bool>();
+        case msgpack::type::POSITIVE_INTEGER: return o.as<std::uint64_t>();
+        case msgpack::type::NEGATIVE_INTEGER: return o.as<std::int64_t>();
+        case msgpack::type::FLOAT32:
+        case msgpack::type::FLOAT64: return o.as<double>();
+        case msgpack::type::STR: return o.as<std::string>();
+        case msgpack::type::BIN: {
+            if(binaries == nullptr or not in_literal)
+                return value::binary{o.via.bin.ptr, o.via.bin.size};
+            binaries->emplace_back(o.via.bin.ptr, o.via.bin.size);
+            return binaries->size() - 1;
+        }
+        case msgpack::type::ARRAY: {
+            value r = value::array{};
+            std::for_each(o.via.array.ptr,
+                          o.via.array.ptr + o.via.array.size,
+                          [&](const msgpack::object& so) {
+                              r.push_back(this->read(so, in_literal));
+                          });
+            return r;
+        }
+        case msgpack::type::MAP: {
+            value r      = value::object{};
+            bool literal = is_literal_node(o.via.map);
+            std::for_each(o.via.map.ptr,
+                          o.via.map.ptr + o.via.map.size,
+                          [&](const msgpack::object_kv& p) {
+                              auto key = p.key.as<std::string>();
+                              r[key]   = this->read(p.val,
+                                                  in_literal or (literal and key == "literal"));
+                          });
+            return r;
+        }
+        case msgpack::type::EXT: {
+            MIGRAPHX_THROW("msgpack EXT type not supported.");
+        }
+        }
+        MIGRAPHX_THROW("Unknown msgpack type");
+    }
+};
+
+// Packs a value. When binaries is set, every binary in the literal of a node
+// named @literal is a placeholder and the payload is written from the next
+// entry in binaries instead. Other binaries are written as they are.
+struct value_writer
+{
+    const std::vector<binary_ref>* binaries = nullptr;
+    std::size_t next_binary                 = 0;
+    bool in_literal                         = false;
+
+    template <class Stream>
+    void write(msgpack::packer<Stream>& o, const std::nullptr_t&)
+    {
+        o.pack_nil();
+    }
+    template <class Stream, class T>
+    void write(msgpack::packer<Stream>& o, const T& x)
+    {
+        o.pack(x);
+    }
+    template <class Stream>
+    void write(msgpack::packer<Stream>& o, const value::binary& x)
+    {
+        const char* data = reinterpret_cast<const char*>(x.data());
+        std::size_t size = x.size();
+        if(binaries != nullptr and in_literal)
+        {
+            if(next_binary >= binaries->size())
+                MIGRAPHX_THROW("msgpack: missing binary payload");
+            std::tie(data, size) = (*binaries)[next_binary];
+            next_binary++;
+        }
+        o.pack_bin(size);
+        o.pack_bin_body(data, size);
+    }
+    template <class Stream>
+    void write(msgpack::packer<Stream>& o, const std::vector<value>& v)
+    {
+        if(v.empty())
+        {
+            o.pack_array(0);
+            return;
+        }
+        if(not v.front().get_key().empty())
+        {
+            o.pack_map(v.size());
+            bool literal = is_literal_node(v);
+            for(auto&& x : v)
+            {
+                o.pack(x.get_key());
+                auto outer = in_literal;
+                in_literal = in_literal or (literal and x.get_key() == "literal");
+                this->write(o, x.without_key());
+                in_literal = outer;
+            }
+        }
+        else
+        {
+            o.pack_array(v.size());
+            for(auto&& x : v)
+            {
+                this->write(o, x);
+            }
+        }
+    }
+    template <class Stream>
+    void write(msgpack::packer<Stream>& o, const value& v)
+    {
+        v.visit_value([&](auto&& x) { this->write(o, x); });
+    }
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
 
 namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
@@ -12,60 +162,7 @@ MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
     {
         const msgpack::object& operator()(const msgpack::object& o, migraphx::value& v) const
         {
-            switch(o.type)
-            {
-            case msgpack::type::NIL: {
-                v = nullptr;
-                break;
-            }
-            case msgpack::type::BOOLEAN: {
-                v = o.as<bool>();
-                break;
-            }
-            case msgpack::type::POSITIVE_INTEGER: {
-                v = o.as<std::uint64_t>();
-                break;
-            }
-            case msgpack::type::NEGATIVE_INTEGER: {
-                v = o.as<std::int64_t>();
-                break;
-            }
-            case msgpack::type::FLOAT32:
-            case msgpack::type::FLOAT64: {
-                v = o.as<double>();
-                break;
-            }
-            case msgpack::type::STR: {
-                v = o.as<std::string>();
-                break;
-            }
-            case msgpack::type::BIN: {
-                v = migraphx::value::binary{o.via.bin.ptr, o.via.bin.size};
-                break;
-            }
-            case msgpack::type::ARRAY: {
-                migraphx::value r = migraphx::value::array{};
-                std::for_each(
-                    o.via.array.ptr,
-                    o.via.array.ptr + o.via.array.size,
-                    [&](const msgpack::object& so) { r.push_back(so.as<migraphx::value>()); });
-                v = r;
-                break;
-            }
-            case msgpack::type::MAP: {
-                migraphx::value r = migraphx::value::object{};
-                std::for_each(o.via.map.ptr,
-                              o.via.map.ptr + o.via.map.size,
-                              [&](const msgpack::object_kv& p) {
-                                  r[p.key.as<std::string>()] = p.val.as<migraphx::value>();
-                              });
-                v = r;
-                break;
-            }
-            case msgpack::type::EXT: {
-                MIGRAPHX_THROW("msgpack EXT type not supported.");
-            }
-            }
+            v = migraphx::value_reader{}.read(o);
             return o;
         }
     };
@@ -88,46 +185,10 @@ MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
     template <>
     struct pack<migraphx::value>
     {
-        template <class Stream>
-        void write(msgpack::packer<Stream>& o, const std::nullptr_t&) const
-        {
-            o.pack_nil();
-        }
-        template <class Stream, class T>
-        void write(msgpack::packer<Stream>& o, const T& x) const
-        {
-            o.pack(x);
-        }
-        template <class Stream>
-        void write(msgpack::packer<Stream>& o, const std::vector<migraphx::value>& v) const
-        {
-            if(v.empty())
-            {
-                o.pack_array(0);
-                return;
-            }
-            if(not v.front().get_key().empty())
-            {
-                o.pack_map(v.size());
-                for(auto&& x : v)
-                {
-                    o.pack(x.get_key());
-                    o.pack(x.without_key());
-                }
-            }
-            else
-            {
-                o.pack_array(v.size());
-                for(auto&& x : v)
-                {
-                    o.pack(x);
-                }
-            }
-        }
         template <class Stream>
         packer<Stream>& operator()(msgpack::packer<Stream>& o, const migraphx::value& v) const
         {
-            v.visit_value([&](auto&& x) { this->write(o, x); });
+            migraphx::value_writer{}.write(o, v);
             return o;
         }
     };
@@ -155,6 +216,30 @@ std::vector<char> to_msgpack(const value& v)
     msgpack::pack(vs, v);
     return vs.buffer;
 }
+template <class Stream>
+static void pack_with_binaries(Stream& s, const value& v, const std::vector<binary_ref>& binaries)
+{
+    msgpack::packer<Stream> pk(s);
+    value_writer writer{&binaries};
+    writer.write(pk, v);
+    if(writer.next_binary != binaries.size())
+        MIGRAPHX_THROW("msgpack: unused binary payloads");
+}
+std::vector<char> to_msgpack(const value& v, const std::vector<binary_ref>& binaries)
+{
+    vector_stream vs;
+    // Reserve for the payloads upfront to avoid reallocating the large buffer
+    vs.buffer.reserve(std::accumulate(
+        binaries.begin(), binaries.end(), std::size_t{0}, [](auto n, const binary_ref& b) {
+            return n + b.second;
+        }));
+    pack_with_binaries(vs, v, binaries);
+    return vs.buffer;
+}
+void to_msgpack(std::ostream& os, const value& v, const std::vector<binary_ref>& binaries)
+{
+    pack_with_binaries(os, v, binaries);
+}
 value from_msgpack(const char* buffer, std::size_t size)
 {
     msgpack::object_handle oh = msgpack::unpack(buffer, size);
@@ -164,6 +249,16 @@ value from_msgpack(const std::vector<char>& buffer)
 {
     return from_msgpack(buffer.data(), buffer.size());
 }
+// Reference the BIN payloads in the buffer instead of copying them into the zone
+static bool reference_bin(msgpack::type::object_type t, std::size_t, void*)
+{
+    return t == msgpack::type::BIN;
+}
+value from_msgpack(const char* buffer, std::size_t size, std::vector<binary_ref>& binaries)
+{
+    msgpack::object_handle oh = msgpack::unpack(buffer, size, &reference_bin);
+    return value_reader{&binaries}.read(oh.get());
+}
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
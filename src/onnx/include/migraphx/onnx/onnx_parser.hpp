@@ -8,6 +8,7 @@
 #include <onnx.pb.h>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -78,6 +79,9 @@ struct onnx_parser
     int64_t opset_version       = 13;
 
     std::unordered_map<std::string, op_func> ops;
+    // Raw data released from the initializers of the model being parsed, so
+    // the literals can refer to it instead of copying it
+    std::unordered_map<const onnx::TensorProto*, std::shared_ptr<std::string>> initializer_data;
 
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
@@ -88,6 +92,7 @@ struct onnx_parser
 
     void parse_from(std::istream& is, std::string name = "");
     void parse_from(const void* data, std::size_t size);
+    void parse_model(onnx::ModelProto& model);
     void parse_graph(module* mod, const onnx::GraphProto& graph);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
@@ -12,6 +12,12 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
+#include <migraphx/weight_store.hpp>
+#include <migraphx/par_for.hpp>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -44,6 +50,23 @@ create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, const
     return literal{{shape_type, dims}, data};
 }
 
+// Refer to the buffer instead of copying it, unless it is not aligned
+static literal create_literal(shape::type_t shape_type,
+                              const std::vector<size_t>& dims,
+                              const std::shared_ptr<std::string>& buffer)
+{
+    shape s = dims.empty() ? shape{shape_type} : shape{shape_type, dims};
+    // empty input
+    if(s.elements() == 0)
+        return {};
+    if(buffer->size() < s.bytes())
+        MIGRAPHX_THROW("PARSE_TENSOR: Raw data is smaller than the tensor");
+    char* data = &(*buffer)[0];
+    if(reinterpret_cast<std::uintptr_t>(data) % alignof(std::max_align_t) != 0)
+        return literal{s, data};
+    return literal{s, std::shared_ptr<char>(buffer, data)};
+}
+
 template <class T, MIGRAPHX_REQUIRES(not std::is_pointer<T>{})>
 static literal create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, T data)
 {
@@ -172,7 +195,6 @@ void onnx_parser::parse_undefined(module* mod, const std::string& name)
 
 void onnx_parser::parse_from(std::istream& is, std::string name)
 {
-    auto* mm         = prog.get_main_module();
     this->filename   = std::move(name);
     auto parent_path = fs::path(this->filename).parent_path();
     if(not parent_path.empty())
@@ -181,13 +203,7 @@ void onnx_parser::parse_from(std::istream& is, std::string name)
     onnx::ModelProto model;
     if(model.ParseFromIstream(&is))
     {
-        auto version  = get_opset_version(model);
-        opset_version = (version == -1) ? opset_version : version;
-
-        if(model.has_graph())
-        {
-            this->parse_graph(mm, model.graph());
-        }
+        this->parse_model(model);
     }
     else
     {
@@ -197,17 +213,10 @@ void onnx_parser::parse_from(std::istream& is, std::string name)
 
 void onnx_parser::parse_from(const void* data, std::size_t size)
 {
-    auto* mm = prog.get_main_module();
     onnx::ModelProto model;
     if(model.ParseFromArray(data, size))
     {
-        auto version  = get_opset_version(model);
-        opset_version = (version == -1) ? opset_version : version;
-
-        if(model.has_graph())
-        {
-            this->parse_graph(mm, model.graph());
-        }
+        this->parse_model(model);
     }
     else
     {
@@ -215,6 +224,24 @@ void onnx_parser::parse_from(const void* data, std::size_t size)
     }
 }
 
+void onnx_parser::parse_model(onnx::ModelProto& model)
+{
+    auto version  = get_opset_version(model);
+    opset_version = (version == -1) ? opset_version : version;
+    if(not model.has_graph())
+        return;
+    // The model is destroyed after parsing, so take ownership of the raw
+    // data of the initializers to keep it alive in the literals
+    for(auto& t : *model.mutable_graph()->mutable_initializer())
+    {
+        if(not t.has_raw_data() or not t.external_data().empty())
+            continue;
+        initializer_data[&t] = std::shared_ptr<std::string>(t.release_raw_data());
+    }
+    this->parse_graph(prog.get_main_module(), model.graph());
+    initializer_data.clear();
+}
+
 int64_t onnx_parser::get_opset_version(const onnx::ModelProto& model)
 {
     const auto& opset_import = model.opset_import();
@@ -230,13 +257,73 @@ int64_t onnx_parser::get_opset_version(const onnx::ModelProto& model)
     return version;
 }
 
+// Run f for each index on a bounded number of threads. Each thread takes
+// the next index when it finishes the last one, since the work per index
+// varies a lot.
+template <class F>
+static void dynamic_par_for(std::size_t n, F f)
+{
+    auto nthreads = std::min<std::size_t>(n, std::thread::hardware_concurrency());
+    if(nthreads <= 1)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex m;
+    std::vector<joinable_thread> threads;
+    threads.reserve(nthreads);
+    for(std::size_t t = 0; t < nthreads; t++)
+    {
+        threads.emplace_back([&] {
+            for(auto i = next++; i < n; i = next++)
+            {
+                try
+                {
+                    f(i);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    if(error == nullptr)
+                        error = std::current_exception();
+                    next = n;
+                }
+            }
+        });
+    }
+    threads.clear();
+    if(error != nullptr)
+        std::rethrow_exception(error);
+}
+
+static std::size_t tensor_elements(const onnx::TensorProto& t)
+{
+    return std::accumulate(
+        t.dims().begin(), t.dims().end(), std::size_t{1}, std::multiplies<std::size_t>());
+}
+
 void onnx_parser::parse_graph(module* mod, const onnx::GraphProto& graph)
 {
     std::unordered_map<std::string, instruction_ref> mod_insts;
-    for(auto&& f : graph.initializer())
+    const auto& initializers = graph.initializer();
+    // Decode the largest initializers first to balance the threads
+    std::vector<int> order(initializers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int x, int y) {
+        return tensor_elements(initializers.Get(x)) > tensor_elements(initializers.Get(y));
+    });
+    std::vector<literal> literals(initializers.size());
+    dynamic_par_for(order.size(), [&](std::size_t i) {
+        auto j      = order[i];
+        literals[j] = share_literal(parse_tensor(initializers.Get(j)));
+    });
+    for(int i = 0; i < initializers.size(); i++)
     {
         // backup instructions in parent mod
-        mod_insts[f.name()] = mod->add_literal(parse_tensor(f));
+        mod_insts[initializers.Get(i).name()] = mod->add_literal(literals[i]);
     }
 
     for(auto&& input : graph.input())
@@ -364,10 +451,12 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     {
         const std::string& data_file = t.external_data().at(0).value();
         auto raw_buffer              = read_buffer(path + "/" + data_file);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        auto type = get_type(t.data_type());
-        return create_literal(type, dims, s.data());
+        auto type                    = get_type(t.data_type());
+        return create_literal(type, dims, raw_buffer.data());
     }
+    auto it = initializer_data.find(&t);
+    if(it != initializer_data.end())
+        return create_literal(get_type(t.data_type()), dims, it->second);
     if(t.has_raw_data())
     {
         const std::string& s = t.raw_data();
@@ -389,13 +478,10 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     case onnx::TensorProto::UINT64:
         return create_literal(shape::uint64_type, dims, t.uint64_data());
     case onnx::TensorProto::FLOAT16: {
+        // The bits of each half are stored in an int32, so copy them as is
         std::vector<uint16_t> data_uint16(t.int32_data().begin(), t.int32_data().end());
-        std::vector<half> data_half;
-        std::transform(data_uint16.begin(),
-                       data_uint16.end(),
-                       std::back_inserter(data_half),
-                       [](uint16_t raw_val) { return *reinterpret_cast<half*>(&raw_val); });
-        return create_literal(shape::half_type, dims, data_half);
+        return create_literal(
+            shape::half_type, dims, reinterpret_cast<const char*>(data_uint16.data()));
     }
     case onnx::TensorProto::DOUBLE:
         return create_literal(shape::double_type, dims, t.double_data());
@@ -6,6 +6,7 @@
 #include <migraphx/env.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/time.hpp>
+#include <migraphx/timeline.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <iostream>
 #include <sstream>
@@ -37,6 +38,7 @@ void validate_pass(module& mod, const pass& p, tracer trace)
 void run_pass(program& prog, const pass& p, tracer trace)
 {
     trace("Pass: ", p.name());
+    timeline_scope scope{get_timeline(), p.name(), "pass"};
     p.apply(prog);
     trace(prog);
 }
@@ -74,7 +76,10 @@ struct module_pm : module_pass_manager
         assert(mod);
         trace("Module: ", mod->name(), ", Pass: ", p.name());
         assert(mod->validate() == mod->end());
-        p.apply(*this);
+        {
+            timeline_scope scope{get_timeline(), p.name() + " " + mod->name(), "pass"};
+            p.apply(*this);
+        }
         trace(*mod);
         validate_pass(*mod, p, *t);
     }
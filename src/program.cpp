@@ -1,4 +1,5 @@
 #include <migraphx/program.hpp>
+#include <migraphx/argument_pool.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/op/identity.hpp>
@@ -14,6 +15,7 @@
 #include <migraphx/output_iterator.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
+#include <migraphx/timeline.hpp>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -22,6 +24,7 @@
 
 #include <unordered_set>
 #include <map>
+#include <mutex>
 #include <cassert>
 
 namespace migraphx {
@@ -35,6 +38,9 @@ struct program_impl
     std::unordered_map<std::string, module> modules;
     context ctx;
     std::string target_name;
+    // The target of target_name, which is made once when the program is
+    // compiled or loaded instead of on every eval
+    target compiled_target;
 };
 
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
@@ -63,9 +69,10 @@ void program::assign(const program& p)
         impl->modules.clear();
     }
 
-    impl->ctx         = p.impl->ctx;
-    impl->target_name = p.impl->target_name;
-    impl->modules     = p.impl->modules;
+    impl->ctx             = p.impl->ctx;
+    impl->target_name     = p.impl->target_name;
+    impl->compiled_target = p.impl->compiled_target;
+    impl->modules         = p.impl->modules;
 
     // build a map from old ins to new ins
     // Build a map from old module to new module
@@ -141,14 +148,16 @@ bool program::is_compiled() const { return not this->impl->target_name.empty();
 void program::compile(const target& t, compile_options options)
 {
     assert(not this->is_compiled());
-    this->impl->target_name = t.name();
-    this->impl->ctx         = t.get_context();
+    this->impl->target_name     = t.name();
+    this->impl->compiled_target = t;
+    this->impl->ctx             = t.get_context();
     if(enabled(MIGRAPHX_TRACE_COMPILE{}))
         options.trace = tracer{std::cout};
 
     options.trace(*this);
     options.trace();
 
+    timeline_scope scope{get_timeline(), "compile " + t.name(), "compile"};
     auto&& passes = t.get_passes(this->impl->ctx, options);
     run_passes(*this, passes, options.trace);
 
@@ -242,7 +251,8 @@ std::vector<argument> generic_eval(const module* mod,
                                    context& ctx,
                                    std::unordered_map<std::string, argument> params,
                                    std::unordered_map<instruction_ref, argument> results,
-                                   F make_trace)
+                                   F make_trace,
+                                   bool parallel_modules = false)
 {
     assert(mod->validate() == mod->end());
     results.reserve(mod->size() * 2);
@@ -251,14 +261,17 @@ std::vector<argument> generic_eval(const module* mod,
     auto trace = make_trace(mod);
     for(auto ins : iterator_for(*mod))
     {
-        assert(results.find(ins) == results.end());
         const auto& name = ins->name();
+        assert(name == "@param" or results.find(ins) == results.end());
         if(name == "@literal")
         {
             results.emplace(ins, trace(ins, [&] { return ins->get_literal().get_argument(); }));
         }
         else if(name == "@param")
         {
+            // Parameters that were bound before the eval were already checked
+            if(contains(results, ins))
+                continue;
             results.emplace(
                 ins, trace(ins, [&] {
                     auto param_name = any_cast<builtin::param>(ins->get_operator()).parameter;
@@ -298,10 +311,17 @@ std::vector<argument> generic_eval(const module* mod,
                 });
 
             const auto& mod_args = ins->module_inputs();
-            auto module_eval     = [&](module_ref smod,
+            // Submodules that an op runs at the same time, such as the
+            // sub-batches of run_parallel, share the trace. Its state is not
+            // thread safe, so they take turns unless nothing is traced.
+            std::mutex module_mutex;
+            auto module_eval = [&](module_ref smod,
                                    const std::unordered_map<std::string, argument>& inputs) {
                 auto ssctx = ctx;
-                return generic_eval(smod, ssctx, inputs, results, make_trace);
+                std::unique_lock<std::mutex> lock(module_mutex, std::defer_lock);
+                if(not parallel_modules)
+                    lock.lock();
+                return generic_eval(smod, ssctx, inputs, results, make_trace, parallel_modules);
             };
 
             results.emplace(ins, trace(ins, [&] {
@@ -319,15 +339,80 @@ template <class F>
 std::vector<argument> generic_eval(const program& p,
                                    context& ctx,
                                    std::unordered_map<std::string, argument> params,
-                                   F make_trace)
+                                   std::unordered_map<instruction_ref, argument> results,
+                                   F make_trace,
+                                   bool parallel_modules = false)
 {
     const module* mm = p.get_main_module();
-    return generic_eval(mm, ctx, params, {}, make_trace);
+    auto result      = generic_eval(
+        mm, ctx, std::move(params), std::move(results), make_trace, parallel_modules);
+    // Release the cached buffers that were not needed by this eval
+    if(auto* pool = get_argument_pool())
+        pool->end_eval();
+    return result;
 }
 
-std::vector<argument> program::eval(parameter_map params) const
+template <class F>
+std::vector<argument> generic_eval(const program& p,
+                                   context& ctx,
+                                   std::unordered_map<std::string, argument> params,
+                                   F make_trace)
+{
+    return generic_eval(p, ctx, std::move(params), {}, make_trace);
+}
+
+static bool is_output_parameter(const std::string& name) { return contains(name, "#output_"); }
+
+static std::string parameter_name(instruction_ref ins)
+{
+    return any_cast<builtin::param>(ins->get_operator()).parameter;
+}
+
+// Allocate the output parameters the caller did not provide on the target, so
+// the last instructions can write into them as if they were bound
+static void allocate_outputs(const program_impl& impl,
+                             const std::vector<instruction_ref>& outputs,
+                             std::unordered_map<instruction_ref, argument>& results)
+{
+    if(impl.target_name.empty())
+    {
+        for(auto ins : outputs)
+            results.emplace(ins, argument{ins->get_shape()});
+        return;
+    }
+    for(auto ins : outputs)
+        results.emplace(ins, impl.compiled_target.allocate(ins->get_shape()));
+}
+
+parameter_binding::parameter_binding(const program& p, const parameter_map& params)
+    : mod(p.get_main_module())
+{
+    for(auto ins : iterator_for(*mod))
+    {
+        if(ins->name() != "@param")
+            continue;
+        auto name = parameter_name(ins);
+        auto it   = params.find(name);
+        if(it == params.end())
+        {
+            if(not is_output_parameter(name))
+                MIGRAPHX_THROW("Parameter not found: " + name);
+            unbound_outputs.push_back(ins);
+            continue;
+        }
+        if(it->second.get_shape() != ins->get_shape())
+            MIGRAPHX_THROW("Incorrect shape {" + to_string(it->second.get_shape()) +
+                           "} for parameter: " + name);
+        arguments.emplace(ins, it->second);
+    }
+}
+
+template <class F>
+std::vector<argument> eval_with_trace(const program& p,
+                                      context& ctx,
+                                      const target& tgt,
+                                      F run)
 {
-    auto& ctx = this->impl->ctx;
 #ifndef NDEBUG
     auto with_check_context = [&](auto f) {
         return [=, &ctx](auto&&) {
@@ -355,60 +440,110 @@ std::vector<argument> program::eval(parameter_map params) const
     {
         std::unordered_map<instruction_ref, std::string> ins_out;
         // get instruction names
-        this->print([&](auto x, auto ins_names) {
+        p.print([&](auto x, auto ins_names) {
             std::stringstream ss;
             instruction::print(ss, x, ins_names);
             ins_out[x] = ss.str();
         });
 
-        return generic_eval(*this,
-                            ctx,
-                            std::move(params),
-                            with_check_context([&](auto& ins, auto f, auto&& check_context) {
-                                ctx.finish();
-                                std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
-                                timer t{};
-                                auto result = check_context(f);
-                                double t1   = t.record<milliseconds>();
-                                ctx.finish();
-                                double t2 = t.record<milliseconds>();
-                                std::cout << "Time: " << t1 << "ms, " << t2 << "ms" << std::endl;
-                                if(trace_level > 1 and ins->name().front() != '@' and
-                                   ins->name() != "load" and not result.empty())
-                                {
-                                    target tgt  = make_target(this->impl->target_name);
-                                    auto buffer = tgt.copy_from(result);
-                                    if(trace_level == 2)
-                                    {
-                                        std::cout << "Output has "
-                                                  << to_string_range(classify_argument(buffer))
-                                                  << std::endl;
-                                        std::cout << "Output: ";
-                                        preview_argument(std::cout, buffer);
-                                        std::cout << std::endl;
-                                    }
-                                    else
-                                    {
-                                        std::cout << "Output: " << buffer << std::endl;
-                                    }
-                                }
-                                return result;
-                            }));
+        auto trace = with_check_context([&](auto& ins, auto f, auto&& check_context) {
+            ctx.finish();
+            std::cout << "Run instruction: " << ins_out.at(ins) << std::endl;
+            timer t{};
+            auto result = check_context(f);
+            double t1   = t.record<milliseconds>();
+            ctx.finish();
+            double t2 = t.record<milliseconds>();
+            std::cout << "Time: " << t1 << "ms, " << t2 << "ms" << std::endl;
+            if(trace_level > 1 and ins->name().front() != '@' and
+               ins->name() != "load" and not result.empty())
+            {
+                auto buffer = tgt.copy_from(result);
+                if(trace_level == 2)
+                {
+                    std::cout << "Output has " << to_string_range(classify_argument(buffer))
+                              << std::endl;
+                    std::cout << "Output: ";
+                    preview_argument(std::cout, buffer);
+                    std::cout << std::endl;
+                }
+                else
+                {
+                    std::cout << "Output: " << buffer << std::endl;
+                }
+            }
+            return result;
+        });
+        return run(trace, false);
+    }
+    else if(auto* tl = get_timeline())
+    {
+        auto m = make_timeline_marker(*tl);
+        m.mark_start(p);
+        auto trace = with_check_context([&](auto& ins, auto f, auto&& check_context) {
+            m.mark_start(ins);
+            auto r = check_context(f);
+            m.mark_stop(ins);
+            return r;
+        });
+        auto result = run(trace, false);
+        m.mark_stop(p);
+        return result;
     }
     else
     {
-        return generic_eval(*this,
-                            ctx,
-                            std::move(params),
-                            with_check_context([&](auto&, auto f, auto&& check_context) {
-                                return check_context(f);
-                            }));
+        auto trace = with_check_context(
+            [&](auto&, auto f, auto&& check_context) { return check_context(f); });
+        // Only an eval without a trace runs submodules at the same time
+        return run(trace, true);
+    }
+}
+
+std::vector<argument> program::eval(parameter_map params) const
+{
+    std::vector<instruction_ref> outputs;
+    for(auto ins : iterator_for(*this->get_main_module()))
+    {
+        if(ins->name() != "@param")
+            continue;
+        auto name = parameter_name(ins);
+        if(is_output_parameter(name) and not contains(params, name))
+            outputs.push_back(ins);
     }
+    std::unordered_map<instruction_ref, argument> results;
+    allocate_outputs(*this->impl, outputs, results);
+    return eval_with_trace(
+        *this, this->impl->ctx, this->impl->compiled_target, [&](auto make_trace, bool parallel) {
+            return generic_eval(*this,
+                                this->impl->ctx,
+                                std::move(params),
+                                std::move(results),
+                                make_trace,
+                                parallel);
+        });
+}
+
+std::vector<argument> program::eval(const parameter_binding& binding) const
+{
+    if(binding.mod != this->get_main_module())
+        MIGRAPHX_THROW("The parameters are bound to a different program");
+    auto results = binding.arguments;
+    allocate_outputs(*this->impl, binding.unbound_outputs, results);
+    return eval_with_trace(
+        *this, this->impl->ctx, this->impl->compiled_target, [&](auto make_trace, bool parallel) {
+            return generic_eval(
+                *this, this->impl->ctx, {}, std::move(results), make_trace, parallel);
+        });
 }
 
 const int program_file_version = 5;
 
 value program::to_value() const
+{
+    return this->to_value([](const literal& l) { return migraphx::to_value(l); });
+}
+
+value program::to_value(const std::function<value(const literal&)>& write_literal) const
 {
     value result;
     result["version"] = program_file_version;
@@ -431,7 +566,7 @@ value program::to_value() const
                 node["shape"]      = migraphx::to_value(ins->get_shape());
                 node["normalized"] = ins->is_normalized();
                 if(ins->name() == "@literal")
-                    node["literal"] = migraphx::to_value(ins->get_literal());
+                    node["literal"] = write_literal(ins->get_literal());
                 node["operator"] = ins->get_operator().to_value();
                 std::vector<std::string> inputs;
                 std::transform(ins->inputs().begin(),
@@ -469,7 +604,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& read_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -486,7 +622,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output = mod->add_literal(migraphx::from_value<literal>(node.at("literal")));
+            output = mod->add_literal(read_literal(node.at("literal")));
         }
         else
         {
@@ -511,7 +647,7 @@ static void mod_from_val(module_ref mod,
 
                 for(auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, read_literal);
                 }
             }
 
@@ -534,6 +670,11 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& lv) { return migraphx::from_value<literal>(lv); });
+}
+
+void program::from_value(const value& v, const std::function<literal(const value&)>& read_literal)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -544,8 +685,9 @@ void program::from_value(const value& v)
     this->impl->target_name = v.at("target").to<std::string>();
     if(not this->impl->target_name.empty())
     {
-        target t        = make_target(this->impl->target_name);
-        this->impl->ctx = t.get_context();
+        target t                    = make_target(this->impl->target_name);
+        this->impl->compiled_target = t;
+        this->impl->ctx             = t.get_context();
         this->impl->ctx.from_value(v.at("context"));
     }
 
@@ -565,7 +707,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, read_literal);
 
     this->finalize();
 }
@@ -615,6 +757,10 @@ void program::perf_report(std::ostream& os,
     // Run and time entire program
     std::vector<double> total_vec;
     total_vec.reserve(n);
+    auto* pool = get_argument_pool();
+    argument_pool_stats start_stats;
+    if(pool != nullptr)
+        start_stats = pool->stats();
     for(std::size_t i = 0; i < n; i++)
     {
         total_vec.push_back(time<milliseconds>([&] {
@@ -622,6 +768,9 @@ void program::perf_report(std::ostream& os,
             ctx.finish();
         }));
     }
+    argument_pool_stats end_stats;
+    if(pool != nullptr)
+        end_stats = pool->stats();
     std::sort(total_vec.begin(), total_vec.end());
     std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
     // Fill the map
@@ -635,10 +784,11 @@ void program::perf_report(std::ostream& os,
     {
         generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
             argument result;
-            ins_vec[ins].push_back(time<milliseconds>([&] {
+            auto t = time<milliseconds>([&] {
                 result = f();
                 ctx.finish();
-            }));
+            });
+            ins_vec[ins].push_back(t);
             return result;
         }));
     }
@@ -707,6 +857,17 @@ void program::perf_report(std::ostream& os,
        << ", " << calculate_overhead_time << "ms" << std::endl;
     os << "Overhead: " << std::round(overhead_percent) << "%"
        << ", " << std::round(calculate_overhead_percent) << "%" << std::endl;
+    if(pool != nullptr and n > 0)
+    {
+        auto allocations = end_stats.allocations - start_stats.allocations;
+        auto reused      = end_stats.reused - start_stats.reused;
+        double mib       = (end_stats.bytes - start_stats.bytes) / (1024.0 * 1024.0);
+        os << "Allocations per run: " << allocations / n << ", " << mib / n << "MiB"
+           << ", " << (allocations == 0 ? 0 : std::round(100.0 * reused / allocations))
+           << "% reused" << std::endl;
+        os << "Cached buffers: " << end_stats.cached_bytes / (1024.0 * 1024.0) << "MiB"
+           << std::endl;
+    }
 }
 
 void program::debug_print() const { std::cout << *this << std::endl; }
@@ -4,11 +4,23 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <deque>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PROPAGATE_CONSTANT_CACHE)
+
 bool skip_propogate(instruction_ref ins)
 {
     if(ins->name() == "contiguous")
@@ -23,6 +35,156 @@ bool skip_propogate(instruction_ref ins)
 
 bool is_const(instruction_ref ins) { return ins->can_eval() and not skip_propogate(ins); }
 
+// Copies one row at a time, instead of computing the index of every element
+// like the reference contiguous does
+static argument fold_contiguous(const shape& output_shape, const argument& input, bool parallel)
+{
+    argument result{output_shape};
+    if(output_shape.elements() == 0)
+        return result;
+    const auto& s = input.get_shape();
+    auto n        = output_shape.lens().back();
+    auto stride   = s.strides().back();
+    auto rows     = output_shape.elements() / n;
+    visit_all(result, input)([&](auto output, auto x) {
+        auto grain = parallel ? std::max<std::size_t>(1, 65536 / n) : rows;
+        par_for(rows, grain, [&](auto r) {
+            const auto* in = x.data() + s.index(r * n);
+            auto* out      = output.data() + r * n;
+            for(std::size_t j = 0; j < n; j++)
+                out[j] = in[j * stride];
+        });
+    });
+    return result;
+}
+
+static argument fold(instruction_ref ins, const std::vector<argument>& args, bool parallel)
+{
+    if(ins->name() == "contiguous" and ins->get_shape().standard())
+        return fold_contiguous(ins->get_shape(), args.front(), parallel);
+    return ins->normalized_operator().compute(ins->get_shape(), args);
+}
+
+// A literal that shares the buffer of the argument instead of copying it
+static literal to_literal(const argument& a)
+{
+    auto holder = std::make_shared<argument>(a);
+    return literal{a.get_shape(), std::shared_ptr<char>(holder, a.data())};
+}
+
+static std::vector<instruction_ref> unique(const std::vector<instruction_ref>& instructions)
+{
+    std::vector<instruction_ref> result;
+    for(auto ins : instructions)
+    {
+        if(not contains(result, ins))
+            result.push_back(ins);
+    }
+    return result;
+}
+
+// The non-literal instructions that the roots are computed from, including
+// the roots, in the order of the module
+static std::vector<instruction_ref> get_ancestors(module& m,
+                                                  const std::vector<instruction_ref>& roots)
+{
+    std::unordered_set<instruction_ref> visited;
+    std::vector<instruction_ref> stack{roots};
+    while(not stack.empty())
+    {
+        auto ins = stack.back();
+        stack.pop_back();
+        if(ins->name() == "@literal" or not visited.insert(ins).second)
+            continue;
+        stack.insert(stack.end(), ins->inputs().begin(), ins->inputs().end());
+    }
+    std::vector<instruction_ref> result;
+    for(auto ins : iterator_for(m))
+    {
+        if(contains(visited, ins))
+            result.push_back(ins);
+    }
+    return result;
+}
+
+// Stores the folded literals under a hash of the instructions they are
+// computed from, including the data of the literals they use
+struct constant_cache
+{
+    fs::path dir;
+    std::unordered_map<instruction_ref, std::string> keys;
+    std::unordered_map<instruction_ref, std::string> descriptions;
+
+    bool enabled() const { return not dir.empty(); }
+
+    // The inputs have to be added first, except for literals
+    void add(instruction_ref ins)
+    {
+        std::stringstream ss;
+        ss << ins->get_operator() << " " << ins->get_shape();
+        if(ins->name() == "@literal")
+        {
+            auto a = ins->get_literal().get_argument();
+            ss << " " << std::hash<std::string_view>{}(
+                             std::string_view{a.data(), a.get_shape().bytes()});
+        }
+        for(auto input : ins->inputs())
+        {
+            if(not contains(keys, input))
+                add(input);
+            ss << " " << keys.at(input);
+        }
+        std::stringstream key;
+        key << std::hex << std::hash<std::string>{}(ss.str());
+        keys[ins]         = key.str();
+        descriptions[ins] = ss.str();
+    }
+
+    fs::path data_file(instruction_ref ins) const { return dir / (keys.at(ins) + ".bin"); }
+    fs::path description_file(instruction_ref ins) const
+    {
+        return dir / (keys.at(ins) + ".txt");
+    }
+
+    // The description is kept next to the data to detect hash collisions
+    bool load(instruction_ref ins, argument& result) const
+    {
+        auto data = data_file(ins);
+        auto desc = description_file(ins);
+        if(not fs::exists(data) or not fs::exists(desc) or
+           read_string(desc.string()) != descriptions.at(ins))
+            return false;
+        auto buffer = std::make_shared<std::vector<char>>(read_buffer(data.string()));
+        if(buffer->size() != ins->get_shape().bytes())
+            return false;
+        result = argument{ins->get_shape(), std::shared_ptr<char>(buffer, buffer->data())};
+        return true;
+    }
+
+    void store(instruction_ref ins, const argument& a) const
+    {
+        try
+        {
+            fs::create_directories(dir);
+            write_file(data_file(ins), a.data(), a.get_shape().bytes());
+            const auto& desc = descriptions.at(ins);
+            write_file(description_file(ins), desc.data(), desc.size());
+        }
+        catch(const std::exception&)
+        {
+            // Folding still works when the cache is not writable
+        }
+    }
+
+    // Write to a temporary file first, so other processes never load a partial file
+    static void write_file(const fs::path& p, const char* buffer, std::size_t size)
+    {
+        auto tmp = p.parent_path() / unique_string(p.filename().string());
+        write_buffer(tmp.string(), buffer, size);
+        fs::rename(tmp, p);
+    }
+};
+
 void propagate_constant::apply(module& m) const
 {
     std::unordered_set<instruction_ref> const_instrs;
@@ -40,22 +202,119 @@ void propagate_constant::apply(module& m) const
             std::inserter(const_instrs, const_instrs.begin()),
             [&](const instruction_ref ins) { return is_const(ins) and ins->name() != "@literal"; });
     }
+    if(const_instrs.empty())
+        return;
 
-    // Compute literals in parallel
-    std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
-    std::vector<argument> literals(const_instrs_vec.size());
-    par_for(const_instrs_vec.size(), 1, [&](const auto i) {
-        literals[i] = const_instrs_vec[i]->eval();
-    });
+    auto replace = [&](instruction_ref ins, const argument& a) {
+        assert(a.get_shape() == ins->get_shape());
+        m.replace_instruction(ins, m.add_literal(to_literal(a)));
+    };
+
+    constant_cache cache;
+    cache.dir = cache_dir.empty() ? string_value_of(MIGRAPHX_PROPAGATE_CONSTANT_CACHE{})
+                                  : cache_dir;
+    std::vector<instruction_ref> roots;
+    for(auto ins : get_ancestors(m, {const_instrs.begin(), const_instrs.end()}))
+    {
+        // Add all the keys before any root is replaced by a cached literal
+        if(cache.enabled())
+            cache.add(ins);
+        if(contains(const_instrs, ins))
+            roots.push_back(ins);
+    }
+    if(cache.enabled())
+    {
+        roots.erase(std::remove_if(roots.begin(),
+                                   roots.end(),
+                                   [&](auto ins) {
+                                       argument a;
+                                       if(not cache.load(ins, a))
+                                           return false;
+                                       replace(ins, a);
+                                       return true;
+                                   }),
+                    roots.end());
+    }
+    auto order = get_ancestors(m, roots);
+    std::unordered_set<instruction_ref> needed{order.begin(), order.end()};
+
+    // Count the inputs that still have to be evaluated, and the uses of each
+    // result, so it can be freed after its last use
+    std::unordered_map<instruction_ref, std::size_t> pending;
+    std::unordered_map<instruction_ref, std::size_t> uses;
+    std::deque<instruction_ref> ready;
+    for(auto ins : order)
+    {
+        for(auto input : unique(ins->inputs()))
+        {
+            if(not contains(needed, input))
+                continue;
+            pending[ins]++;
+            uses[input]++;
+        }
+        if(pending[ins] == 0)
+            ready.push_back(ins);
+    }
 
-    // Replace instructions in m
-    for(size_t i = 0; i < const_instrs_vec.size(); i++)
+    std::unordered_map<instruction_ref, argument> results;
+    std::size_t live = 0;
+    auto get_argument = [&](instruction_ref input) {
+        if(input->name() == "@literal")
+            return input->get_literal().get_argument();
+        return results.at(input);
+    };
+    // Evaluate the ready instructions in waves, as many at once as fit in the budget
+    while(not ready.empty())
     {
-        if(not literals[i].empty())
+        std::vector<instruction_ref> wave;
+        std::size_t wave_bytes = 0;
+        while(not ready.empty())
+        {
+            auto bytes = ready.front()->get_shape().bytes();
+            if(not wave.empty() and live + wave_bytes + bytes > memory_budget)
+                break;
+            wave_bytes += bytes;
+            wave.push_back(ready.front());
+            ready.pop_front();
+        }
+        std::vector<argument> outputs(wave.size());
+        par_for(wave.size(), 1, [&](const auto i) {
+            auto ins = wave[i];
+            std::vector<argument> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           get_argument);
+            outputs[i] = fold(ins, args, wave.size() == 1);
+        });
+        for(std::size_t i = 0; i < wave.size(); i++)
         {
-            assert(literals[i].get_shape() == const_instrs_vec[i]->get_shape());
-            auto l = m.add_literal(literals[i].get_shape(), literals[i].data());
-            m.replace_instruction(const_instrs_vec[i], l);
+            auto ins    = wave[i];
+            auto inputs = unique(ins->inputs());
+            for(auto output : unique(ins->outputs()))
+            {
+                if(contains(needed, output) and --pending[output] == 0)
+                    ready.push_back(output);
+            }
+            if(contains(const_instrs, ins))
+            {
+                replace(ins, outputs[i]);
+                if(cache.enabled())
+                    cache.store(ins, outputs[i]);
+            }
+            else
+            {
+                results[ins] = outputs[i];
+                live += ins->get_shape().bytes();
+            }
+            for(auto input : inputs)
+            {
+                if(not contains(needed, input) or --uses[input] > 0)
+                    continue;
+                results.erase(input);
+                if(not contains(const_instrs, input))
+                    live -= input->get_shape().bytes();
+            }
         }
     }
 }
@@ -17,6 +17,7 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/executor.hpp>
 
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
@@ -210,6 +211,60 @@ migraphx::shape to_shape(const py::buffer_info& info)
     }
 }
 
+migraphx::parameter_map to_parameter_map(const py::dict& params)
+{
+    migraphx::parameter_map pm;
+    for(auto x : params)
+    {
+        std::string key      = x.first.cast<std::string>();
+        py::buffer b         = x.second.cast<py::buffer>();
+        py::buffer_info info = b.request();
+        pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+    }
+    return pm;
+}
+
+// The executor joins its workers when it is destroyed, and the workers need
+// the GIL to finish the callbacks, so it is released here
+struct executor_deleter
+{
+    void operator()(migraphx::executor* e) const
+    {
+        py::gil_scoped_release nogil;
+        delete e;
+    }
+};
+
+// Python objects that have to live until an async run is done
+struct async_run
+{
+    py::object loop;
+    py::object future;
+    py::dict params;
+};
+
+void set_async_result(const py::object& future,
+                      const std::vector<migraphx::argument>& results,
+                      const std::exception_ptr& error)
+{
+    if(future.attr("cancelled")().cast<bool>())
+        return;
+    if(not error)
+    {
+        future.attr("set_result")(py::cast(results));
+        return;
+    }
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch(const std::exception& e)
+    {
+        future.attr("set_exception")(
+            py::module::import("builtins").attr("RuntimeError")(std::string(e.what())));
+    }
+}
+
 MIGRAPHX_PYBIND11_MODULE(migraphx, m)
 {
     py::class_<migraphx::shape>(m, "shape")
@@ -296,6 +351,8 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             py::arg("args"))
         .def("__repr__", [](const migraphx::module& mm) { return migraphx::to_string(mm); });
 
+    py::class_<migraphx::parameter_binding>(m, "parameter_binding");
+
     py::class_<migraphx::program>(m, "program")
         .def(py::init([]() { return migraphx::program(); }))
         .def("get_parameter_names", &migraphx::program::get_parameter_names)
@@ -318,23 +375,64 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             [](migraphx::program& p, const std::string& name) { return p.create_module(name); },
             py::arg("name"))
         .def("run",
-             [](migraphx::program& p, py::dict params) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 return p.eval(pm);
+             [](migraphx::program& p, const py::dict& params) {
+                 return p.eval(to_parameter_map(params));
              })
+        .def("run",
+             [](migraphx::program& p, const migraphx::parameter_binding& binding) {
+                 return p.eval(binding);
+             })
+        .def(
+            "bind",
+            [](migraphx::program& p, const py::dict& params) {
+                return migraphx::parameter_binding{p, to_parameter_map(params)};
+            },
+            py::arg("params"),
+            py::keep_alive<0, 1>(),
+            py::keep_alive<0, 2>())
         .def("sort", &migraphx::program::sort)
         .def("print", [](const migraphx::program& p) { std::cout << p << std::endl; })
         .def("__eq__", std::equal_to<migraphx::program>{})
         .def("__ne__", std::not_equal_to<migraphx::program>{})
         .def("__repr__", [](const migraphx::program& p) { return migraphx::to_string(p); });
 
+    py::class_<migraphx::executor, std::unique_ptr<migraphx::executor, executor_deleter>>(
+        m, "executor")
+        .def(py::init<const migraphx::program&, std::size_t>(),
+             py::arg("p"),
+             py::arg("workers") = 1)
+        .def("pending", &migraphx::executor::pending)
+        .def("workers", &migraphx::executor::workers)
+        .def(
+            "run_async",
+            [](migraphx::executor& e, const py::dict& params) {
+                auto loop   = py::module::import("asyncio").attr("get_event_loop")();
+                auto future = loop.attr("create_future")();
+                auto run    = std::make_unique<async_run>(async_run{loop, future, params});
+                auto* r     = run.get();
+                e.eval_async(to_parameter_map(params),
+                             [r](std::vector<migraphx::argument> results,
+                                 std::exception_ptr error) {
+                                 py::gil_scoped_acquire gil;
+                                 std::unique_ptr<async_run> done{r};
+                                 auto set = py::cpp_function(
+                                     [future = done->future, results, error] {
+                                         set_async_result(future, results, error);
+                                     });
+                                 try
+                                 {
+                                     done->loop.attr("call_soon_threadsafe")(set);
+                                 }
+                                 catch(const py::error_already_set&)
+                                 {
+                                     // The loop was closed before the run finished
+                                 }
+                             });
+                run.release();
+                return future;
+            },
+            py::arg("params"));
+
     py::class_<migraphx::operation>(m, "op")
         .def(py::init([](const std::string& name, py::kwargs kwargs) {
             migraphx::value v = migraphx::value::object{};
@@ -445,6 +543,11 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
           py::arg("t"),
           py::arg("calibration") = std::vector<migraphx::parameter_map>{},
           py::arg("ins_names")   = std::vector<std::string>{"dot", "convolution"});
+    m.def("quantize_weights",
+          &migraphx::quantize_weights,
+          py::arg("prog"),
+          py::arg("bits")       = 8,
+          py::arg("group_size") = 0);
 
 #ifdef HAVE_GPU
     m.def("allocate_gpu", &migraphx::gpu::allocate_gpu, py::arg("s"), py::arg("host") = false);
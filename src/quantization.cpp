@@ -3,6 +3,7 @@
 #include <migraphx/quantization.hpp>
 #include <migraphx/quantize_fp16.hpp>
 #include <migraphx/quantize_int8.hpp>
+#include <migraphx/quantize_weights.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/eliminate_common_subexpression.hpp>
@@ -134,5 +135,10 @@ void quantize_int8(program& prog,
                 dead_code_elimination{}});
 }
 
+void quantize_weights(program& prog, std::size_t bits, std::size_t group_size)
+{
+    run_passes(prog, {quantize_weights_pass{bits, group_size}, dead_code_elimination{}});
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
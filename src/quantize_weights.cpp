@@ -0,0 +1,71 @@
+#include <migraphx/quantize_weights.hpp>
+#include <migraphx/dot_weights.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/make_op.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+void quantize_weights_pass::apply(module& m) const
+{
+    if(bits != 4 and bits != 8)
+        MIGRAPHX_THROW("QUANTIZE_WEIGHTS: only 4 and 8 bit weights are supported");
+    const float qmax = bits == 8 ? 127 : 7;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "dot")
+            continue;
+        auto a = ins->inputs()[0];
+        auto w = get_dot_weights(ins->inputs()[1]);
+        if(w->get_shape().lens().size() != 2 or not is_float(a->get_shape()) or
+           not is_float(w->get_shape()) or not w->can_eval())
+            continue;
+        auto k     = w->get_shape().lens()[0];
+        auto n     = w->get_shape().lens()[1];
+        auto group = group_size == 0 ? k : group_size;
+        if(k % group != 0 or k % (8 / bits) != 0)
+            continue;
+        auto row = k * bits / 8;
+        std::vector<std::int8_t> q(n * row);
+        std::vector<float> scales(n * (k / group));
+        w->eval().visit([&](auto weights) {
+            for(std::size_t j = 0; j < n; j++)
+            {
+                for(std::size_t g = 0; g < k / group; g++)
+                {
+                    float max_abs = 0;
+                    for(std::size_t i = g * group; i < (g + 1) * group; i++)
+                        max_abs = std::max<float>(max_abs, std::fabs(float(weights(i, j))));
+                    // if all values are 0, no need to do scaling
+                    float scale                 = max_abs == 0 ? 1 : max_abs / qmax;
+                    scales[j * (k / group) + g] = scale;
+                    for(std::size_t i = g * group; i < (g + 1) * group; i++)
+                    {
+                        auto x = std::round(float(weights(i, j)) / scale);
+                        auto y = static_cast<std::int8_t>(std::min(std::max(x, -qmax), qmax));
+                        if(bits == 8)
+                            q[j * row + i] = y;
+                        else if(i % 2 == 0)
+                            q[j * row + i / 2] = static_cast<std::int8_t>(y & 0x0f);
+                        else
+                            q[j * row + i / 2] |= static_cast<std::int8_t>(y * 16);
+                    }
+                }
+            }
+        });
+        auto qw = m.add_literal(literal{shape{shape::int8_type, {n, row}}, q});
+        auto qs = m.add_literal(literal{shape{a->get_shape().type(), {n, k / group}}, scales});
+        m.replace_instruction(
+            ins, make_op("weight_dot", {{"bits", bits}, {"group_size", group}}), a, qw, qs);
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
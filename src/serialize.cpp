@@ -13,6 +13,9 @@ void raw_data_to_value(value& v, const RawData& rd)
     result["shape"] = migraphx::to_value(rd.get_shape());
     if(rd.get_shape().type() == shape::tuple_type)
         result["sub"] = migraphx::to_value(rd.get_sub_objects());
+    // The attribute of an op that is default constructed, such as by make_op
+    else if(rd.empty())
+        result["data"] = migraphx::value::binary{};
     else
         result["data"] = migraphx::value::binary(rd.data(), rd.get_shape().bytes());
     v = result;
@@ -21,8 +24,12 @@ void raw_data_to_value(value& v, const RawData& rd)
 void migraphx_to_value(value& v, const literal& l) { raw_data_to_value(v, l); }
 void migraphx_from_value(const value& v, literal& l)
 {
-    auto s = migraphx::from_value<shape>(v.at("shape"));
-    l      = literal(s, v.at("data").get_binary().data());
+    auto s           = migraphx::from_value<shape>(v.at("shape"));
+    const auto& data = v.at("data").get_binary();
+    if(data.empty() and s.bytes() > 0)
+        l = literal{};
+    else
+        l = literal(s, data.data());
 }
 
 void migraphx_to_value(value& v, const argument& a) { raw_data_to_value(v, a); }
@@ -31,7 +38,7 @@ void migraphx_from_value(const value& v, argument& a)
     if(v.contains("data"))
     {
         literal l = migraphx::from_value<literal>(v);
-        a         = l.get_argument();
+        a         = l.empty() ? argument{} : l.get_argument();
     }
     else
     {
@@ -20,11 +20,30 @@ struct shape_impl
         return result;
     }
 
-    shape_impl() : m_type(shape::float_type) {}
+    // Scalars are created for every type over and over, so share one per type
+    static std::shared_ptr<shape_impl> scalar_shape(shape::type_t t)
+    {
+        static const std::vector<std::shared_ptr<shape_impl>> result = [] {
+            std::vector<std::shared_ptr<shape_impl>> r;
+            for(auto st : shape::types())
+            {
+                if(st == shape::tuple_type)
+                    r.push_back(nullptr);
+                else
+                    r.push_back(std::make_shared<shape_impl>(st));
+            }
+            return r;
+        }();
+        assert(t != shape::tuple_type);
+        return result.at(t);
+    }
+
+    shape_impl() : m_type(shape::float_type) { this->calculate_properties(); }
 
     shape_impl(shape::type_t t) : m_type(t), m_lens({1}), m_strides({0}), m_standard(true)
     {
         assert(t != shape::tuple_type);
+        this->calculate_properties();
     }
     shape_impl(shape::type_t t, std::vector<std::size_t> l)
         : m_type(t), m_lens(std::move(l)), m_standard(true)
@@ -32,6 +51,7 @@ struct shape_impl
         assert(t != shape::tuple_type);
         this->calculate_strides();
         assert(m_lens.size() == m_strides.size());
+        this->calculate_properties();
     }
     shape_impl(shape::type_t t, std::vector<std::size_t> l, std::vector<std::size_t> s)
         : m_type(t), m_lens(std::move(l)), m_strides(std::move(s))
@@ -40,17 +60,32 @@ struct shape_impl
         assert(m_lens.size() == m_strides.size());
         // assert(std::any_of(m_strides.begin(), m_strides.end(), [](auto x) { return x > 0; }) and
         //        "At least one stride must be non-zero");
-        m_standard = this->elements() == this->element_space() and
+        this->calculate_properties();
+        m_standard = m_elements == m_element_space and
                      std::is_sorted(m_strides.rbegin(), m_strides.rend());
     }
 
-    shape_impl(const std::vector<shape>& subs) : m_type(shape::tuple_type), m_shapes(subs) {}
+    shape_impl(const std::vector<shape>& subs) : m_type(shape::tuple_type), m_shapes(subs)
+    {
+        this->calculate_properties();
+    }
     shape::type_t m_type;
     std::vector<std::size_t> m_lens    = {};
     std::vector<std::size_t> m_strides = {};
     std::vector<shape> m_shapes        = {};
     bool m_standard                    = false;
 
+    // The properties below only depend on the members above, and are
+    // computed once since shapes are immutable
+    std::size_t m_elements      = 0;
+    std::size_t m_element_space = 0;
+    std::size_t m_type_size     = 0;
+    std::size_t m_bytes         = 0;
+    bool m_packed               = false;
+    bool m_transposed           = false;
+    bool m_broadcasted          = false;
+    bool m_scalar               = false;
+
     void calculate_strides()
     {
         m_strides.clear();
@@ -64,6 +99,39 @@ struct shape_impl
                          std::multiplies<std::size_t>());
     }
 
+    void calculate_properties()
+    {
+        m_elements      = this->elements();
+        m_element_space = this->element_space();
+        if(m_type != shape::tuple_type)
+        {
+            shape::visit(m_type, [&](auto as) { m_type_size = as.size(); });
+            m_bytes = m_type_size * m_element_space;
+        }
+        else
+        {
+            m_bytes = std::accumulate(m_shapes.begin(),
+                                      m_shapes.end(),
+                                      std::size_t{0},
+                                      [&](auto x, const auto& y) { return x + y.bytes(); });
+        }
+        m_packed      = m_shapes.empty() and m_elements == m_element_space;
+        m_broadcasted = std::any_of(m_strides.begin(), m_strides.end(), [](auto x) {
+            return x == 0;
+        });
+        // Broadcasted dimensions do not affect whether the shape is transposed
+        std::size_t last = 0;
+        m_transposed     = std::any_of(m_strides.rbegin(), m_strides.rend(), [&](auto x) {
+            if(x == 0)
+                return false;
+            bool result = x < last;
+            last        = x;
+            return result;
+        });
+        m_scalar = m_shapes.empty() and
+                   std::all_of(m_strides.begin(), m_strides.end(), [](auto x) { return x == 0; });
+    }
+
     std::size_t element_space() const
     {
         assert(m_lens.size() == m_strides.size());
@@ -125,7 +193,7 @@ std::string shape::cpp_type(shape::type_t t)
 
 shape::shape() : impl(shape_impl::default_shape()) {}
 
-shape::shape(type_t t) : impl(std::make_shared<shape_impl>(t)) {}
+shape::shape(type_t t) : impl(shape_impl::scalar_shape(t)) {}
 shape::shape(type_t t, std::vector<std::size_t> l)
     : impl(std::make_shared<shape_impl>(t, std::move(l)))
 {
@@ -152,30 +220,9 @@ shape shape::from_permutation(type_t t,
 shape::type_t shape::type() const { return impl->m_type; }
 const std::vector<std::size_t>& shape::lens() const { return impl->m_lens; }
 const std::vector<std::size_t>& shape::strides() const { return impl->m_strides; }
-std::size_t shape::elements() const { return impl->elements(); }
-std::size_t shape::bytes() const
-{
-    if(this->sub_shapes().empty())
-    {
-        std::size_t n = 0;
-        this->visit_type([&](auto as) { n = as.size(); });
-        return n * this->element_space();
-    }
-    else
-    {
-        return std::accumulate(this->sub_shapes().begin(),
-                               this->sub_shapes().end(),
-                               std::size_t{0},
-                               [&](auto x, auto y) { return x + y.bytes(); });
-    }
-}
-std::size_t shape::type_size() const
-{
-    std::size_t n = 0;
-    if(this->sub_shapes().empty())
-        this->visit_type([&](auto as) { n = as.size(); });
-    return n;
-}
+std::size_t shape::elements() const { return impl->m_elements; }
+std::size_t shape::bytes() const { return impl->m_bytes; }
+std::size_t shape::type_size() const { return impl->m_type_size; }
 std::size_t shape::index(std::initializer_list<std::size_t> l) const
 {
     assert(l.size() <= this->lens().size());
@@ -235,46 +282,13 @@ void shape::multi_copy(std::size_t i, std::size_t* start, const std::size_t* end
                    });
 }
 
-bool shape::packed() const
-{
-    return this->sub_shapes().empty() and this->elements() == this->element_space();
-}
+bool shape::packed() const { return impl->m_packed; }
 
-bool shape::transposed() const
-{
-    if(this->broadcasted())
-    {
-        // TODO: Use a filter_iterator instead
-        std::vector<std::size_t> s;
-        s.reserve(this->strides().size());
-        std::copy_if(this->strides().begin(),
-                     this->strides().end(),
-                     std::back_inserter(s),
-                     [](std::size_t x) { return x != 0; });
-        return not std::is_sorted(s.rbegin(), s.rend());
-    }
-    else
-    {
-        return not std::is_sorted(this->strides().rbegin(), this->strides().rend());
-    }
-}
+bool shape::transposed() const { return impl->m_transposed; }
 
-bool shape::broadcasted() const
-{
-    assert(this->lens().size() == this->strides().size());
-    return std::accumulate(this->strides().begin(),
-                           this->strides().end(),
-                           std::size_t{1},
-                           std::multiplies<std::size_t>()) == 0;
-}
+bool shape::broadcasted() const { return impl->m_broadcasted; }
 
-bool shape::scalar() const
-{
-    assert(this->lens().size() == this->strides().size());
-    // if any stride > 0, then accumulate will return false
-    return this->sub_shapes().empty() and
-           std::accumulate(this->strides().begin(), this->strides().end(), std::size_t(0)) == 0;
-}
+bool shape::scalar() const { return impl->m_scalar; }
 
 bool shape::standard() const { return impl->m_standard; }
 
@@ -300,19 +314,25 @@ shape shape::with_lens(const std::vector<std::size_t>& l) const
 
 shape shape::with_type(type_t t) const
 {
+    if(t == this->type())
+        return *this;
     auto c    = impl->copy();
     c->m_type = t;
+    c->calculate_properties();
     return {c};
 }
 
-std::size_t shape::element_space() const { return impl->element_space(); }
+std::size_t shape::element_space() const { return impl->m_element_space; }
 
 std::string shape::type_string() const { return name(this->type()); }
 
 bool operator==(const shape& x, const shape& y)
 {
-    return x.impl == y.impl or (x.type() == y.type() and x.lens() == y.lens() and
-                                x.strides() == y.strides() and x.sub_shapes() == y.sub_shapes());
+    // Compare the cached properties first, which are cheaper than the dimensions
+    return x.impl == y.impl or
+           (x.type() == y.type() and x.elements() == y.elements() and x.bytes() == y.bytes() and
+            x.lens() == y.lens() and x.strides() == y.strides() and
+            x.sub_shapes() == y.sub_shapes());
 }
 bool operator!=(const shape& x, const shape& y) { return !(x == y); }
 
@@ -0,0 +1,197 @@
+#include <migraphx/sparsify_weights.hpp>
+#include <migraphx/dot_weights.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/op/convolution.hpp>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Calls f with the row and column of each block of the {n, k} weights that
+// has a nonzero value
+template <class F>
+static void for_each_nonzero_block(const argument& weights,
+                                   std::size_t block_rows,
+                                   std::size_t block_cols,
+                                   F f)
+{
+    auto n = weights.get_shape().lens()[0];
+    auto k = weights.get_shape().lens()[1];
+    weights.visit([&](auto w) {
+        for(std::size_t r = 0; r < n; r += block_rows)
+        {
+            for(std::size_t c = 0; c < k; c += block_cols)
+            {
+                bool nonzero = false;
+                for(std::size_t i = r; i < std::min(n, r + block_rows) and not nonzero; i++)
+                {
+                    for(std::size_t j = c; j < std::min(k, c + block_cols) and not nonzero; j++)
+                        nonzero = w(i, j) != 0;
+                }
+                if(nonzero)
+                    f(r / block_rows, c / block_cols);
+            }
+        }
+    });
+}
+
+double block_sparsity(const argument& weights, std::size_t block_rows, std::size_t block_cols)
+{
+    const auto& lens = weights.get_shape().lens();
+    if(lens.size() != 2)
+        MIGRAPHX_THROW("BLOCK_SPARSITY: weights must be 2 dims");
+    auto blocks = ((lens[0] + block_rows - 1) / block_rows) *
+                  ((lens[1] + block_cols - 1) / block_cols);
+    if(blocks == 0)
+        return 0;
+    std::size_t nonzero = 0;
+    for_each_nonzero_block(weights, block_rows, block_cols, [&](auto, auto) { nonzero++; });
+    return 1.0 - double(nonzero) / blocks;
+}
+
+// Adds the values, indices and offsets of the block sparse rows of the {n, k}
+// weights as literals
+static std::vector<instruction_ref> add_block_sparse_rows(module& m,
+                                                          const argument& weights,
+                                                          shape::type_t type,
+                                                          std::size_t block_rows,
+                                                          std::size_t block_cols)
+{
+    auto blocks = weights.get_shape().lens()[0] / block_rows;
+    std::vector<float> values;
+    std::vector<std::int32_t> indices;
+    std::vector<std::int32_t> offsets(blocks + 1, 0);
+    weights.visit([&](auto w) {
+        for_each_nonzero_block(weights, block_rows, block_cols, [&](auto r, auto c) {
+            for(std::size_t i = 0; i < block_rows; i++)
+            {
+                for(std::size_t j = 0; j < block_cols; j++)
+                    values.push_back(w(r * block_rows + i, c * block_cols + j));
+            }
+            indices.push_back(c);
+            offsets[r + 1]++;
+        });
+    });
+    // Keep one block of zeros when all the weights are zero, so the values
+    // are never empty
+    if(indices.empty())
+    {
+        values.resize(block_rows * block_cols);
+        indices.push_back(0);
+        offsets[1] = 1;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    shape vs{type, {indices.size(), block_rows, block_cols}};
+    return {m.add_literal(literal{vs, values}),
+            m.add_literal(literal{shape{shape::int32_type, {indices.size()}}, indices}),
+            m.add_literal(literal{shape{shape::int32_type, {offsets.size()}}, offsets})};
+}
+
+void sparsify_weights::apply(module& m) const
+{
+    auto is_sparse = [&](const argument& w) {
+        const auto& lens = w.get_shape().lens();
+        return lens[0] % block_rows == 0 and lens[1] % block_cols == 0 and
+               block_sparsity(w, block_rows, block_cols) >= threshold;
+    };
+    auto sparse_dot =
+        make_op("sparse_dot", {{"block_rows", block_rows}, {"block_cols", block_cols}});
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() == "dot")
+        {
+            auto a = ins->inputs()[0];
+            auto w = get_dot_weights(ins->inputs()[1]);
+            if(w->get_shape().lens().size() != 2 or not is_float(a->get_shape()) or
+               not is_float(w->get_shape()) or not w->can_eval())
+                continue;
+            auto ws = w->get_shape();
+            // The transposed {n, k} weights
+            auto wt = w->eval().reshape(
+                {ws.type(), {ws.lens()[1], ws.lens()[0]}, {ws.strides()[1], ws.strides()[0]}});
+            if(not is_sparse(wt))
+                continue;
+            auto inputs =
+                add_block_sparse_rows(m, wt, a->get_shape().type(), block_rows, block_cols);
+            inputs.insert(inputs.begin(), a);
+            m.replace_instruction(ins, sparse_dot, inputs);
+        }
+        else if(ins->name() == "convolution")
+        {
+            auto x         = ins->inputs()[0];
+            auto w         = ins->inputs()[1];
+            auto conv      = any_cast<op::convolution>(ins->get_operator());
+            const auto& xs = x->get_shape();
+            const auto& ws = w->get_shape();
+            // im2col only handles 2D convolutions without groups or dilations,
+            // and with the same padding on both sides
+            const auto& pads = conv.padding;
+            if(xs.lens().size() != 4 or conv.group != 1 or
+               (pads.size() == 4 and (pads[0] != pads[2] or pads[1] != pads[3])) or
+               std::any_of(conv.dilation.begin(),
+                           conv.dilation.end(),
+                           [](auto d) { return d != 1; }) or
+               not is_float(xs) or not is_float(ws) or not w->can_eval())
+                continue;
+            auto lens   = ins->get_shape().lens();
+            auto o      = ws.lens()[0];
+            auto im2col = make_op("im2col",
+                                  {{"padding", {pads[0], pads[1]}},
+                                   {"stride", conv.stride},
+                                   {"dilation", conv.dilation}});
+            // im2col only uses the shape of the weights, so it gets a broadcast
+            // scalar instead of the dense weights
+            shape wshape{ws.type(), {1, ws.lens()[1], ws.lens()[2], ws.lens()[3]}, {0, 0, 0, 0}};
+            shape xshape{xs.type(), {1, xs.lens()[1], xs.lens()[2], xs.lens()[3]}};
+            auto cols_shape = try_compute_shape(im2col, {xshape, wshape});
+            if(cols_shape.empty() or cols_shape.front().lens()[0] != lens[2] * lens[3])
+                continue;
+            auto wa = w->eval();
+            if(not wa.get_shape().standard())
+                continue;
+            // The {o, c * kh * kw} weights, in the same order as the columns of im2col
+            auto wr = wa.reshape({ws.type(), {o, ws.elements() / o}});
+            if(not is_sparse(wr))
+                continue;
+            auto bsr  = add_block_sparse_rows(m, wr, xs.type(), block_rows, block_cols);
+            auto zero = m.insert_instruction(
+                ins,
+                make_op("multibroadcast", {{"out_lens", wshape.lens()}}),
+                m.add_literal(literal{shape{ws.type()}, {0}}));
+            std::vector<instruction_ref> outputs;
+            for(std::size_t b = 0; b < lens[0]; b++)
+            {
+                auto xb = x;
+                if(lens[0] > 1)
+                    xb = m.insert_instruction(
+                        ins,
+                        make_op("slice", {{"axes", {0}}, {"starts", {b}}, {"ends", {b + 1}}}),
+                        x);
+                auto cols = m.insert_instruction(ins, im2col, xb, zero);
+                auto y    = m.insert_instruction(ins, sparse_dot, cols, bsr[0], bsr[1], bsr[2]);
+                auto yt =
+                    m.insert_instruction(ins, make_op("transpose", {{"permutation", {1, 0}}}), y);
+                auto yc = m.insert_instruction(ins, make_op("contiguous"), yt);
+                outputs.push_back(m.insert_instruction(
+                    ins,
+                    make_op("reshape",
+                            {{"dims", std::vector<std::size_t>{1, o, lens[2], lens[3]}}}),
+                    yc));
+            }
+            if(outputs.size() == 1)
+                m.replace_instruction(ins, outputs.front());
+            else
+                m.replace_instruction(ins, make_op("concat", {{"axis", 0}}), outputs);
+        }
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
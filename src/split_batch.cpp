@@ -0,0 +1,359 @@
+#include <migraphx/split_batch.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+bool is_batch_module(const module& m) { return starts_with(m.name(), "main:batch"); }
+
+static bool is_broadcast(instruction_ref ins)
+{
+    return contains({"broadcast", "multibroadcast"}, ins->name());
+}
+
+// The first dimension that most of the parameters share, preferring the
+// larger one on a tie
+static std::size_t find_batch(const module& m)
+{
+    std::map<std::size_t, std::size_t> counts;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "@param" or ins->get_shape().lens().empty())
+            continue;
+        counts[ins->get_shape().lens().front()]++;
+    }
+    auto it = std::max_element(counts.begin(), counts.end(), [](const auto& x, const auto& y) {
+        return x.second < y.second or (x.second == y.second and x.first < y.first);
+    });
+    if(it == counts.end())
+        return 0;
+    return it->first;
+}
+
+struct batch_split
+{
+    module* m;
+    std::size_t batch;
+    // The parameters that hold the batch
+    std::unordered_set<instruction_ref> batch_params;
+    // The instructions whose first dimension is the batch
+    std::unordered_set<instruction_ref> batched{};
+
+    bool has_batch(instruction_ref ins) const
+    {
+        const auto& lens = ins->get_shape().lens();
+        return not lens.empty() and lens.front() == batch;
+    }
+
+    // Broadcasts to the batch, such as of a bias, are batched as well, so
+    // they are broadcast to the sub-batch
+    void find_batched()
+    {
+        for(auto ins : iterator_for(*m))
+        {
+            if(contains(batch_params, ins))
+                batched.insert(ins);
+            else if(is_broadcast(ins) and has_batch(ins))
+                batched.insert(ins);
+            else if(ins->name() != "@return" and
+                    std::any_of(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+                        return contains(batched, input);
+                    }))
+                batched.insert(ins);
+        }
+    }
+
+    // Whether the op combines the items of the batch, instead of computing
+    // each one on its own
+    bool mixes_batch(instruction_ref ins) const
+    {
+        if(ins->name() == "@param" or is_broadcast(ins))
+            return false;
+        if(std::none_of(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+               return contains(batched, input);
+           }))
+            return false;
+        auto v = ins->get_operator().to_value();
+        // The index values of these ops can address any item of the batch. The
+        // indices of gathernd only stay within an item when it has batch dims.
+        if(ins->name() == "gathernd")
+            return v.at("batch_dims").to<std::int64_t>() == 0;
+        if(contains({"scatternd_none",
+                     "scatternd_add",
+                     "scatternd_mul",
+                     "roialign",
+                     "nonmaxsuppression",
+                     "nonzero"},
+                    ins->name()))
+            return true;
+        auto rank = static_cast<std::int64_t>(ins->inputs().front()->get_shape().lens().size());
+        auto is_first_axis = [&](std::int64_t axis) { return axis == 0 or axis == -rank; };
+        if(v.contains("axis") and not v.at("axis").is_array() and
+           is_first_axis(v.at("axis").to<std::int64_t>()))
+            return true;
+        if(v.contains("axes"))
+        {
+            auto axes = v.at("axes").to_vector<std::int64_t>();
+            // No axes usually means all of them
+            if(axes.empty() or std::any_of(axes.begin(), axes.end(), is_first_axis))
+                return true;
+        }
+        if(ins->name() == "transpose" and
+           v.at("permutation").to_vector<std::int64_t>().front() != 0)
+            return true;
+        return false;
+    }
+
+    // The op of a batched instruction for a sub-batch of size n
+    operation sub_batch_op(instruction_ref ins, std::size_t n) const
+    {
+        auto op = ins->get_operator();
+        if(not contains(batched, ins))
+            return op;
+        auto v       = op.to_value();
+        bool changed = false;
+        for(const auto* key : {"dims", "out_lens"})
+        {
+            if(not v.contains(key))
+                continue;
+            auto dims = v.at(key).to_vector<std::int64_t>();
+            if(dims.empty() or dims.front() != static_cast<std::int64_t>(batch))
+                continue;
+            dims.front() = n;
+            v[key]       = dims;
+            changed      = true;
+        }
+        if(not changed)
+            return op;
+        return make_op(ins->name(), v);
+    }
+
+    static shape sub_batch_shape(const shape& s, std::size_t n)
+    {
+        auto lens    = s.lens();
+        lens.front() = n;
+        return {s.type(), lens};
+    }
+
+    // Check that every batched instruction keeps the other dimensions for a
+    // sub-batch of size n, without building the module
+    bool check(std::size_t n) const
+    {
+        std::unordered_map<instruction_ref, shape> shapes;
+        for(auto ins : iterator_for(*m))
+        {
+            if(ins->name() == "@return")
+                break;
+            shape s = ins->get_shape();
+            if(ins->name() == "@param")
+            {
+                if(contains(batched, ins))
+                    s = sub_batch_shape(s, n);
+            }
+            else if(ins->name() != "@literal")
+            {
+                std::vector<shape> inputs;
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(inputs),
+                               [&](auto input) { return shapes.at(input); });
+                auto r = try_compute_shape(sub_batch_op(ins, n), inputs);
+                if(r.empty())
+                    return false;
+                s = r.front();
+            }
+            auto expected = ins->get_shape();
+            if(contains(batched, ins))
+                expected = sub_batch_shape(expected, n);
+            if(s.type() != expected.type() or s.lens() != expected.lens())
+                return false;
+            shapes[ins] = s;
+        }
+        return true;
+    }
+
+    std::vector<instruction_ref> get_outputs() const
+    {
+        auto last = std::prev(m->end());
+        if(last->name() == "@return")
+            return last->inputs();
+        return {last};
+    }
+
+    bool can_split() const
+    {
+        // Submodules are not copied to the sub-batches
+        if(std::any_of(m->begin(), m->end(), [](const instruction& ins) {
+               return not ins.module_inputs().empty() or
+                      (starts_with(ins.name(), "@") and
+                       not contains({"@param", "@literal", "@return"}, ins.name()));
+           }))
+            return false;
+        for(auto ins : iterator_for(*m))
+        {
+            if(contains(batched, ins) and mixes_batch(ins))
+                return false;
+        }
+        auto outputs = get_outputs();
+        return std::all_of(outputs.begin(), outputs.end(), [&](auto ins) {
+            return contains(batched, ins) and ins->name() != "@param";
+        });
+    }
+
+    // A module that runs a sub-batch of size n, which takes the same parameters
+    module* create_sub_batch(module_pass_manager& mpm,
+                             std::size_t i,
+                             std::size_t n,
+                             const std::vector<instruction_ref>& outputs) const
+    {
+        auto* sm = mpm.create_module(m->name() + ":batch" + std::to_string(i));
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        for(auto ins : iterator_for(*m))
+        {
+            if(ins->name() == "@return")
+                break;
+            if(ins->name() == "@param")
+            {
+                auto s = ins->get_shape();
+                if(contains(batched, ins))
+                    s = sub_batch_shape(s, n);
+                map_ins[ins] =
+                    sm->add_parameter(any_cast<builtin::param>(ins->get_operator()).parameter, s);
+            }
+            else if(ins->name() == "@literal")
+            {
+                // The copy of the literal shares its buffer
+                map_ins[ins] = sm->add_literal(ins->get_literal());
+            }
+            else
+            {
+                std::vector<instruction_ref> inputs;
+                std::transform(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::back_inserter(inputs),
+                               [&](auto input) { return map_ins.at(input); });
+                map_ins[ins] = sm->add_instruction(sub_batch_op(ins, n), inputs);
+            }
+        }
+        std::vector<instruction_ref> returns;
+        std::transform(outputs.begin(),
+                       outputs.end(),
+                       std::back_inserter(returns),
+                       [&](auto ins) { return map_ins.at(ins); });
+        sm->add_return(returns);
+        return sm;
+    }
+
+    bool apply(module_pass_manager& mpm, std::size_t splits)
+    {
+        find_batched();
+        if(not can_split())
+            return false;
+        auto k = std::min(splits, batch);
+        // The first batch % k sub-batches take one more item
+        std::vector<std::size_t> sizes(k, batch / k);
+        std::fill(sizes.begin(), sizes.begin() + batch % k, batch / k + 1);
+        if(not std::all_of(sizes.begin(), sizes.end(), [&](auto n) { return check(n); }))
+            return false;
+
+        auto returns = get_outputs();
+        std::vector<instruction_ref> outputs;
+        for(auto ins : returns)
+        {
+            if(not contains(outputs, ins))
+                outputs.push_back(ins);
+        }
+        std::vector<instruction_ref> params;
+        std::vector<std::string> names;
+        for(auto ins : iterator_for(*m))
+        {
+            if(ins->name() != "@param")
+                continue;
+            params.push_back(ins);
+            names.push_back(any_cast<builtin::param>(ins->get_operator()).parameter);
+        }
+
+        auto last = std::prev(m->end());
+        auto pos  = last->name() == "@return" ? last : m->end();
+        std::vector<instruction_ref> inputs;
+        // The modules are copied from the main module before it is changed
+        std::vector<module_ref> mods;
+        for(std::size_t i = 0; i < k; i++)
+            mods.push_back(create_sub_batch(mpm, i, sizes[i], outputs));
+        std::size_t start = 0;
+        for(auto n : sizes)
+        {
+            for(auto param : params)
+            {
+                if(not contains(batched, param))
+                {
+                    inputs.push_back(param);
+                    continue;
+                }
+                inputs.push_back(m->insert_instruction(
+                    pos,
+                    make_op("slice", {{"axes", {0}}, {"starts", {start}}, {"ends", {start + n}}}),
+                    param));
+            }
+            start += n;
+        }
+        auto r =
+            m->insert_instruction(pos, make_op("run_parallel", {{"names", names}}), inputs, mods);
+        std::vector<instruction_ref> results;
+        for(auto ins : returns)
+        {
+            auto j = std::distance(outputs.begin(), std::find(outputs.begin(), outputs.end(), ins));
+            results.push_back(
+                m->insert_instruction(pos, make_op("get_tuple_elem", {{"index", j}}), r));
+        }
+        m->replace_return(results);
+        return true;
+    }
+};
+
+void split_batch::apply(module_pass_manager& mpm) const
+{
+    auto& m = mpm.get_module();
+    if(splits < 2 or m.name() != "main")
+        return;
+    auto batch = find_batch(m);
+    if(batch < 2)
+        return;
+    std::vector<instruction_ref> params;
+    for(auto ins : iterator_for(m))
+    {
+        const auto& s = ins->get_shape();
+        if(ins->name() == "@param" and not s.lens().empty() and s.lens().front() == batch and
+           s.standard())
+            params.push_back(ins);
+    }
+    if(params.empty())
+        return;
+    // A parameter, such as a bias, can have as many channels as the batch, so
+    // try again with only the parameters of the highest rank
+    auto rank = [](instruction_ref ins) { return ins->get_shape().lens().size(); };
+    auto max_rank =
+        rank(*std::max_element(params.begin(), params.end(), by(std::less<>{}, rank)));
+    std::vector<instruction_ref> ranked;
+    std::copy_if(params.begin(), params.end(), std::back_inserter(ranked), [&](auto ins) {
+        return rank(ins) == max_rank;
+    });
+    if(batch_split{&m, batch, {params.begin(), params.end()}}.apply(mpm, splits) or
+       ranked.size() == params.size())
+        return;
+    batch_split{&m, batch, {ranked.begin(), ranked.end()}}.apply(mpm, splits);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
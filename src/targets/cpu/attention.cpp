@@ -0,0 +1,180 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Offset of each batch in a tensor, which may be transposed or broadcasted
+static std::vector<std::size_t> batch_offsets(const shape& s)
+{
+    auto n = s.lens().size() - 2;
+    std::vector<std::size_t> lens(s.lens().begin(), s.lens().begin() + n);
+    std::vector<std::size_t> strides(s.strides().begin(), s.strides().begin() + n);
+    if(lens.empty())
+        return {0};
+    shape bs{s.type(), lens, strides};
+    std::vector<std::size_t> result(bs.elements());
+    for(std::size_t i = 0; i < result.size(); i++)
+        result[i] = bs.index(i);
+    return result;
+}
+
+// Computes softmax(q * k * scale + mask) * v one row of q at a time. The
+// scores are computed for a tile of keys, and the softmax is computed online
+// by rescaling the running sum and output whenever the running max changes,
+// so the full [seq, seq] score matrix is never materialized.
+struct cpu_attention : auto_register_op<cpu_attention>
+{
+    float scale = 1.0f;
+    bool masked = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.scale, "scale"), f(self.masked, "masked"));
+    }
+
+    std::string name() const { return "cpu::attention"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(masked ? 5 : 4).same_type().same_ndims().min_ndims(2);
+        const auto& q = inputs[0];
+        const auto& k = inputs[1];
+        const auto& v = inputs[2];
+        auto n        = q.lens().size();
+        if(q.lens()[n - 1] != k.lens()[n - 2] or k.lens()[n - 1] != v.lens()[n - 2])
+            MIGRAPHX_THROW("ATTENTION: inner dimensions do not match");
+        if(masked)
+        {
+            auto lens   = q.lens();
+            lens[n - 1] = k.lens()[n - 1];
+            if(inputs[3].lens() != lens)
+                MIGRAPHX_THROW("ATTENTION: mask must have the same dimensions as the scores");
+        }
+        return inputs.back();
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& qs = args[0].get_shape();
+        const auto& ks = args[1].get_shape();
+        const auto& vs = args[2].get_shape();
+        const auto& ms = args[masked ? 3 : 0].get_shape();
+        auto n         = qs.lens().size();
+        auto seq_q     = qs.lens()[n - 2];
+        auto depth     = qs.lens()[n - 1];
+        auto seq_k     = ks.lens()[n - 1];
+        auto depth_v   = vs.lens()[n - 1];
+        auto q_offsets = batch_offsets(qs);
+        auto k_offsets = batch_offsets(ks);
+        auto v_offsets = batch_offsets(vs);
+        auto m_offsets = batch_offsets(ms);
+        auto nbatch    = q_offsets.size();
+        auto q_row     = qs.strides()[n - 2];
+        auto q_col     = qs.strides()[n - 1];
+        auto k_row     = ks.strides()[n - 2];
+        auto k_col     = ks.strides()[n - 1];
+        auto v_row     = vs.strides()[n - 2];
+        auto v_col     = vs.strides()[n - 1];
+        auto m_row     = ms.strides()[n - 2];
+        auto m_col     = ms.strides()[n - 1];
+        assert(output_shape.standard());
+        auto o_row     = output_shape.strides()[n - 2];
+        const std::size_t tile = 64;
+
+        visit_all(args.back(), args[0], args[1], args[2], args[masked ? 3 : 0])(
+            [&](auto output, auto query, auto key, auto value, auto mask) {
+                using type = typename decltype(output)::value_type;
+                ctx.bulk_execute(nbatch * seq_q, 1, [&](auto start, auto end) {
+                    std::vector<float> s(tile);
+                    std::vector<float> acc(depth_v);
+                    for(auto r = start; r < end; r++)
+                    {
+                        auto b       = r / seq_q;
+                        auto i       = r % seq_q;
+                        const auto* q = query.data() + q_offsets[b] + i * q_row;
+                        const auto* k = key.data() + k_offsets[b];
+                        const auto* v = value.data() + v_offsets[b];
+                        const auto* m = mask.data() + m_offsets[b] + i * m_row;
+                        auto* o       = output.data() + r * o_row;
+                        float row_max = -std::numeric_limits<float>::infinity();
+                        float row_sum = 0;
+                        std::fill(acc.begin(), acc.end(), 0.0f);
+                        for(std::size_t j0 = 0; j0 < seq_k; j0 += tile)
+                        {
+                            auto nj = std::min(tile, seq_k - j0);
+                            std::fill(s.begin(), s.begin() + nj, 0.0f);
+                            // Keep the inner loop on the contiguous dimension of k
+                            if(k_col == 1)
+                            {
+                                for(std::size_t d = 0; d < depth; d++)
+                                {
+                                    float x        = q[d * q_col];
+                                    const auto* kd = k + d * k_row + j0;
+                                    for(std::size_t jj = 0; jj < nj; jj++)
+                                        s[jj] += x * float(kd[jj]);
+                                }
+                            }
+                            else
+                            {
+                                for(std::size_t jj = 0; jj < nj; jj++)
+                                {
+                                    const auto* kj = k + (j0 + jj) * k_col;
+                                    float sum      = 0;
+                                    for(std::size_t d = 0; d < depth; d++)
+                                        sum += float(q[d * q_col]) * float(kj[d * k_row]);
+                                    s[jj] = sum;
+                                }
+                            }
+                            float tile_max = -std::numeric_limits<float>::infinity();
+                            for(std::size_t jj = 0; jj < nj; jj++)
+                            {
+                                s[jj] *= scale;
+                                if(masked)
+                                    s[jj] += float(m[(j0 + jj) * m_col]);
+                                tile_max = std::max(tile_max, s[jj]);
+                            }
+                            if(tile_max == -std::numeric_limits<float>::infinity())
+                                continue;
+                            auto new_max = std::max(row_max, tile_max);
+                            // Rescale what has been accumulated so far to the new max
+                            auto correction = std::exp(row_max - new_max);
+                            row_sum *= correction;
+                            for(auto& x : acc)
+                                x *= correction;
+                            for(std::size_t jj = 0; jj < nj; jj++)
+                            {
+                                auto p = std::exp(s[jj] - new_max);
+                                row_sum += p;
+                                const auto* vj = v + (j0 + jj) * v_row;
+                                for(std::size_t e = 0; e < depth_v; e++)
+                                    acc[e] += p * float(vj[e * v_col]);
+                            }
+                            row_max = new_max;
+                        }
+                        for(std::size_t e = 0; e < depth_v; e++)
+                            o[e] = type(acc[e] / row_sum);
+                    }
+                });
+            });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
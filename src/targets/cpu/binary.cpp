@@ -18,6 +18,11 @@ struct dnnl_binary : dnnl_op<dnnl_binary, dnnl::binary>
 
     std::string name() const { return "dnnl::binary"; }
 
+    bool is_row_input(const shape& output, const std::vector<shape>& inputs, std::size_t i) const
+    {
+        return same_rows(output, inputs[i]);
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         // Compensate for allocation
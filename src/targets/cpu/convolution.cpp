@@ -13,7 +13,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
 struct dnnl_convolution
-    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>
+    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>,
+      auto_register_weights_packer<dnnl_convolution>
 {
     std::vector<int> arg_map(int) const
     {
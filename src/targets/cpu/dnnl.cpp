@@ -1,4 +1,6 @@
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/context.hpp>
 
 #if defined(__GNUC__) && __GNUC__ <= 5
 namespace std {
@@ -30,6 +32,14 @@ dnnl_context& get_dnnl_context()
     return ctx;
 }
 
+scoped_cpu_binding bind_thread(migraphx::context& ctx)
+{
+    auto* cctx = ctx.any_cast<cpu::context>();
+    if(cctx == nullptr)
+        return {};
+    return cctx->bind_thread();
+}
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
@@ -176,6 +186,25 @@ std::string to_string(const dnnl::algorithm& algo)
     return dnnl_algo_string_map().at(algo);
 }
 
+static std::unordered_map<std::string, weights_packer>& weights_packer_map()
+{
+    static std::unordered_map<std::string, weights_packer> m; // NOLINT
+    return m;
+}
+
+void register_weights_packer(const std::string& name, weights_packer f)
+{
+    weights_packer_map()[name] = std::move(f);
+}
+
+weights_packer get_weights_packer(const std::string& name)
+{
+    auto it = weights_packer_map().find(name);
+    if(it == weights_packer_map().end())
+        return nullptr;
+    return it->second;
+}
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -21,6 +21,11 @@ struct dnnl_eltwise : dnnl_op<dnnl_eltwise, dnnl::eltwise_forward>
 
     std::string name() const { return "dnnl::eltwise"; }
 
+    bool is_row_input(const shape& output, const std::vector<shape>& inputs, std::size_t i) const
+    {
+        return same_rows(output, inputs[i]);
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         // Compensate for allocation
@@ -0,0 +1,14 @@
+#include <migraphx/cpu/extent.hpp>
+#include <migraphx/env.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_CPU_EXTENT)
+
+bool use_extent() { return enabled(MIGRAPHX_ENABLE_CPU_EXTENT{}); }
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
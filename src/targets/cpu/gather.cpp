@@ -1,6 +1,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/context.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/extent.hpp>
 #include <migraphx/op/gather.hpp>
 
 namespace migraphx {
@@ -25,9 +26,72 @@ struct cpu_gather : auto_register_op<cpu_gather>
         return migraphx::compute_shape(op, inputs);
     }
 
+    // The output holds values where the indices do, and where the data does on
+    // the other axes. The data padded on the axis is gathered as zeros. The
+    // padding of the indices gathers the first slice of the data, so it is
+    // only padding in the output when that slice is zero.
+    std::vector<std::size_t> output_extent(const shape& output_shape,
+                                           const std::vector<argument>& args) const
+    {
+        if(not use_extent() or not(args[0].padded() or args[1].padded()) or
+           args[1].get_shape().scalar())
+            return {};
+        auto extent  = args[0].extent();
+        auto indices = args[1].extent();
+        if(args[1].padded())
+        {
+            const auto& s = args[0].get_shape();
+            auto lens     = s.lens();
+            lens[op.axis] = 1;
+            if(not all_zero(argument{shape{s.type(), lens, s.strides()}, args[0].data()}))
+                indices = args[1].get_shape().lens();
+        }
+        extent.erase(extent.begin() + op.axis);
+        extent.insert(extent.begin() + op.axis, indices.begin(), indices.end());
+        if(extent == output_shape.lens())
+            return {};
+        return extent;
+    }
+
+    argument compute_extent(context& ctx,
+                            const shape& output_shape,
+                            const std::vector<argument>& args,
+                            const std::vector<std::size_t>& extent) const
+    {
+        auto axis          = op.axis;
+        auto axis_dim_size = args[0].get_shape().lens()[axis];
+        const auto& is     = args[1].get_shape();
+        auto rank          = is.lens().size();
+        shape out_comp{output_shape.type(), extent};
+        visit_all(args.back(), args[0])([&](auto output, auto input) {
+            args[1].visit([&](auto indices) {
+                ctx.bulk_execute(out_comp.elements(), 1024, [&](auto start, auto end) {
+                    for(auto i = start; i < end; i++)
+                    {
+                        auto idx       = out_comp.multi(i);
+                        auto out_index = output_shape.index(idx);
+                        auto first     = idx.begin() + axis;
+                        auto in_index =
+                            indices[is.index(std::vector<std::size_t>(first, first + rank))];
+                        in_index = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                        idx.erase(idx.begin() + axis, idx.begin() + axis + rank);
+                        idx.insert(idx.begin() + axis, in_index);
+                        output[out_index] = input(idx.begin(), idx.end());
+                    }
+                });
+            });
+        });
+        auto result = args.back().with_extent(extent);
+        zero_padding(result);
+        return result;
+    }
+
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
+        auto extent = output_extent(output_shape, args);
+        if(not extent.empty())
+            return compute_extent(ctx, output_shape, args, extent);
         std::size_t nelements = output_shape.elements();
         auto lens             = args[0].get_shape().lens();
         auto axis_dim_size    = lens[op.axis];
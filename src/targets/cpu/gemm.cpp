@@ -11,7 +11,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
+struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>,
+                   auto_register_weights_packer<dnnl_gemm>
 {
     std::vector<int> arg_map(int) const
     {
@@ -22,6 +23,17 @@ struct dnnl_gemm : dnnl_extend_op<dnnl_gemm, dnnl::matmul, op::dot>
 
     void required(const check_shapes& cs) const { cs.not_broadcasted(); }
 
+    // The rows of a are the rows of the output, or its batch when it has more
+    // than 2 dims, and the same goes for the batch of b
+    bool is_row_input(const shape& output, const std::vector<shape>& inputs, std::size_t i) const
+    {
+        if(i == 0)
+            return true;
+        if(i == 1 and output.lens().size() == 2)
+            return false;
+        return same_rows(output, inputs[i]);
+    }
+
     dnnl::matmul::desc get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         return {m.at(MIGRAPHX_DNNL_PREFIX(ARG_SRC)),
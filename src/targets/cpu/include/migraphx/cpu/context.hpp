@@ -4,7 +4,11 @@
 #include <migraphx/config.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
+#include <migraphx/cpu/numa.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/value.hpp>
+#include <algorithm>
+#include <thread>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -12,12 +16,62 @@ namespace cpu {
 
 struct context
 {
+    // Run on the cpus of this numa node, reading the literals from a replica
+    // on that node. All of the cpus are used when it is negative.
+    int numa_node = -1;
+
     void finish() const {}
 
+    value to_value() const
+    {
+        return {{"numa_node", numa_node}, {"numa_nodes", numa_node_count()}};
+    }
+
+    void from_value(const value& v) { numa_node = v.get("numa_node", -1); }
+
+    // The cpus to run on, which are the group of the worker when it runs a
+    // sub-batch, else the cpus of the numa node. It is empty when all of the
+    // cpus are used.
+    std::vector<std::size_t> get_cpus() const
+    {
+        const auto& dedicated = dedicated_cpus();
+        if(not dedicated.empty())
+            return dedicated;
+        if(numa_node < 0)
+            return {};
+        return numa_node_cpus(numa_node);
+    }
+
+    // Bind the calling thread to the cpus of this context, until the binding
+    // goes out of scope
+    scoped_cpu_binding bind_thread() const
+    {
+        auto cpus = get_cpus();
+        if(cpus.empty())
+            return {};
+        return scoped_cpu_binding{cpus};
+    }
+
+    // The caller is bound for the call, while the other threads of the pool
+    // keep their binding, so they are only bound again when the cpus change
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
     {
-        cpu::parallel_for(n, min_grain, f);
+        auto cpus   = get_cpus();
+        auto caller = std::this_thread::get_id();
+        auto run    = [&](auto start, auto end) {
+            if(std::this_thread::get_id() != caller)
+                bind_pool_thread(cpus);
+            f(start, end);
+        };
+        if(cpus.empty())
+        {
+            cpu::parallel_for(n, min_grain, run);
+            return;
+        }
+        scoped_cpu_binding binding{cpus};
+        const auto threadsize = std::min({cpus.size(), max_threads(), n / min_grain});
+        cpu::parallel_for_impl(n, threadsize, run);
     }
 
     template <class F>
@@ -6,9 +6,16 @@
 #include <migraphx/reflect.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/numa.hpp>
 #include <unordered_map>
 #include <migraphx/errors.hpp>
 #include <migraphx/assert.hpp>
+#include <migraphx/auto_register.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/cpu/extent.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
 #ifdef MIGRAPHX_ENABLE_ZENDNN
 #include <zendnn.hpp>
 #else
@@ -36,6 +43,10 @@ struct dnnl_context
 
 dnnl_context& get_dnnl_context();
 
+// Bind the calling thread to the numa node of the cpu context, so dnnl runs
+// its threads on that node, until the binding goes out of scope
+scoped_cpu_binding bind_thread(migraphx::context& ctx);
+
 dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t);
 
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n);
@@ -68,16 +79,54 @@ struct post_op : reflect_equality<post_op>, reflect_stream<post_op>
     }
 };
 
+/// Reorders constant weights into the layout the primitive prefers. Returns
+/// an empty argument when the weights cannot be or do not need to be packed.
+using weights_packer = std::function<argument(
+    const operation& op, const std::vector<shape>& inputs, const argument& weights)>;
+
+void register_weights_packer(const std::string& name, weights_packer f);
+
+weights_packer get_weights_packer(const std::string& name);
+
+struct register_weights_packer_action
+{
+    template <class T>
+    static void apply()
+    {
+        register_weights_packer(
+            T{}.name(),
+            [](const operation& op, const std::vector<shape>& inputs, const argument& weights) {
+                return any_cast<T>(op).pack_weights(inputs, weights);
+            });
+    }
+};
+
+template <class T>
+using auto_register_weights_packer = auto_register<register_weights_packer_action, T>;
+
 template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
-    std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
+    // The weights are reordered into the layout the primitive prefers on the
+    // cpu the program is finalized on, so the primitive is built against it
+    bool packed_weights = false;
+    using execute_function =
+        std::function<argument(migraphx::context& ctx, const std::vector<argument>& args)>;
+    execute_function execute;
+    // Primitives that only compute the leading rows of the output, which are
+    // made the first time the inputs hold values in that many rows
+    struct row_executes
+    {
+        std::mutex mutex;
+        std::unordered_map<std::size_t, execute_function> executes;
+    };
+    std::shared_ptr<row_executes> rows_cache;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"), f(self.packed_weights, "packed_weights"));
     }
 
     template <class Self, class F>
@@ -242,16 +291,162 @@ struct dnnl_op : auto_register_op<Derived>
     {
         return typename Primitive::primitive_desc(desc, attr, get_dnnl_context().engine);
     }
-    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    auto make_primitive_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         const auto& self = static_cast<const Derived&>(*this);
         auto desc        = self.get_desc(m);
         auto attr        = MIGRAPHX_ASSERT_NO_THROW(this->get_primitive_attr(m));
-        auto pd          = self.get_primitive_desc(desc, attr);
-        return Primitive(pd);
+        return self.get_primitive_desc(desc, attr);
+    }
+    Primitive get_primitive(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        return Primitive(make_primitive_desc(m));
+    }
+    // Let the primitive choose the layout of the weights
+    dnnl::memory::desc
+    get_preferred_weights_desc(std::unordered_map<int, dnnl::memory::desc> m) const
+    {
+        auto w = m.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        m[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] =
+            dnnl::memory::desc(w.dims(), w.data_type(), dnnl::memory::format_tag::any);
+        return make_primitive_desc(m).weights_desc(0);
+    }
+    // The layout of the weights when they are packed on this cpu. Blocked
+    // layouts that need padding are skipped, since the packed weights must
+    // still fit in the shape of the literal.
+    dnnl::memory::desc
+    get_packed_weights_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
+    {
+        auto src = m.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        auto dst = get_preferred_weights_desc(m);
+        if(dst.get_size() != src.get_size())
+            return src;
+        return dst;
+    }
+    std::unordered_map<int, dnnl::memory::desc>
+    to_packed_memory_desc(const shape& output_shape, const std::vector<shape>& inputs) const
+    {
+        auto m = to_memory_desc(output_shape, inputs);
+        if(packed_weights)
+            m[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] = get_packed_weights_desc(m);
+        return m;
+    }
+    argument pack_weights(std::vector<shape> inputs, const argument& weights) const
+    {
+        // Compensate for allocation
+        auto output_shape = inputs.back();
+        inputs.pop_back();
+        auto md  = to_memory_desc(output_shape, inputs);
+        auto src = md.at(MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        auto dst = get_packed_weights_desc(md);
+        if(dst == src)
+            return {};
+        argument result{weights.get_shape()};
+        auto src_mem = to_dnnl_memory(src, weights);
+        auto dst_mem = to_dnnl_memory(dst, result);
+        auto& dctx   = get_dnnl_context();
+        dnnl::reorder(src_mem, dst_mem).execute(dctx.stream, src_mem, dst_mem);
+        dctx.stream.wait();
+        return result;
+    }
+    static bool same_rows(const shape& output, const shape& input)
+    {
+        return input.lens().size() == output.lens().size() and
+               input.lens().front() == output.lens().front();
+    }
+    // Whether the rows of the output along the first axis only use the same
+    // rows of input i, so the primitive can run on the leading rows that the
+    // padded inputs hold values in. Ops opt in by overriding it.
+    bool is_row_input(const shape&, const std::vector<shape>&, std::size_t) const
+    {
+        return false;
+    }
+    // The number of leading rows of the output to compute, which is less
+    // than all of them when the row inputs are all padded to those rows, so
+    // the rows past them are all computed from the same zeros
+    std::size_t get_rows(const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        auto all_rows    = output_shape.lens().front();
+        if(not use_extent() or packed_weights or rows_cache == nullptr)
+            return all_rows;
+        auto inputs = to_shapes(args);
+        inputs.pop_back();
+        auto rows   = all_rows;
+        bool padded = false;
+        for(std::size_t i = 0; i < inputs.size(); i++)
+        {
+            auto extent      = args[i].extent();
+            const auto& lens = inputs[i].lens();
+            if(not self.is_row_input(output_shape, inputs, i))
+            {
+                if(args[i].padded())
+                    return all_rows;
+                continue;
+            }
+            if(not args[i].padded() or (padded and extent.front() != rows) or
+               not std::equal(extent.begin() + 1, extent.end(), lens.begin() + 1))
+                return all_rows;
+            rows   = extent.front();
+            padded = true;
+        }
+        return rows;
+    }
+    execute_function get_row_execute(const shape& output_shape,
+                                     const std::vector<shape>& inputs,
+                                     std::size_t rows) const
+    {
+        std::lock_guard<std::mutex> lock(rows_cache->mutex);
+        auto it = rows_cache->executes.find(rows);
+        if(it == rows_cache->executes.end())
+            it = rows_cache->executes.emplace(rows, make_execute(output_shape, inputs)).first;
+        return it->second;
+    }
+    // Computes the leading rows of the output and the first row past them,
+    // which is what every row of the padding would be. The rest is set to
+    // zero when that row is zero, or else computed as well.
+    argument execute_rows(migraphx::context& ctx,
+                          const shape& output_shape,
+                          const std::vector<argument>& args,
+                          std::size_t rows) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        auto take_rows   = [&](const shape& s, std::size_t n) {
+            auto lens    = s.lens();
+            lens.front() = n;
+            return shape{s.type(), lens, s.strides()};
+        };
+        auto inputs = to_shapes(args);
+        inputs.pop_back();
+        auto output = take_rows(output_shape, rows + 1);
+        std::vector<shape> row_inputs(inputs.size());
+        std::vector<argument> row_args(args.size());
+        for(std::size_t i = 0; i < inputs.size(); i++)
+        {
+            row_inputs[i] = self.is_row_input(output_shape, inputs, i)
+                                ? take_rows(inputs[i], rows + 1)
+                                : inputs[i];
+            row_args[i] = args[i].reshape(row_inputs[i]);
+        }
+        row_args.back() = args.back().reshape(output);
+        get_row_execute(output, row_inputs, rows + 1)(ctx, row_args);
+        if(rows + 1 == output_shape.lens().front())
+            return args.back();
+        auto offset = rows * output_shape.strides().front() * output_shape.type_size();
+        if(not all_zero(argument{take_rows(output_shape, 1), args.back().data() + offset}))
+            return execute(ctx, args);
+        auto result = args.back().with_extent(take_rows(output_shape, rows).lens());
+        zero_padding(result);
+        return result;
     }
-    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    argument compute(migraphx::context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args) const
     {
+        auto binding = bind_thread(ctx);
+        auto rows    = get_rows(output_shape, args);
+        if(rows < output_shape.lens().front())
+            return execute_rows(ctx, output_shape, args, rows);
         return execute(ctx, args);
     }
 
@@ -259,34 +454,41 @@ struct dnnl_op : auto_register_op<Derived>
     {
         return shapes.size() - 1;
     }
-    value compile(context&, const shape& output_shape, std::vector<shape> inputs)
+    value compile(migraphx::context&, const shape& output_shape, std::vector<shape> inputs)
     {
         // Compensate for allocation
         inputs.pop_back();
-        auto md        = to_memory_desc(output_shape, inputs);
+        auto md        = to_packed_memory_desc(output_shape, inputs);
         auto prim      = get_primitive(md);
         auto impl_name = impl(prim);
         return {{"impl", impl_name}};
     }
 
-    void finalize(context&, const shape& output_shape, std::vector<shape> inputs)
+    void finalize(migraphx::context&, const shape& output_shape, std::vector<shape> inputs)
     {
         // Compensate for allocation
         inputs.pop_back();
+        execute    = make_execute(output_shape, inputs);
+        rows_cache = std::make_shared<row_executes>();
+    }
+
+    execute_function make_execute(const shape& output_shape,
+                                  const std::vector<shape>& inputs) const
+    {
         const auto& self = static_cast<const Derived&>(*this);
         auto name        = self.name();
-        auto md          = to_memory_desc(output_shape, inputs);
+        auto md          = to_packed_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
         auto arg_lookup  = create_arg_map(inputs.size());
 #ifndef NDEBUG
         auto prim_attr = get_primitive_attr(md);
 #endif
-        execute = [=](context&, const std::vector<argument>& args) {
+        return [=](migraphx::context&, const std::vector<argument>& args) {
 #ifndef NDEBUG
             // Check that the memory descriptors have not changed
             auto debug_args = args;
             debug_args.pop_back();
-            auto debug_md = to_memory_desc(output_shape, to_shapes(debug_args));
+            auto debug_md = to_packed_memory_desc(output_shape, to_shapes(debug_args));
             for(auto&& p : debug_md)
             {
                 if(md.count(p.first) == 0)
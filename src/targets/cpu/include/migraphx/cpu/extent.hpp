@@ -0,0 +1,21 @@
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_EXTENT_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_EXTENT_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/extent.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// Whether the kernels only compute the part of their output in the extent
+/// of padded inputs. They do so when the padding of the inputs gives zeros,
+/// or for pointwise ops a single value, which they set the rest to instead of
+/// computing it. It is enabled with MIGRAPHX_ENABLE_CPU_EXTENT.
+bool use_extent();
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MIGRAPHX_GUARD_CPU_JIT_HPP
+#define MIGRAPHX_GUARD_CPU_JIT_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/shape.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// The signature of a generated kernel. args holds the pointers to the inputs
+/// followed by the output, and the kernel computes the work items from start
+/// to end.
+using jit_function = void(void** args, std::size_t start, std::size_t end);
+
+struct jit_kernel
+{
+    std::string symbol_name;
+    std::string src;
+    // The instructions to pass as args, without the output
+    std::vector<instruction_ref> inputs;
+    // The shapes of the args the kernel was generated for, with the output
+    std::vector<shape> shapes;
+    // Number of work items, and how many of them a thread should at least run
+    std::size_t work  = 1;
+    std::size_t grain = 1;
+};
+
+/// Generates a kernel that computes the instructions in ops for each element
+/// of output. The ops are in order, and the last one computes the output.
+jit_kernel generate_pointwise_kernel(const std::vector<instruction_ref>& ops,
+                                     const shape& output);
+
+/// Generates a kernel that computes the instructions in ops, and reduces the
+/// result over axes. algo is one of sum, mean, max, min or prod.
+jit_kernel generate_reduce_kernel(const std::vector<instruction_ref>& ops,
+                                  const std::string& algo,
+                                  const std::vector<std::size_t>& axes,
+                                  const shape& output);
+
+/// Compiles the source with the host compiler into a shared library. The
+/// libraries are cached on disk, keyed by a hash of the source, so they are
+/// only compiled once. The cache is only used when the directory and the
+/// libraries in it are owned by the user and nobody else can write to them.
+dynamic_loader compile_jit(const std::string& src);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
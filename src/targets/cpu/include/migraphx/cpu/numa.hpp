@@ -0,0 +1,80 @@
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_NUMA_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_NUMA_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Nodes are numbered from 0 to numa_node_count() - 1 in the order they are
+// listed by the system, and only include the cpus this process may run on.
+
+/// The cpus the calling thread may run on
+std::vector<std::size_t> allowed_cpus();
+
+/// Number of numa nodes, which is 1 when the topology is not available
+std::size_t numa_node_count();
+
+/// The cpus of a numa node that this process may run on
+const std::vector<std::size_t>& numa_node_cpus(std::size_t node);
+
+/// Bind the calling thread to the cpus, and limit the number of threads it
+/// starts to the number of cpus. The binding is not undone, so this is only
+/// for threads that are dedicated to the cpus, such as the worker of a
+/// sub-batch. The contexts that run on the thread then only use these cpus.
+void bind_to_cpus(const std::vector<std::size_t>& cpus);
+
+/// The cpus the calling thread was dedicated to with bind_to_cpus, or nothing
+/// when it is not a dedicated thread
+const std::vector<std::size_t>& dedicated_cpus();
+
+/// Bind a thread of the pool that runs the work of bulk_execute to the cpus,
+/// or back to the cpus it had before when there are none. The thread keeps
+/// the binding, so it is only changed when the cpus change.
+void bind_pool_thread(const std::vector<std::size_t>& cpus);
+
+/// Binds the calling thread to the cpus, and limits the number of threads it
+/// starts, until it goes out of scope, when the affinity and the number of
+/// threads of the thread are restored. This way the calling thread is left as
+/// it was after an eval. It does nothing when the thread is already bound to
+/// the cpus.
+struct scoped_cpu_binding
+{
+    /// Does not bind the thread
+    scoped_cpu_binding() = default;
+    explicit scoped_cpu_binding(const std::vector<std::size_t>& cpus);
+    scoped_cpu_binding(const scoped_cpu_binding&) = delete;
+    scoped_cpu_binding& operator=(const scoped_cpu_binding&) = delete;
+    ~scoped_cpu_binding();
+
+    private:
+    bool bound          = false;
+    bool previous_bound = false;
+    std::vector<std::size_t> previous_cpus;
+    int previous_threads = 0;
+};
+
+/// A copy of a buffer for each numa node. Each copy is made the first time
+/// it is requested, by a thread that has been bound to that node, so its
+/// pages are allocated on that node.
+struct numa_replicas
+{
+    numa_replicas();
+
+    argument get(const argument& a, std::size_t node);
+
+    private:
+    std::vector<argument> replicas;
+    std::unique_ptr<std::once_flag[]> flags;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -5,6 +5,8 @@
 #include <migraphx/context.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/extent.hpp>
+#include <migraphx/generate.hpp>
 #include <migraphx/reduce_dims.hpp>
 #include <migraphx/register_op.hpp>
 
@@ -109,6 +111,45 @@ struct reduce_dims_base
         argument a{reduce_shapes[0]};
         return a;
     }
+
+    // Calls f with the args, which have fewer dims when they can be reduced.
+    // When the inputs are padded to the same extent, f gets the part of the
+    // args in their extent instead. The padding of the output is then what f
+    // gives for zeros, which is computed on one element and copied into it.
+    template <class F>
+    argument
+    apply_args(const shape& output_shape, const std::vector<argument>& args, F f) const
+    {
+        std::vector<argument> xs(args.size());
+        std::vector<std::size_t> extent;
+        if(use_extent())
+            extent = pointwise_extent(output_shape, {args.begin(), args.end() - 1});
+        if(extent.empty())
+        {
+            for(std::size_t i = 0; i < args.size(); i++)
+                xs[i] = get_arg(args, i);
+            f(xs);
+            return xs.back().reshape(output_shape);
+        }
+        std::transform(args.begin(), args.end(), xs.begin(), [&](const argument& a) {
+            return a.reshape(extent_shape(a.get_shape(), extent));
+        });
+        f(xs);
+        std::transform(args.begin(), args.end(), xs.begin(), [&](const argument& a) {
+            const auto& s = a.get_shape();
+            return fill_argument(shape{s.type(), std::vector<std::size_t>(s.lens().size(), 1)});
+        });
+        f(xs);
+        auto result = args.back().with_extent(extent);
+        if(all_zero(xs.back()))
+        {
+            zero_padding(result);
+            return result;
+        }
+        // The padding is no longer zero, so the output does not keep the extent
+        fill_padding(result, xs.back());
+        return args.back();
+    }
 };
 
 template <class T, std::size_t N>
@@ -325,15 +366,13 @@ struct cpu_unary : reduce_dims_base, auto_register_op<cpu_unary<Op>>
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
-        argument result = get_arg(args, args.size() - 1);
-
-        visit_all(result, get_arg(args, 0))([&](auto output, auto input) {
-            auto op2 = op;
-            pointwise(output, input)(
-                ctx, output.get_shape(), 1024, [op2](auto& y, auto x) { y = op2.apply()(x); });
+        return apply_args(output_shape, args, [&](const std::vector<argument>& xs) {
+            visit_all(xs.back(), xs.front())([&](auto output, auto input) {
+                auto op2 = op;
+                pointwise(output, input)(
+                    ctx, output.get_shape(), 1024, [op2](auto& y, auto x) { y = op2.apply()(x); });
+            });
         });
-
-        return result.reshape(output_shape);
     }
 
     std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
@@ -363,18 +402,15 @@ struct cpu_binary : reduce_dims_base, auto_register_op<cpu_binary<Op>>
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
-        argument result = get_arg(args, args.size() - 1);
-
-        visit_all(result, get_arg(args, 0), get_arg(args, 1))(
-            [&](auto output, auto input1, auto input2) {
+        return apply_args(output_shape, args, [&](const std::vector<argument>& xs) {
+            visit_all(xs.back(), xs[0], xs[1])([&](auto output, auto input1, auto input2) {
                 auto op2 = op;
                 pointwise(output, input1, input2)(
                     ctx, output.get_shape(), 1024, [op2](auto& z, auto x, auto y) {
                         z = op2.apply()(x, y);
                     });
             });
-
-        return result.reshape(output_shape);
+        });
     }
 
     std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
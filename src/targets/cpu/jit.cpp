@@ -0,0 +1,526 @@
+#include <migraphx/cpu/jit.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/permutation.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/reduce_dims.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_JIT_CACHE)
+
+// Number of elements a thread should at least compute
+const std::size_t jit_min_work = 16384;
+
+const std::string jit_flags = "-std=c++14 -O3 -march=native -fopenmp-simd -fPIC -shared";
+
+// clang-format off
+static const char* const jit_kernel_src = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace migraphx {
+using namespace std;
+
+template <class T, class U>
+T convert(U x)
+{
+    return static_cast<T>(x);
+}
+
+template <class T>
+T rsqrt(T x)
+{
+    return T(1) / sqrt(x);
+}
+
+${preamble}
+} // namespace migraphx
+
+extern "C" void ${kernel}(void** args, std::size_t start, std::size_t end)
+{
+${params}
+${body}
+}
+
+)__migraphx__";
+// clang-format on
+
+// The C++ function that computes the pointwise ops for one element
+struct point_function
+{
+    std::string preamble;
+    std::string name;
+    std::vector<instruction_ref> inputs;
+};
+
+// Constants with the same value everywhere are written into the kernel,
+// instead of being passed as an input
+static std::string constant_value(instruction_ref ins)
+{
+    const auto& s = ins->get_shape();
+    if(s.type() == shape::half_type or s.type() == shape::tuple_type)
+        return {};
+    if(s.elements() != 1 and
+       not std::all_of(s.strides().begin(), s.strides().end(), [](auto x) { return x == 0; }))
+        return {};
+    if(not ins->can_eval())
+        return {};
+    auto a = ins->eval();
+    if(a.empty())
+        return {};
+    std::string result;
+    a.visit([&](auto v) {
+        using type = typename decltype(v)::value_type;
+        auto x     = v.front();
+        if(not std::isfinite(double(x)))
+            return;
+        std::stringstream ss;
+        ss << std::setprecision(std::numeric_limits<type>::max_digits10) << +x;
+        result = shape::cpp_type(s.type()) + "(" + ss.str() + ")";
+    });
+    return result;
+}
+
+static point_function generate_point_function(const std::vector<instruction_ref>& ops)
+{
+    point_function result;
+    cpp_generator g;
+    g.fmap([](const std::string& fname) { return "migraphx::" + fname; });
+    cpp_generator::function f;
+    std::unordered_map<instruction_ref, std::string> names;
+    std::stringstream body;
+    for(auto ins : ops)
+    {
+        std::vector<std::string> args;
+        for(auto input : ins->inputs())
+        {
+            if(not contains(names, input))
+            {
+                auto c = constant_value(input);
+                if(c.empty())
+                {
+                    c = "x" + std::to_string(result.inputs.size());
+                    f.params.push_back({c, shape::cpp_type(input->get_shape().type())});
+                    result.inputs.push_back(input);
+                }
+                names[input] = c;
+            }
+            args.push_back(names.at(input));
+        }
+        auto name = "z" + std::to_string(names.size());
+        body << "auto " << name << " = " << g.generate_point_op(ins->get_operator(), args)
+             << ";\n";
+        names[ins] = name;
+    }
+    body << "return " << names.at(ops.back()) << ";\n";
+    f.set_body(body.str()).set_name("point").set_attributes({"inline"});
+    f.return_type   = shape::cpp_type(ops.back()->get_shape().type());
+    result.name     = "migraphx::" + g.create_function(f);
+    result.preamble = g.str();
+    return result;
+}
+
+// Offset of the element at the indices in idx
+static std::string index_expr(const shape& s, const std::vector<std::string>& idx)
+{
+    std::vector<std::string> terms;
+    for(std::size_t d = 0; d < idx.size(); d++)
+    {
+        auto stride = s.strides()[d];
+        if(stride == 0 or s.lens()[d] == 1)
+            continue;
+        terms.push_back(stride == 1 ? idx[d] : idx[d] + " * " + std::to_string(stride));
+    }
+    if(terms.empty())
+        return "0";
+    return join_strings(terms, " + ");
+}
+
+static std::string loop(const std::string& i, const std::string& first, const std::string& last)
+{
+    return "for(std::size_t " + i + " = " + first + "; " + i + " < " + last + "; " + i + "++)\n";
+}
+
+static std::vector<std::string> index_names(std::size_t n)
+{
+    std::vector<std::string> result(n);
+    std::generate(result.begin(), result.end(), [i = 0]() mutable {
+        return "i" + std::to_string(i++);
+    });
+    return result;
+}
+
+// Loads of each input at the indices in idx
+static std::string point_call(const point_function& pf,
+                              const std::vector<shape>& shapes,
+                              const std::vector<std::string>& idx)
+{
+    std::vector<std::string> args;
+    for(std::size_t i = 0; i < pf.inputs.size(); i++)
+        args.push_back("x" + std::to_string(i) + "[" + index_expr(shapes[i], idx) + "]");
+    return pf.name + "(" + join_strings(args, ", ") + ")";
+}
+
+static std::string params(const point_function& pf, const shape& output)
+{
+    std::stringstream ss;
+    std::size_t i = 0;
+    for(auto input : pf.inputs)
+    {
+        ss << "    auto* x" << i << " = static_cast<const "
+           << shape::cpp_type(input->get_shape().type()) << "*>(args[" << i << "]);\n";
+        i++;
+    }
+    ss << "    auto* y = static_cast<" << shape::cpp_type(output.type()) << "*>(args[" << i
+       << "]);\n";
+    return ss.str();
+}
+
+static std::string symbol_name(const std::string& kind, const std::string& body)
+{
+    std::stringstream ss;
+    ss << "migraphx_cpu_" << kind << "_" << std::hex << std::hash<std::string>{}(body);
+    return ss.str();
+}
+
+static jit_kernel make_kernel(const std::string& kind,
+                              const point_function& pf,
+                              const shape& output,
+                              const std::string& body)
+{
+    jit_kernel result;
+    result.symbol_name = symbol_name(kind, pf.preamble + body);
+    result.inputs      = pf.inputs;
+    result.shapes      = to_shapes(pf.inputs);
+    result.shapes.push_back(output);
+    result.src         = interpolate_string(jit_kernel_src,
+                                    {{"preamble", pf.preamble},
+                                     {"kernel", result.symbol_name},
+                                     {"params", params(pf, output)},
+                                     {"body", body}});
+    return result;
+}
+
+jit_kernel generate_pointwise_kernel(const std::vector<instruction_ref>& ops, const shape& output)
+{
+    assert(not ops.empty());
+    auto pf     = generate_point_function(ops);
+    auto shapes = to_shapes(pf.inputs);
+    shapes.push_back(output);
+    shapes          = reduce_dims(shapes);
+    const auto& out = shapes.back();
+    auto idx        = index_names(out.lens().size());
+    // Loop over the dimensions in the order the output is stored, so the
+    // innermost loop writes contiguous elements
+    auto order = sort_permutation(out.strides(), std::greater<>{});
+    std::stringstream body;
+    for(std::size_t k = 0; k < order.size(); k++)
+    {
+        auto d = order[k];
+        if(k == order.size() - 1)
+            body << "#pragma omp simd\n";
+        if(k == 0)
+            body << loop(idx[d], "start", "end");
+        else
+            body << loop(idx[d], "0", std::to_string(out.lens()[d]));
+    }
+    body << "    y[" << index_expr(out, idx) << "] = " << point_call(pf, shapes, idx) << ";";
+    auto result  = make_kernel("pointwise", pf, output, body.str());
+    result.work  = out.lens()[order.front()];
+    auto inner   = out.elements() / result.work;
+    result.grain = std::max<std::size_t>(1, jit_min_work / inner);
+    return result;
+}
+
+struct reduce_algo
+{
+    std::string init;
+    // Combines acc with the value in x
+    std::string combine;
+    std::string reduction;
+};
+
+static reduce_algo get_reduce_algo(const std::string& algo, const std::string& type)
+{
+    if(algo == "sum" or algo == "mean")
+        return {"0", "acc += ${x};", "+"};
+    if(algo == "prod")
+        return {"1", "acc *= ${x};", "*"};
+    if(algo == "max")
+        return {"std::numeric_limits<" + type + ">::lowest()",
+                "acc = std::max<" + type + ">(acc, ${x});",
+                "max"};
+    if(algo == "min")
+        return {"std::numeric_limits<" + type + ">::max()",
+                "acc = std::min<" + type + ">(acc, ${x});",
+                "min"};
+    MIGRAPHX_THROW("Unknown reduction: " + algo);
+}
+
+jit_kernel generate_reduce_kernel(const std::vector<instruction_ref>& ops,
+                                  const std::string& algo,
+                                  const std::vector<std::size_t>& axes,
+                                  const shape& output)
+{
+    assert(not ops.empty());
+    auto pf   = generate_point_function(ops);
+    auto type = shape::cpp_type(output.type());
+    auto ra   = get_reduce_algo(algo, type);
+    // View the output with the lens of the input, so every input element maps
+    // to the output element it is reduced into
+    auto lens    = ops.back()->get_shape().lens();
+    auto strides = output.strides();
+    for(auto axis : axes)
+        strides.at(axis) = 0;
+    auto shapes = to_shapes(pf.inputs);
+    shapes.push_back(shape{output.type(), lens, strides});
+    shapes          = reduce_dims(shapes);
+    const auto& out = shapes.back();
+    auto idx        = index_names(out.lens().size());
+    std::vector<std::size_t> kept;
+    std::vector<std::size_t> reduced;
+    for(std::size_t d = 0; d < out.lens().size(); d++)
+    {
+        if(out.strides()[d] == 0 and out.lens()[d] > 1)
+            reduced.push_back(d);
+        else
+            kept.push_back(d);
+    }
+    std::size_t n =
+        std::accumulate(reduced.begin(), reduced.end(), std::size_t{1}, [&](auto x, auto d) {
+            return x * out.lens()[d];
+        });
+
+    std::stringstream body;
+    std::size_t work = 1;
+    if(kept.empty())
+        body << loop("i", "start", "end");
+    for(std::size_t k = 0; k < kept.size(); k++)
+    {
+        auto d = kept[k];
+        if(k == 0)
+            body << loop(idx[d], "start", "end");
+        else
+            body << loop(idx[d], "0", std::to_string(out.lens()[d]));
+    }
+    if(not kept.empty())
+        work = out.lens()[kept.front()];
+    body << "{\n";
+    body << "    " << type << " acc = " << ra.init << ";\n";
+    for(std::size_t k = 0; k < reduced.size(); k++)
+    {
+        if(k == reduced.size() - 1)
+            body << "#pragma omp simd reduction(" << ra.reduction << ":acc)\n";
+        body << loop(idx[reduced[k]], "0", std::to_string(out.lens()[reduced[k]]));
+    }
+    body << "    " << interpolate_string(ra.combine, {{"x", point_call(pf, shapes, idx)}})
+         << "\n";
+    body << "    y[" << index_expr(out, idx) << "] = ";
+    if(algo == "mean")
+        body << "acc / " << type << "(" << n << ");\n";
+    else
+        body << "acc;\n";
+    body << "}";
+    auto result  = make_kernel("reduce", pf, output, body.str());
+    result.work  = work;
+    result.grain = std::max<std::size_t>(1, jit_min_work / (shapes.back().elements() / work));
+    return result;
+}
+
+static fs::path jit_cache_dir()
+{
+    auto dir = string_value_of(MIGRAPHX_CPU_JIT_CACHE{});
+    if(not dir.empty())
+        return dir;
+    // Each user has their own cache, since the libraries in it are loaded
+    return fs::temp_directory_path() / ("migraphx-cpu-jit-" + std::to_string(geteuid()));
+}
+
+// Whether the path is owned by the user, and nobody else can write to it.
+// Symlinks are not followed, so they are never trusted.
+static bool is_private(const fs::path& p, bool directory)
+{
+    struct stat st;
+    if(lstat(p.c_str(), &st) != 0)
+        return false;
+    if(directory ? not S_ISDIR(st.st_mode) : not S_ISREG(st.st_mode))
+        return false;
+    auto others = directory ? mode_t{S_IRWXG | S_IRWXO} : mode_t{S_IWGRP | S_IWOTH};
+    return st.st_uid == geteuid() and (st.st_mode & others) == 0;
+}
+
+// Creates the directory with access for the user only, if it does not exist
+static bool create_private_dir(const fs::path& dir)
+{
+    try
+    {
+        if(dir.has_parent_path())
+            fs::create_directories(dir.parent_path());
+    }
+    catch(const std::exception&)
+    {
+        return false;
+    }
+    if(mkdir(dir.c_str(), S_IRWXU) != 0 and errno != EEXIST)
+        return false;
+    return is_private(dir, true);
+}
+
+static std::vector<char> compile_library(const std::string& src)
+{
+    src_compiler compiler;
+    compiler.compiler = MIGRAPHX_STRINGIZE(MIGRAPHX_CPU_JIT_COMPILER);
+    compiler.flags    = jit_flags;
+    compiler.output   = "kernel.so";
+    src_file f;
+    f.path    = "kernel.cpp";
+    f.content = std::make_pair(src.data(), src.data() + src.size());
+    return compiler.compile({f});
+}
+
+// Write to a temporary file first, so other processes never load a partial file
+static void write_cache_file(const fs::path& p, const char* buffer, std::size_t size)
+{
+    auto tmp = p.parent_path() / unique_string(p.filename().string());
+    write_buffer(tmp.string(), buffer, size);
+    fs::rename(tmp, p);
+}
+
+static dynamic_loader load_or_compile(const std::string& src)
+{
+    std::stringstream key;
+    key << std::hex << std::hash<std::string>{}(jit_flags + src);
+    auto dir    = jit_cache_dir();
+    auto lib    = dir / (key.str() + ".so");
+    auto cpp    = dir / (key.str() + ".cpp");
+    bool cached = create_private_dir(dir);
+    // The source is kept next to the library to detect hash collisions
+    if(cached and is_private(lib, false) and is_private(cpp, false) and
+       read_string(cpp.string()) == src)
+        return dynamic_loader{lib};
+    auto image = compile_library(src);
+    if(not cached)
+        return dynamic_loader{image};
+    try
+    {
+        write_cache_file(lib, image.data(), image.size());
+        write_cache_file(cpp, src.data(), src.size());
+        return dynamic_loader{lib};
+    }
+    catch(const std::exception&)
+    {
+        // The library can still be used when the cache is not writable
+        return dynamic_loader{image};
+    }
+}
+
+dynamic_loader compile_jit(const std::string& src)
+{
+    static std::mutex m;
+    static std::unordered_map<std::string, dynamic_loader> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        auto it = loaded.find(src);
+        if(it != loaded.end())
+            return it->second;
+    }
+    // Compile without holding the lock, so several kernels can be compiled at once
+    auto lib = load_or_compile(src);
+    std::lock_guard<std::mutex> lock(m);
+    return loaded.emplace(src, lib).first->second;
+}
+
+struct jit_op
+{
+    std::string symbol_name;
+    std::string src;
+    std::size_t work  = 1;
+    std::size_t grain = 1;
+    std::vector<shape> shapes;
+    std::function<jit_function> f;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.symbol_name, "symbol_name"),
+                    f(self.src, "src"),
+                    f(self.work, "work"),
+                    f(self.grain, "grain"),
+                    f(self.shapes, "shapes"));
+    }
+
+    std::string name() const { return "cpu::jit"; }
+
+    // The strides are part of the generated source, so passes such as
+    // eliminate_contiguous cannot change the layout of the inputs
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty())
+            MIGRAPHX_THROW("JIT: Missing output buffer");
+        if(inputs != shapes)
+            MIGRAPHX_THROW("JIT: Kernel " + symbol_name +
+                           " was generated for different input shapes");
+        return inputs.back();
+    }
+
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        f = compile_jit(src).get_function<jit_function>(symbol_name);
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        std::vector<void*> ptrs(args.size());
+        std::transform(args.begin(), args.end(), ptrs.begin(), [](const argument& a) -> void* {
+            return a.data();
+        });
+        ctx.bulk_execute(work, grain, [&](auto start, auto end) { f(ptrs.data(), start, end); });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    // Print the kernel name instead of the source
+    friend std::ostream& operator<<(std::ostream& os, const jit_op& op)
+    {
+        os << op.name() << "[symbol_name=" << op.symbol_name << ",work=" << op.work
+           << ",grain=" << op.grain << "]";
+        return os;
+    }
+};
+MIGRAPHX_REGISTER_OP(jit_op);
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -16,6 +16,12 @@ struct dnnl_layernorm : dnnl_op<dnnl_layernorm, dnnl::layer_normalization_forwar
 
     std::string name() const { return "dnnl::layernorm"; }
 
+    // The last axis is normalized
+    bool is_row_input(const shape& output, const std::vector<shape>&, std::size_t) const
+    {
+        return output.lens().size() > 1;
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         // Compensate for allocation
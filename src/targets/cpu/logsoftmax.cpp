@@ -8,6 +8,11 @@ namespace cpu {
 
 struct dnnl_logsoftmax : dnnl_extend_op<dnnl_logsoftmax, dnnl::logsoftmax_forward, op::logsoftmax>
 {
+    bool is_row_input(const shape&, const std::vector<shape>&, std::size_t) const
+    {
+        return this->op.axis != 0;
+    }
+
     dnnl::logsoftmax_forward::desc
     get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
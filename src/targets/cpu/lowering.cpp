@@ -25,14 +25,21 @@
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
 #include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/jit.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/split_batch.hpp>
 #include <migraphx/tune_axis.hpp>
 #include <migraphx/match/layernorm.hpp>
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
+#include <migraphx/match/attention.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/par_for.hpp>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -41,6 +48,9 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_CPU_ATTENTION)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_CPU_JIT)
+
 template <typename T>
 T zero(const T&)
 {
@@ -294,10 +304,17 @@ struct cpu_apply
     std::unordered_map<instruction_ref, std::string> prog_output_names{};
     instruction_ref last{};
 
+    // Name the outputs of the main module, so their allocations are replaced
+    // with parameters that the caller can bind its own buffers to. The
+    // outputs of the sub-batch modules are named as well, since run_parallel
+    // binds them to the part of its outputs that each sub-batch writes. The
+    // outputs of other submodules are still allocated, since the ops that run
+    // them do not pass output buffers.
     void create_output_names()
     {
         this->last = instruction::get_output_alias(std::prev(modl->end()));
-        if(this->last->name() == "@return")
+        if(this->last->name() == "@return" and
+           (modl->name() == "main" or is_batch_module(*modl)))
         {
             const auto& prog_outputs = last->inputs();
             std::vector<instruction_ref> outputs_alias(prog_outputs.size());
@@ -307,10 +324,13 @@ struct cpu_apply
                            outputs_alias.begin(),
                            [](const auto& i) { return instruction::get_output_alias(i); });
 
+            // An instruction that is returned more than once keeps the name of
+            // its first output, and the outputs after it alias that buffer
             std::size_t index = 0;
             for(auto ins : outputs_alias)
             {
-                prog_output_names[ins] = modl->name() + ":#output_" + std::to_string(index++);
+                prog_output_names.emplace(ins,
+                                          modl->name() + ":#output_" + std::to_string(index++));
             }
         }
     }
@@ -343,6 +363,56 @@ struct cpu_apply
         }
     }
 
+    // Whether dnnl has an implementation of op for these shapes
+    static bool dnnl_accepts(const operation& op, std::vector<shape> inputs, const shape& output)
+    {
+        inputs.push_back(output);
+        try
+        {
+            return op.compute_shape(inputs) == output;
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    // Uses dnnl for the reductions it accepts, and the native reduction
+    // engine for the others
+    void extend_reduce(const std::string& op_name,
+                       const std::string& algo,
+                       const std::string& dnnl_algo = "")
+    {
+        apply_map.emplace(op_name, [=](instruction_ref ins) {
+            auto v = ins->get_operator().to_value();
+            // argmax and argmin reduce a single axis
+            auto axes = v.contains("axis") ? value::array{v.at("axis")} : v.at("axes");
+            if(not dnnl_algo.empty())
+            {
+                auto op = make_op("dnnl::reduction", {{"algo", dnnl_algo}, {"axes", axes}});
+                if(dnnl_accepts(op, to_shapes(ins->inputs()), ins->get_shape()))
+                    return replace(ins, op);
+            }
+            return replace(ins, make_op("cpu::reduce", {{"algo", algo}, {"axes", axes}}));
+        });
+    }
+
+    // dnnl is used for the last axis, and the native kernel for the others
+    void extend_softmax(const std::string& op_name, const std::string& dnnl_name, bool log)
+    {
+        apply_map.emplace(op_name, [=](instruction_ref ins) {
+            auto v    = ins->get_operator().to_value();
+            auto axis = v.at("axis").to<std::size_t>();
+            if(axis + 1 == ins->get_shape().lens().size())
+            {
+                auto op = make_op(dnnl_name, v);
+                if(dnnl_accepts(op, to_shapes(ins->inputs()), ins->get_shape()))
+                    return replace(ins, op);
+            }
+            return replace(ins, make_op("cpu::softmax", {{"axis", axis}, {"log", log}}));
+        });
+    }
+
     template <class M>
     auto fuse_match(M matcher, const operation& op, const std::vector<std::string>& bind_inputs)
     {
@@ -358,6 +428,74 @@ struct cpu_apply
         });
     }
 
+    auto fuse_attention()
+    {
+        return match::make_match_finder(match::attention(), [=](auto&, const auto& r) {
+            auto ins   = r.result;
+            auto probs = r.instructions["probs"];
+            auto rank  = ins->get_shape().lens().size();
+            if(enabled(MIGRAPHX_DISABLE_CPU_ATTENTION{}) or
+               probs->get_operator().to_value().at("axis").template to<std::size_t>() != rank - 1)
+                return;
+            float scale = 1.0f;
+            if(contains(r.instructions, "scale"))
+            {
+                auto x = read_scalar<float>(r.instructions["scale"]);
+                if(x.empty())
+                    return;
+                scale = x.front();
+            }
+            std::vector<instruction_ref> inputs = {
+                r.instructions["q"], r.instructions["k"], r.instructions["v"]};
+            bool masked = contains(r.instructions, "mask");
+            if(masked)
+                inputs.push_back(r.instructions["mask"]);
+            inputs.push_back(this->insert_allocation(ins, ins->get_shape()));
+            modl->replace_instruction(
+                ins, make_op("cpu::attention", {{"scale", scale}, {"masked", masked}}), inputs);
+        });
+    }
+
+    static instruction_ref skip_broadcasts(instruction_ref ins)
+    {
+        while(contains({"broadcast", "multibroadcast"}, ins->name()))
+            ins = ins->inputs().front();
+        return ins;
+    }
+
+    // dnnl normalizes over the last axis, so the native kernel, which
+    // computes the mean and variance in one pass, is used for other axes
+    auto fuse_layernorm()
+    {
+        return match::make_match_finder(match::layernorm(), [=](auto&, const auto& r) {
+            auto ins  = r.result;
+            auto x    = r.instructions["x"];
+            auto mean = skip_broadcasts(ins->inputs()[0]->inputs()[1]);
+            auto sd   = skip_broadcasts(ins->inputs()[1]);
+            if(sd->get_shape().lens() != mean->get_shape().lens())
+                return;
+            auto rank = x->get_shape().lens().size();
+            auto axes =
+                mean->get_operator().to_value().at("axes").template to_vector<std::int64_t>();
+            if(axes.empty())
+            {
+                axes.resize(rank);
+                std::iota(axes.begin(), axes.end(), 0);
+            }
+            auto alloc = this->insert_allocation(ins, ins->get_shape());
+            if(axes == std::vector<std::int64_t>{std::int64_t(rank - 1)})
+            {
+                auto op = make_op("dnnl::layernorm");
+                if(dnnl_accepts(op, {x->get_shape()}, ins->get_shape()))
+                {
+                    modl->replace_instruction(ins, op, x, alloc);
+                    return;
+                }
+            }
+            modl->replace_instruction(ins, make_op("cpu::layernorm", {{"axes", axes}}), x, alloc);
+        });
+    }
+
     void init()
     {
         create_output_names();
@@ -381,13 +519,15 @@ struct cpu_apply
                               {"tanh", "eltwise_tanh"},
                           });
 
-        extend_dnnl_algos("dnnl::reduction",
-                          {
-                              {"reduce_max", "reduction_max"},
-                              {"reduce_mean", "reduction_mean"},
-                              {"reduce_min", "reduction_min"},
-                              {"reduce_sum", "reduction_sum"},
-                          });
+        extend_reduce("reduce_max", "max", "reduction_max");
+        extend_reduce("reduce_mean", "mean", "reduction_mean");
+        extend_reduce("reduce_min", "min", "reduction_min");
+        extend_reduce("reduce_sum", "sum", "reduction_sum");
+        extend_reduce("reduce_prod", "prod");
+        extend_reduce("argmax", "argmax");
+        extend_reduce("argmin", "argmin");
+        extend_softmax("softmax", "dnnl::softmax", false);
+        extend_softmax("logsoftmax", "dnnl::logsoftmax", true);
 
         extend_op("concat", "dnnl::concat");
         extend_op("contiguous", "dnnl::reorder");
@@ -398,15 +538,20 @@ struct cpu_apply
 #endif
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
-        extend_op("logsoftmax", "dnnl::logsoftmax");
+        extend_op("layout", "dnnl::layout");
         extend_op("lrn", "dnnl::lrn");
-        extend_op("softmax", "dnnl::softmax");
+        extend_op("prefix_scan_sum", "cpu::prefix_scan_sum");
+        extend_op("sparse_dot", "cpu::sparse_dot");
         extend_op("sub", "cpu::sub");
+        extend_op("weight_dot", "cpu::weight_dot");
 
         extend_op("im2col", "cpu::im2col", false);
         extend_op("leaky_relu", "cpu::leaky_relu", false);
+        extend_op("nonmaxsuppression", "cpu::nonmaxsuppression", false);
         extend_op("pad", "cpu::pad", false);
         extend_op("rnn_var_sl_last_output", "cpu::rnn_var_sl_last_output", false);
+        extend_op("roialign", "cpu::roialign", false);
+        extend_op("topk", "cpu::topk", false);
     }
 
     void apply()
@@ -414,13 +559,16 @@ struct cpu_apply
         init();
         // Apply fusion matchers first
         match::find_matches(*modl,
+                            fuse_attention(),
                             fuse_match(match::gelu_erf(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_erf"}}),
                                        {"x"}),
                             fuse_match(match::gelu_tanh(),
                                        make_op("dnnl::eltwise", {{"algo", "eltwise_gelu_tanh"}}),
                                        {"x"}),
-                            fuse_match(match::layernorm(), make_op("dnnl::layernorm"), {"x"}));
+                            fuse_layernorm());
+        if(enabled(MIGRAPHX_ENABLE_CPU_JIT{}))
+            apply_jit();
         // Apply these operators first so the inputs can be const folded
         for(auto it : iterator_for(*modl))
         {
@@ -435,13 +583,192 @@ struct cpu_apply
             {
                 apply_pooling(it);
             }
+            else if(it->name() == "run_parallel")
+            {
+                apply_run_parallel(it);
+            }
             else if(apply_map.count(it->name()) > 0)
             {
                 apply_map.at(it->name())(it);
             }
+            else if(it->get_operator().attributes().get("custom_op", false))
+            {
+                apply_custom_op(it);
+            }
+        }
+    }
+
+    struct jit_group
+    {
+        std::vector<instruction_ref> ops;
+        // The reduction of the last op, or the end of the module
+        instruction_ref reduce;
+    };
+
+    static bool is_jit_pointwise(instruction_ref ins)
+    {
+        auto attributes = ins->get_operator().attributes();
+        if(not attributes.get("pointwise", false) or
+           attributes.get("point_op", std::string{}).empty())
+            return false;
+        auto inputs = ins->inputs();
+        inputs.push_back(ins);
+        return std::none_of(inputs.begin(), inputs.end(), [](auto x) {
+            auto t = x->get_shape().type();
+            return t == shape::half_type or t == shape::tuple_type;
+        });
+    }
+
+    // Pointwise ops after these are left to be fused as dnnl post ops
+    static bool is_post_op(instruction_ref ins)
+    {
+        return std::any_of(ins->inputs().begin(), ins->inputs().end(), [](auto input) {
+            return contains({"convolution", "deconvolution", "dot"}, input->name()) and
+                   input->outputs().size() == 1;
+        });
+    }
+
+    jit_kernel generate_jit_kernel(const jit_group& g) const
+    {
+        if(g.reduce == modl->end())
+            return generate_pointwise_kernel(g.ops, g.ops.back()->get_shape());
+        auto v    = g.reduce->get_operator().to_value();
+        auto rank = static_cast<std::int64_t>(g.ops.back()->get_shape().lens().size());
+        std::vector<std::size_t> axes;
+        for(auto axis : v["axes"].to_vector<std::int64_t>())
+            axes.push_back(axis < 0 ? axis + rank : axis);
+        // No axes reduces all of them
+        if(axes.empty())
+        {
+            axes.resize(rank);
+            std::iota(axes.begin(), axes.end(), 0);
+        }
+        auto algo = g.reduce->name().substr(std::string{"reduce_"}.size());
+        return generate_reduce_kernel(g.ops, algo, axes, g.reduce->get_shape());
+    }
+
+    // Fuse chains of pointwise ops, and the reductions of them, into kernels
+    // that are generated as C++ and compiled with the host compiler
+    void apply_jit()
+    {
+        std::vector<jit_group> groups;
+        std::unordered_map<instruction_ref, std::size_t> root_group;
+        for(auto ins : iterator_for(*modl))
+        {
+            if(contains({"reduce_sum", "reduce_mean", "reduce_max", "reduce_min", "reduce_prod"},
+                        ins->name()))
+            {
+                auto input = ins->inputs().front();
+                if(contains(root_group, input) and input->outputs().size() == 1)
+                    groups[root_group.at(input)].reduce = ins;
+                continue;
+            }
+            if(not is_jit_pointwise(ins) or is_post_op(ins))
+                continue;
+            // Join the groups whose result is only used by this op
+            std::vector<instruction_ref> ops;
+            for(auto input : ins->inputs())
+            {
+                if(not contains(root_group, input) or input->outputs().size() != 1)
+                    continue;
+                auto& g = groups[root_group.at(input)];
+                ops.insert(ops.end(), g.ops.begin(), g.ops.end());
+                g.ops.clear();
+                root_group.erase(input);
+            }
+            ops.push_back(ins);
+            root_group[ins] = groups.size();
+            groups.push_back({ops, modl->end()});
+        }
+        // A single op is only compiled when there is no other lowering for it
+        groups.erase(std::remove_if(groups.begin(),
+                                    groups.end(),
+                                    [&](const jit_group& g) {
+                                        if(g.ops.empty())
+                                            return true;
+                                        return g.ops.size() == 1 and g.reduce == modl->end() and
+                                               apply_map.count(g.ops.front()->name()) > 0;
+                                    }),
+                     groups.end());
+
+        std::vector<jit_kernel> kernels;
+        std::transform(groups.begin(),
+                       groups.end(),
+                       std::back_inserter(kernels),
+                       [&](const auto& g) { return generate_jit_kernel(g); });
+        // Ops whose kernel fails to compile are lowered as usual
+        std::vector<int> compiled(kernels.size(), 0);
+        par_for(kernels.size(), 1, [&](auto i) {
+            try
+            {
+                compile_jit(kernels[i].src);
+                compiled[i] = 1;
+            }
+            catch(const std::exception&)
+            {
+            }
+        });
+        for(std::size_t i = 0; i < groups.size(); i++)
+        {
+            if(compiled[i] == 0)
+                continue;
+            const auto& g = groups[i];
+            const auto& k = kernels[i];
+            auto root     = g.reduce == modl->end() ? g.ops.back() : g.reduce;
+            auto inputs   = k.inputs;
+            inputs.push_back(insert_allocation(root, root->get_shape()));
+            modl->replace_instruction(root,
+                                      make_op("cpu::jit",
+                                              {{"symbol_name", k.symbol_name},
+                                               {"src", k.src},
+                                               {"work", k.work},
+                                               {"grain", k.grain},
+                                               {"shapes", migraphx::to_value(k.shapes)}}),
+                                      inputs);
+            std::for_each(g.ops.rbegin(), g.ops.rend(), [&](auto ins) {
+                if(ins != root and ins->outputs().empty())
+                    modl->remove_instruction(ins);
+            });
         }
     }
 
+    // Pass the output buffer of a custom op as its last input, so the output
+    // is planned by memory_coloring instead of allocated on every call
+    instruction_ref apply_custom_op(instruction_ref ins) const
+    {
+        auto op = ins->get_operator();
+        if(op.output_alias(to_shapes(ins->inputs())) >= 0)
+            return ins;
+        return replace(ins, make_op(op.name(), {{"output_buffer", true}}));
+    }
+
+    // The sub-batches write straight into the outputs of the main module, so
+    // it is only lowered when each of its outputs is returned
+    instruction_ref apply_run_parallel(instruction_ref ins) const
+    {
+        auto ret = std::prev(modl->end());
+        if(modl->name() != "main" or ret->name() != "@return")
+            return ins;
+        const auto& sub_shapes = ins->get_shape().sub_shapes();
+        std::vector<instruction_ref> outputs(sub_shapes.size(), modl->end());
+        for(std::size_t i = 0; i < ret->inputs().size(); i++)
+        {
+            auto output = ret->inputs()[i];
+            if(output->name() != "get_tuple_elem" or output->inputs().front() != ins)
+                continue;
+            auto j = output->get_operator().to_value().at("index").to<std::size_t>();
+            if(outputs[j] == modl->end())
+                outputs[j] = modl->add_parameter(modl->name() + ":#output_" + std::to_string(i),
+                                                 sub_shapes[j]);
+        }
+        if(contains(outputs, modl->end()))
+            return ins;
+        auto inputs = ins->inputs();
+        inputs.insert(inputs.end(), outputs.begin(), outputs.end());
+        auto op = make_op("cpu::run_parallel", ins->get_operator().to_value());
+        return modl->replace_instruction(ins, op, inputs, ins->module_inputs());
+    }
+
     instruction_ref apply_pow(instruction_ref ins) const
     {
         auto beta = read_scalar<float>(ins->inputs()[1]);
@@ -490,6 +817,9 @@ struct cpu_apply
 
     instruction_ref insert_allocation(instruction_ref ins, const shape& s) const
     {
+        auto ins_alias = instruction::get_output_alias(ins);
+        if(prog_output_names.count(ins_alias) > 0)
+            return modl->add_parameter(prog_output_names.at(ins_alias), s);
         return modl->insert_instruction(ins, make_op("cpu::allocate", {{"shape", to_value(s)}}));
     }
 };
@@ -0,0 +1,179 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/nonmaxsuppression.hpp>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Boxes stored as separate arrays of sorted corners, so the iou of one box
+// against all the boxes can be computed in a loop without branches
+struct box_corners
+{
+    std::vector<float> x0;
+    std::vector<float> y0;
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> area;
+
+    void reserve(std::size_t n)
+    {
+        for(auto* v : {&x0, &y0, &x1, &y1, &area})
+            v->reserve(n);
+    }
+
+    void clear()
+    {
+        for(auto* v : {&x0, &y0, &x1, &y1, &area})
+            v->clear();
+    }
+
+    std::size_t size() const { return x0.size(); }
+
+    void push_back(op::nonmaxsuppression::box b)
+    {
+        b.sort();
+        x0.push_back(b.x[0]);
+        x1.push_back(b.x[1]);
+        y0.push_back(b.y[0]);
+        y1.push_back(b.y[1]);
+        area.push_back(b.area());
+    }
+
+    void push_back(const box_corners& boxes, std::size_t i)
+    {
+        x0.push_back(boxes.x0[i]);
+        x1.push_back(boxes.x1[i]);
+        y0.push_back(boxes.y0[i]);
+        y1.push_back(boxes.y1[i]);
+        area.push_back(boxes.area[i]);
+    }
+
+    // Same as nonmaxsuppression::suppress_by_iou for box i of boxes against
+    // every box in this set
+    bool suppress(const box_corners& boxes, std::size_t i, float iou_threshold) const
+    {
+        const float bx0   = boxes.x0[i];
+        const float bx1   = boxes.x1[i];
+        const float by0   = boxes.y0[i];
+        const float by1   = boxes.y1[i];
+        const float barea = boxes.area[i];
+        bool result       = false;
+        for(std::size_t j = 0; j < size(); j++)
+        {
+            const float ix0               = std::max(bx0, x0[j]);
+            const float ix1               = std::min(bx1, x1[j]);
+            const float iy0               = std::max(by0, y0[j]);
+            const float iy1               = std::min(by1, y1[j]);
+            const float intersection_area = (ix1 - ix0) * (iy1 - iy0);
+            const float union_area        = barea + area[j] - intersection_area;
+            const bool valid = ix0 <= ix1 and iy0 <= iy1 and barea > .0f and area[j] > .0f and
+                               union_area > .0f;
+            result |= valid and intersection_area / union_area > iou_threshold;
+        }
+        return result;
+    }
+};
+
+struct cpu_nonmaxsuppression : auto_register_op<cpu_nonmaxsuppression>
+{
+    op::nonmaxsuppression op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::nonmaxsuppression"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        return op.compute_shape(std::move(inputs));
+    }
+
+    // The boxes are converted to corners once per batch, the candidates of
+    // each class are sorted once, and each class is processed in parallel
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        result.visit([&](auto out) { std::fill(out.begin(), out.end(), 0); });
+
+        std::size_t max_output_boxes_per_class = 0;
+        float iou_threshold                    = 0.0f;
+        float score_threshold                  = 0.0f;
+        if(args.size() > 2)
+            max_output_boxes_per_class = args.at(2).at<std::size_t>();
+        if(max_output_boxes_per_class == 0)
+            return result;
+        if(args.size() > 3)
+            iou_threshold = args.at(3).at<float>();
+        if(args.size() > 4)
+            score_threshold = args.at(4).at<float>();
+
+        const auto& lens   = args.at(1).get_shape().lens();
+        auto batch_num     = lens[0];
+        auto class_num     = lens[1];
+        auto box_num       = args.at(0).get_shape().lens()[1];
+        const float* boxes = args.at(0).cast<float>();
+        const float* score = args.at(1).cast<float>();
+
+        std::vector<box_corners> batch_boxes(batch_num);
+        ctx.bulk_execute(batch_num, 1, [&](auto start, auto end) {
+            for(auto b = start; b < end; b++)
+            {
+                batch_boxes[b].reserve(box_num);
+                for(std::size_t i = 0; i < box_num; i++)
+                    batch_boxes[b].push_back(op.batch_box(boxes + b * box_num * 4, i));
+            }
+        });
+
+        std::vector<std::vector<int64_t>> selected(batch_num * class_num);
+        ctx.bulk_execute(batch_num * class_num, 1, [&](auto start, auto end) {
+            std::vector<std::pair<float, int64_t>> candidates;
+            box_corners kept;
+            candidates.reserve(box_num);
+            kept.reserve(std::min(box_num, max_output_boxes_per_class));
+            for(auto bc = start; bc < end; bc++)
+            {
+                auto bidx              = bc / class_num;
+                auto cidx              = bc % class_num;
+                const float* bc_scores = score + bc * box_num;
+                const auto& corners    = batch_boxes[bidx];
+                candidates.clear();
+                for(std::size_t i = 0; i < box_num; i++)
+                {
+                    if(bc_scores[i] >= score_threshold)
+                        candidates.emplace_back(bc_scores[i], i);
+                }
+                // Same order that the boxes come out of the priority queue in the reference
+                std::sort(candidates.begin(), candidates.end(), std::greater<>{});
+                kept.clear();
+                for(const auto& candidate : candidates)
+                {
+                    if(kept.size() >= max_output_boxes_per_class)
+                        break;
+                    if(kept.suppress(corners, candidate.second, iou_threshold))
+                        continue;
+                    kept.push_back(corners, candidate.second);
+                    selected[bc].insert(selected[bc].end(),
+                                        {int64_t(bidx), int64_t(cidx), candidate.second});
+                }
+            }
+        });
+
+        result.visit([&](auto out) {
+            auto it = out.begin();
+            for(const auto& s : selected)
+                it = std::copy(s.begin(), s.end(), it);
+        });
+        return result;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,246 @@
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <sched.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Parse a list of ranges of cpus, such as "0-3,8-11"
+static std::vector<std::size_t> parse_cpu_list(const std::string& s)
+{
+    std::vector<std::size_t> result;
+    for(auto&& r : split_string(trim(s), ','))
+    {
+        auto range = split_string(r, '-');
+        if(range.empty() or range.front().empty())
+            continue;
+        std::size_t first = std::stoul(range.front());
+        std::size_t last  = range.size() > 1 ? std::stoul(range.back()) : first;
+        for(auto i = first; i <= last; i++)
+            result.push_back(i);
+    }
+    return result;
+}
+
+std::vector<std::size_t> allowed_cpus()
+{
+    std::vector<std::size_t> result;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for(std::size_t i = 0; i < CPU_SETSIZE; i++)
+        {
+            if(CPU_ISSET(i, &set))
+                result.push_back(i);
+        }
+    }
+    if(result.empty())
+    {
+        result.resize(std::max(std::thread::hardware_concurrency(), 1u));
+        std::iota(result.begin(), result.end(), 0);
+    }
+    return result;
+}
+
+static std::vector<std::vector<std::size_t>> find_numa_nodes()
+{
+    auto allowed = allowed_cpus();
+    std::vector<std::pair<std::size_t, std::vector<std::size_t>>> nodes;
+    const fs::path root = "/sys/devices/system/node";
+    std::error_code ec;
+    for(fs::directory_iterator it{root, ec}, end; not ec and it != end; it.increment(ec))
+    {
+        auto name = it->path().filename().string();
+        if(not starts_with(name, "node") or name.size() == 4 or
+           not std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(c); }))
+            continue;
+        std::ifstream is((it->path() / "cpulist").string());
+        std::string line;
+        std::getline(is, line);
+        std::vector<std::size_t> cpus;
+        for(auto cpu : parse_cpu_list(line))
+        {
+            if(std::binary_search(allowed.begin(), allowed.end(), cpu))
+                cpus.push_back(cpu);
+        }
+        // Skip nodes that only have memory or that this process cannot use
+        if(cpus.empty())
+            continue;
+        nodes.emplace_back(std::stoul(name.substr(4)), cpus);
+    }
+    std::sort(nodes.begin(), nodes.end());
+    std::vector<std::vector<std::size_t>> result;
+    std::transform(nodes.begin(), nodes.end(), std::back_inserter(result), [](auto& p) {
+        return std::move(p.second);
+    });
+    if(result.empty())
+        result.push_back(allowed);
+    return result;
+}
+
+static const std::vector<std::vector<std::size_t>>& numa_nodes()
+{
+    static const auto nodes = find_numa_nodes();
+    return nodes;
+}
+
+std::size_t numa_node_count() { return numa_nodes().size(); }
+
+const std::vector<std::size_t>& numa_node_cpus(std::size_t node)
+{
+    if(node >= numa_node_count())
+        MIGRAPHX_THROW("Invalid numa node " + std::to_string(node) + ", there are only " +
+                       std::to_string(numa_node_count()) + " nodes");
+    return numa_nodes()[node];
+}
+
+static void set_affinity(const std::vector<std::size_t>& cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto cpu : cpus)
+    {
+        if(cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+    // Running unbound is still correct, so a failure is not an error
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+static int get_num_threads()
+{
+#ifndef MIGRAPHX_DISABLE_OMP
+    return omp_get_max_threads();
+#else
+    return 0;
+#endif
+}
+
+static void set_num_threads(int n)
+{
+#ifndef MIGRAPHX_DISABLE_OMP
+    omp_set_num_threads(n);
+#else
+    (void)n;
+#endif
+}
+
+// The cpus and the number of threads the calling thread was bound to here,
+// or nothing when it has not been bound
+struct thread_binding
+{
+    std::vector<std::size_t> cpus;
+    int threads = 0;
+};
+
+static thread_binding& current_binding()
+{
+    thread_local thread_binding binding; // NOLINT
+    return binding;
+}
+
+static void bind_cpus(const std::vector<std::size_t>& cpus)
+{
+    set_affinity(cpus);
+    set_num_threads(cpus.size());
+    auto& current   = current_binding();
+    current.cpus    = cpus;
+    current.threads = cpus.size();
+    std::sort(current.cpus.begin(), current.cpus.end());
+}
+
+static std::vector<std::size_t>& thread_dedicated_cpus()
+{
+    thread_local std::vector<std::size_t> cpus; // NOLINT
+    return cpus;
+}
+
+void bind_to_cpus(const std::vector<std::size_t>& cpus)
+{
+    bind_cpus(cpus);
+    thread_dedicated_cpus() = cpus;
+}
+
+const std::vector<std::size_t>& dedicated_cpus() { return thread_dedicated_cpus(); }
+
+void bind_pool_thread(const std::vector<std::size_t>& cpus)
+{
+    // The affinity of the thread before it was first bound
+    thread_local std::vector<std::size_t> original; // NOLINT
+    thread_local std::vector<std::size_t> bound;    // NOLINT
+    if(cpus == bound)
+        return;
+    if(bound.empty())
+        original = allowed_cpus();
+    set_affinity(cpus.empty() ? original : cpus);
+    bound = cpus;
+}
+
+scoped_cpu_binding::scoped_cpu_binding(const std::vector<std::size_t>& cpus)
+{
+    auto sorted         = cpus;
+    const auto& current = current_binding();
+    std::sort(sorted.begin(), sorted.end());
+    // Nothing to do when the thread is already bound to the cpus, such as in a
+    // kernel that is run from another kernel or on the worker of a sub-batch
+    if(sorted == current.cpus and current.threads == static_cast<int>(cpus.size()))
+        return;
+    previous_bound   = not current.cpus.empty();
+    previous_cpus    = previous_bound ? current.cpus : allowed_cpus();
+    previous_threads = previous_bound ? current.threads : get_num_threads();
+    bind_cpus(cpus);
+    bound = true;
+}
+
+scoped_cpu_binding::~scoped_cpu_binding()
+{
+    if(not bound)
+        return;
+    set_affinity(previous_cpus);
+    set_num_threads(previous_threads);
+    auto& current = current_binding();
+    if(previous_bound)
+        current = {previous_cpus, previous_threads};
+    else
+        current = {};
+}
+
+numa_replicas::numa_replicas()
+    : replicas(numa_node_count()), flags(std::make_unique<std::once_flag[]>(numa_node_count()))
+{
+}
+
+argument numa_replicas::get(const argument& a, std::size_t node)
+{
+    if(a.get_shape().type() == shape::tuple_type or a.empty())
+        return a;
+    assert(node < replicas.size());
+    std::call_once(flags[node], [&] {
+        scoped_cpu_binding binding{numa_node_cpus(node)};
+        // The buffer is not taken from the argument pool, since its pages may
+        // already have been touched by a thread on another node
+        const auto& s = a.get_shape();
+        argument r{s, make_shared_array<char>(s.bytes())};
+        std::memcpy(r.data(), a.data(), s.bytes());
+        replicas[node] = r;
+    });
+    return replicas[node];
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,588 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/extent.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/type_traits.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Number of elements each thread should at least process
+const std::size_t min_work = 16384;
+
+// Offsets of the elements spanned by the dimensions in axes, in standard order
+static std::vector<std::size_t> axes_offsets(const shape& s, const std::vector<std::size_t>& axes)
+{
+    if(axes.empty())
+        return {0};
+    std::vector<std::size_t> lens;
+    std::vector<std::size_t> strides;
+    for(auto axis : axes)
+    {
+        lens.push_back(s.lens()[axis]);
+        strides.push_back(s.strides()[axis]);
+    }
+    shape ss{s.type(), lens, strides};
+    std::vector<std::size_t> result(ss.elements());
+    for(std::size_t i = 0; i < result.size(); i++)
+        result[i] = ss.index(i);
+    return result;
+}
+
+static bool is_contiguous(const std::vector<std::size_t>& offsets)
+{
+    for(std::size_t i = 0; i < offsets.size(); i++)
+    {
+        if(offsets[i] != i)
+            return false;
+    }
+    return true;
+}
+
+// Splits the elements of a tensor into groups that are reduced together. The
+// elements of group g start at kept[g] and are at reduced[j] from there. The
+// output uses the same groups, so it can either have the reduced dimensions
+// set to 1 or have the same dimensions as the input.
+//
+// A group is processed as:
+// - a row, when its elements are contiguous, so the inner loop is over
+//   consecutive elements
+// - a column, when the groups are next to each other in memory, so the inner
+//   loop runs over several groups at once
+// - strided, using the offsets of the elements, for any other layout
+struct reduce_plan
+{
+    std::vector<std::size_t> in_kept;
+    std::vector<std::size_t> in_reduced;
+    std::vector<std::size_t> out_kept;
+    std::vector<std::size_t> out_reduced;
+    bool row = false;
+    // Number of consecutive groups that are processed together
+    std::size_t column = 1;
+
+    reduce_plan(const shape& input, const shape& output, const std::vector<std::size_t>& axes)
+    {
+        std::vector<std::size_t> kept;
+        for(std::size_t i = 0; i < input.lens().size(); i++)
+        {
+            if(not contains(axes, i))
+                kept.push_back(i);
+        }
+        in_kept     = axes_offsets(input, kept);
+        in_reduced  = axes_offsets(input, axes);
+        out_kept    = axes_offsets(output, kept);
+        out_reduced = axes_offsets(output, axes);
+        row         = is_contiguous(in_reduced) and is_contiguous(out_reduced);
+        if(row or kept.empty())
+            return;
+        auto k = kept.back();
+        if(input.lens()[k] > 1 and input.strides()[k] == 1 and output.strides()[k] == 1)
+            column = input.lens()[k];
+    }
+
+    std::size_t groups() const { return in_kept.size(); }
+    std::size_t size() const { return in_reduced.size(); }
+
+    // Splits the blocks of column groups between threads, so each thread
+    // has enough work, and calls f(start, end) with the blocks of a thread.
+    // Block i starts at group i * column.
+    template <class F>
+    void for_each(context& ctx, F f) const
+    {
+        auto work  = std::max<std::size_t>(1, size() * column);
+        auto grain = std::max<std::size_t>(1, min_work / work);
+        ctx.bulk_execute(groups() / column, grain, f);
+    }
+};
+
+static std::vector<std::size_t> to_axes(const std::vector<std::int64_t>& axes, std::size_t rank)
+{
+    std::vector<std::size_t> result(axes.begin(), axes.end());
+    // No axes reduces all of them
+    if(result.empty())
+    {
+        result.resize(rank);
+        std::iota(result.begin(), result.end(), 0);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Calls f with the input and the output. When the input is padded on axes
+// that are not reduced, f only gets the groups in its extent, and the rest of
+// the output is set to zero. That is only done when f gives zero for a group
+// of zeros, as it does for all but softmax, or else f gets all of the groups.
+// The reduced axes are always used whole.
+template <class F>
+static argument
+apply_extent(const std::vector<argument>& args, const std::vector<std::size_t>& axes, F f)
+{
+    const auto& input  = args.front();
+    const auto& output = args.back();
+    if(not use_extent() or not input.padded())
+    {
+        f(input, output);
+        return output;
+    }
+    auto extent        = input.extent();
+    auto output_extent = output.get_shape().lens();
+    for(std::size_t i = 0; i < extent.size(); i++)
+    {
+        if(contains(axes, i))
+            extent[i] = input.get_shape().lens()[i];
+        else
+            output_extent[i] = extent[i];
+    }
+    if(output_extent == output.get_shape().lens())
+    {
+        f(input, output);
+        return output;
+    }
+    // Compute one group of the padding
+    auto group        = input.get_shape().lens();
+    auto output_group = output.get_shape().lens();
+    for(std::size_t i = 0; i < group.size(); i++)
+    {
+        if(contains(axes, i))
+            continue;
+        group[i]        = 1;
+        output_group[i] = 1;
+    }
+    argument padding{shape{output.get_shape().type(), output_group}};
+    f(fill_argument(shape{input.get_shape().type(), group}), padding);
+    if(not all_zero(padding))
+    {
+        f(input, output);
+        return output;
+    }
+    f(input.reshape(extent_shape(input.get_shape(), extent)),
+      output.reshape(extent_shape(output.get_shape(), output_extent)));
+    auto result = output.with_extent(output_extent);
+    zero_padding(result);
+    return result;
+}
+
+template <class Init, class Op, class Output>
+struct reducer
+{
+    Init init;
+    Op op;
+    Output output;
+};
+
+template <class Init, class Op, class Output>
+reducer<Init, Op, Output> make_reducer(Init init, Op op, Output output)
+{
+    return {init, op, output};
+}
+
+template <class T, class F>
+void visit_reducer(const std::string& algo, F f)
+{
+    using acc = accumulator_type<T>;
+    auto sum  = [](acc x, T y) { return x + acc(y); };
+    auto same = [](auto x, std::size_t) { return x; };
+    auto mean = [](acc x, std::size_t n) { return x / acc(n); };
+    if(algo == "sum")
+        f(make_reducer([] { return acc(0); }, sum, same));
+    else if(algo == "mean")
+        f(make_reducer([] { return acc(0); }, sum, mean));
+    else if(algo == "prod")
+        f(make_reducer([] { return acc(1); }, [](acc x, T y) { return x * acc(y); }, same));
+    else if(algo == "max")
+        f(make_reducer([] { return std::numeric_limits<T>::lowest(); },
+                       [](T x, T y) { return std::max(x, y); },
+                       same));
+    else if(algo == "min")
+        f(make_reducer([] { return std::numeric_limits<T>::max(); },
+                       [](T x, T y) { return std::min(x, y); },
+                       same));
+    else
+        MIGRAPHX_THROW("REDUCE: Unknown algo: " + algo);
+}
+
+template <class T, class U, class Reducer>
+void reduce_kernel(context& ctx, const reduce_plan& plan, const T* in, U* out, Reducer r)
+{
+    using acc_type = decltype(r.init());
+    auto n         = plan.size();
+    auto c         = plan.column;
+    plan.for_each(ctx, [&](auto start, auto end) {
+        std::vector<acc_type> acc(c);
+        for(auto i = start; i < end; i++)
+        {
+            const T* x = in + plan.in_kept[i * c];
+            U* y       = out + plan.out_kept[i * c];
+            if(plan.row)
+            {
+                acc_type a = r.init();
+                for(std::size_t j = 0; j < n; j++)
+                    a = r.op(a, x[j]);
+                *y = U(r.output(a, n));
+                continue;
+            }
+            std::fill(acc.begin(), acc.end(), r.init());
+            for(auto offset : plan.in_reduced)
+            {
+                const T* xj = x + offset;
+                for(std::size_t k = 0; k < c; k++)
+                    acc[k] = r.op(acc[k], xj[k]);
+            }
+            for(std::size_t k = 0; k < c; k++)
+                y[k] = U(r.output(acc[k], n));
+        }
+    });
+}
+
+// The index of the first element that is better than all the others
+template <class T, class Compare>
+void arg_reduce_kernel(
+    context& ctx, const reduce_plan& plan, const T* in, std::int64_t* out, Compare better)
+{
+    auto n = plan.size();
+    auto c = plan.column;
+    plan.for_each(ctx, [&](auto start, auto end) {
+        std::vector<T> best(c);
+        for(auto i = start; i < end; i++)
+        {
+            const T* x      = in + plan.in_kept[i * c];
+            std::int64_t* y = out + plan.out_kept[i * c];
+            std::copy(x, x + c, best.begin());
+            std::fill(y, y + c, 0);
+            for(std::size_t j = 1; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                {
+                    if(better(xj[k], best[k]))
+                    {
+                        best[k] = xj[k];
+                        y[k]    = j;
+                    }
+                }
+            }
+        }
+    });
+}
+
+struct cpu_reduce : auto_register_op<cpu_reduce>
+{
+    // One of sum, mean, prod, max, min, argmax or argmin
+    std::string algo;
+    std::vector<std::int64_t> axes;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.algo, "algo"), f(self.axes, "axes"));
+    }
+
+    std::string name() const { return "cpu::reduce"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(2).same_ndims();
+        const auto& s = inputs.front();
+        auto lens     = s.lens();
+        for(auto axis : to_axes(axes, lens.size()))
+            lens.at(axis) = 1;
+        if(inputs.back().lens() != lens)
+            MIGRAPHX_THROW("REDUCE: Output must have the reduced dimensions set to 1");
+        bool arg = algo == "argmax" or algo == "argmin";
+        if(arg and (axes.size() != 1 or inputs.back().type() != shape::int64_type))
+            MIGRAPHX_THROW("REDUCE: " + algo + " needs one axis and an int64 output");
+        if(not arg and inputs.back().type() != s.type())
+            MIGRAPHX_THROW("REDUCE: Output must have the type of the input");
+        return inputs.back();
+    }
+
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        auto raxes = to_axes(axes, output_shape.lens().size());
+        return apply_extent(args, raxes, [&](const argument& input, const argument& output) {
+            reduce_plan plan{input.get_shape(), output.get_shape(), raxes};
+            if(algo == "argmax" or algo == "argmin")
+            {
+                auto* out = output.cast<std::int64_t>();
+                input.visit([&](auto x) {
+                    using type = typename decltype(x)::value_type;
+                    if(algo == "argmax")
+                        arg_reduce_kernel(ctx, plan, x.data(), out, std::greater<type>{});
+                    else
+                        arg_reduce_kernel(ctx, plan, x.data(), out, std::less<type>{});
+                });
+                return;
+            }
+            visit_all(output, input)([&](auto y, auto x) {
+                using type = typename decltype(x)::value_type;
+                visit_reducer<type>(
+                    algo, [&](auto r) { reduce_kernel(ctx, plan, x.data(), y.data(), r); });
+            });
+        });
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+template <class T>
+using compute_type = std::conditional_t<std::is_same<T, double>{}, double, float>;
+
+// Computes the max, then the sum of the exponentials, and then the output of
+// each group, so the input is read three times but never written out in
+// between
+template <class T>
+void softmax_kernel(context& ctx, const reduce_plan& plan, const T* in, T* out, bool log)
+{
+    using acc_type = compute_type<T>;
+    auto n         = plan.size();
+    auto c         = plan.column;
+    plan.for_each(ctx, [&](auto start, auto end) {
+        std::vector<acc_type> m(c);
+        std::vector<acc_type> sum(c);
+        for(auto i = start; i < end; i++)
+        {
+            const T* x = in + plan.in_kept[i * c];
+            T* y       = out + plan.out_kept[i * c];
+            std::fill(m.begin(), m.end(), std::numeric_limits<acc_type>::lowest());
+            std::fill(sum.begin(), sum.end(), 0);
+            for(std::size_t j = 0; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                    m[k] = std::max(m[k], acc_type(xj[k]));
+            }
+            for(std::size_t j = 0; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                T* yj       = y + plan.out_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                {
+                    auto e = std::exp(acc_type(xj[k]) - m[k]);
+                    sum[k] += e;
+                    if(not log)
+                        yj[k] = T(e);
+                }
+            }
+            for(std::size_t k = 0; k < c; k++)
+                sum[k] = log ? m[k] + std::log(sum[k]) : 1 / sum[k];
+            for(std::size_t j = 0; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                T* yj       = y + plan.out_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                    yj[k] = log ? T(acc_type(xj[k]) - sum[k]) : T(acc_type(yj[k]) * sum[k]);
+            }
+        }
+    });
+}
+
+struct cpu_softmax : auto_register_op<cpu_softmax>
+{
+    std::int64_t axis = 1;
+    bool log          = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.axis, "axis"), f(self.log, "log"));
+    }
+
+    std::string name() const { return "cpu::softmax"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(2).same_type().same_dims();
+        if(axis < 0 or axis >= std::int64_t(inputs.front().lens().size()))
+            MIGRAPHX_THROW("SOFTMAX: Invalid axis");
+        return inputs.back();
+    }
+
+    argument compute(context& ctx, const shape&, std::vector<argument> args) const
+    {
+        std::vector<std::size_t> raxes = {std::size_t(axis)};
+        return apply_extent(args, raxes, [&](const argument& x, const argument& y) {
+            reduce_plan plan{x.get_shape(), y.get_shape(), raxes};
+            visit_all(y, x)([&](auto output, auto input) {
+                softmax_kernel(ctx, plan, input.data(), output.data(), log);
+            });
+        });
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+// Computes the mean and variance in one pass over each group. The sums are
+// taken relative to the first element, which avoids most of the cancellation
+// of computing the variance from the sum of squares.
+template <class T>
+void layernorm_kernel(context& ctx, const reduce_plan& plan, const T* in, T* out, float epsilon)
+{
+    using acc_type = compute_type<T>;
+    auto n         = plan.size();
+    auto c         = plan.column;
+    plan.for_each(ctx, [&](auto start, auto end) {
+        std::vector<acc_type> shift(c);
+        std::vector<acc_type> sum(c);
+        std::vector<acc_type> sum_sq(c);
+        for(auto i = start; i < end; i++)
+        {
+            const T* x = in + plan.in_kept[i * c];
+            T* y       = out + plan.out_kept[i * c];
+            std::copy(x, x + c, shift.begin());
+            std::fill(sum.begin(), sum.end(), 0);
+            std::fill(sum_sq.begin(), sum_sq.end(), 0);
+            for(std::size_t j = 0; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                {
+                    auto d = acc_type(xj[k]) - shift[k];
+                    sum[k] += d;
+                    sum_sq[k] += d * d;
+                }
+            }
+            for(std::size_t k = 0; k < c; k++)
+            {
+                auto mean     = sum[k] / n;
+                auto variance = std::max(sum_sq[k] / n - mean * mean, acc_type(0));
+                // Reuse the buffers for the mean and the scale
+                shift[k] += mean;
+                sum[k] = 1 / std::sqrt(variance + epsilon);
+            }
+            for(std::size_t j = 0; j < n; j++)
+            {
+                const T* xj = x + plan.in_reduced[j];
+                T* yj       = y + plan.out_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                    yj[k] = T((acc_type(xj[k]) - shift[k]) * sum[k]);
+            }
+        }
+    });
+}
+
+struct cpu_layernorm : auto_register_op<cpu_layernorm>
+{
+    std::vector<std::int64_t> axes;
+    float epsilon = 1e-12f;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.axes, "axes"), f(self.epsilon, "epsilon"));
+    }
+
+    std::string name() const { return "cpu::layernorm"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(2).same_type().same_dims();
+        return inputs.back();
+    }
+
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        auto raxes = to_axes(axes, output_shape.lens().size());
+        return apply_extent(args, raxes, [&](const argument& x, const argument& y) {
+            reduce_plan plan{x.get_shape(), y.get_shape(), raxes};
+            visit_all(y, x)([&](auto output, auto input) {
+                layernorm_kernel(ctx, plan, input.data(), output.data(), epsilon);
+            });
+        });
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+template <class T>
+void prefix_scan_sum_kernel(
+    context& ctx, const reduce_plan& plan, const T* in, T* out, bool exclusive, bool reverse)
+{
+    auto n = plan.size();
+    auto c = plan.column;
+    plan.for_each(ctx, [&](auto start, auto end) {
+        std::vector<T> sum(c);
+        for(auto i = start; i < end; i++)
+        {
+            const T* x = in + plan.in_kept[i * c];
+            T* y       = out + plan.out_kept[i * c];
+            std::fill(sum.begin(), sum.end(), T(0));
+            for(std::size_t jj = 0; jj < n; jj++)
+            {
+                auto j      = reverse ? n - jj - 1 : jj;
+                const T* xj = x + plan.in_reduced[j];
+                T* yj       = y + plan.out_reduced[j];
+                for(std::size_t k = 0; k < c; k++)
+                {
+                    // Read the input first, since the output may alias it
+                    auto xk = xj[k];
+                    if(exclusive)
+                        yj[k] = sum[k];
+                    sum[k] += xk;
+                    if(not exclusive)
+                        yj[k] = sum[k];
+                }
+            }
+        }
+    });
+}
+
+struct cpu_prefix_scan_sum : auto_register_op<cpu_prefix_scan_sum>
+{
+    std::int64_t axis = 0;
+    bool exclusive    = false;
+    bool reverse      = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(
+            f(self.axis, "axis"), f(self.exclusive, "exclusive"), f(self.reverse, "reverse"));
+    }
+
+    std::string name() const { return "cpu::prefix_scan_sum"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(2).same_type().same_dims();
+        if(axis < 0 or axis >= std::int64_t(inputs.front().lens().size()))
+            MIGRAPHX_THROW("PREFIX_SCAN_SUM: Invalid axis");
+        return inputs.back();
+    }
+
+    argument compute(context& ctx, const shape&, std::vector<argument> args) const
+    {
+        std::vector<std::size_t> raxes = {std::size_t(axis)};
+        return apply_extent(args, raxes, [&](const argument& x, const argument& y) {
+            reduce_plan plan{x.get_shape(), y.get_shape(), raxes};
+            visit_all(y, x)([&](auto output, auto input) {
+                prefix_scan_sum_kernel(
+                    ctx, plan, input.data(), output.data(), exclusive, reverse);
+            });
+        });
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
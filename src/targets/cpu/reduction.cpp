@@ -1,5 +1,6 @@
 #include <migraphx/config.hpp>
 #include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/ranges.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -18,6 +19,13 @@ struct dnnl_reduction : dnnl_op<dnnl_reduction, dnnl::reduction>
 
     std::string name() const { return "dnnl::reduction"; }
 
+    bool is_row_input(const shape& output, const std::vector<shape>& inputs, std::size_t i) const
+    {
+        if(i == 0 and contains(axes, 0))
+            return false;
+        return same_rows(output, inputs[i]);
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         // Compensate for allocation
@@ -0,0 +1,144 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/roialign.hpp>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_roialign : auto_register_op<cpu_roialign>
+{
+    op::roialign op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::roialign"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        return op.compute_shape(std::move(inputs));
+    }
+
+    struct roi_info
+    {
+        std::array<std::size_t, 2> bin_grid_size = {0, 0};
+        std::vector<op::roialign::pos_weight> pos_weights;
+    };
+
+    roi_info calc_roi(const std::array<float, 2>& roi_starts,
+                      const std::array<float, 2>& roi_ends,
+                      const std::array<std::size_t, 2>& in_dims,
+                      const std::array<std::size_t, 2>& out_dims) const
+    {
+        roi_info result;
+        // Force malformed ROIs to be 1x1
+        std::array<float, 2> roi_size{};
+        std::array<float, 2> bin_size{};
+        for(auto ii : range(roi_size.size()))
+        {
+            roi_size[ii] = roi_ends[ii] - roi_starts[ii];
+            roi_size[ii] = std::max(roi_size[ii], 1.0f);
+
+            bin_size[ii]             = roi_size[ii] / out_dims[ii];
+            result.bin_grid_size[ii] = (op.sampling_ratio > 0)
+                                           ? op.sampling_ratio
+                                           : std::ceil(roi_size[ii] / out_dims[ii]);
+        }
+        shape comp_s{shape::float_type,
+                     {out_dims[0], out_dims[1], result.bin_grid_size[0], result.bin_grid_size[1]}};
+        result.pos_weights =
+            op.calc_pos_weight(in_dims, comp_s, roi_starts, bin_size, result.bin_grid_size);
+        return result;
+    }
+
+    // The bilinear positions and weights are computed once per roi in
+    // parallel, and then every roi and channel pair is pooled in parallel
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        argument result{output_shape};
+        const auto& out_lens                = output_shape.lens();
+        std::size_t n_rois                  = out_lens[0];
+        std::size_t channels                = out_lens[1];
+        std::array<std::size_t, 2> out_dims = {out_lens[2], out_lens[3]};
+        const auto& x_lens                  = args.at(0).get_shape().lens();
+        std::array<std::size_t, 2> in_dims  = {x_lens[2], x_lens[3]};
+        auto roi_s                          = args.at(1).get_shape();
+        auto spatial_scale                  = op.spatial_scale;
+        bool average                        = op.mode == op::pooling_mode::average;
+        double init = average ? 0.0 : std::numeric_limits<double>::lowest();
+
+        visit_all(result, args.at(0), args.at(1))([&](auto output, auto x, auto roi) {
+            const auto* batch_indices = args.at(2).cast<int64_t>();
+            std::vector<roi_info> rois(n_rois);
+            ctx.bulk_execute(n_rois, 1, [&](auto start, auto end) {
+                for(auto n = start; n < end; n++)
+                {
+                    // Do not using rounding; this implementation detail is critical
+                    std::array<float, 2> roi_starts = {
+                        static_cast<float>(roi[roi_s.index({n, 1})] * spatial_scale),
+                        static_cast<float>(roi[roi_s.index({n, 0})] * spatial_scale)};
+                    std::array<float, 2> roi_ends = {
+                        static_cast<float>(roi[roi_s.index({n, 3})] * spatial_scale),
+                        static_cast<float>(roi[roi_s.index({n, 2})] * spatial_scale)};
+                    rois[n] = this->calc_roi(roi_starts, roi_ends, in_dims, out_dims);
+                }
+            });
+
+            auto* out_ptr     = output.data();
+            auto plane        = in_dims[0] * in_dims[1];
+            auto out_plane    = out_dims[0] * out_dims[1];
+            auto pool_channel = [&](auto data) {
+                ctx.bulk_execute(n_rois * channels, 1, [&](auto start, auto end) {
+                    for(auto nc = start; nc < end; nc++)
+                    {
+                        auto n             = nc / channels;
+                        auto c             = nc % channels;
+                        const auto& info   = rois[n];
+                        auto count         = info.bin_grid_size[0] * info.bin_grid_size[1];
+                        auto offset        = (batch_indices[n] * channels + c) * plane;
+                        const auto* weight = info.pos_weights.data();
+                        for(std::size_t i = 0; i < out_plane; i++)
+                        {
+                            double output_val = init;
+                            for(std::size_t j = 0; j < count; j++, weight++)
+                            {
+                                for(std::size_t k = 0; k < 4; k++)
+                                {
+                                    double v   = data(offset + weight->pos[k]) * weight->w[k];
+                                    output_val = average ? output_val + v
+                                                         : std::max(output_val, v);
+                                }
+                            }
+                            if(average)
+                                output_val = (count == 0) ? 0.0 : output_val / count;
+                            out_ptr[nc * out_plane + i] = output_val;
+                        }
+                    }
+                });
+            };
+            if(args.at(0).get_shape().standard())
+            {
+                const auto* x_ptr = x.data();
+                pool_channel([=](std::size_t i) { return x_ptr[i]; });
+            }
+            else
+            {
+                pool_channel([&](std::size_t i) { return x[i]; });
+            }
+        });
+
+        return result;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,199 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/run_parallel.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Splits the cpus into n groups of contiguous cpus, so a group shares as
+// much of the caches as it can. A cpu is shared when there are fewer cpus
+// than groups.
+static std::vector<std::vector<std::size_t>> partition_cpus(const std::vector<std::size_t>& cpus,
+                                                            std::size_t n)
+{
+    std::vector<std::vector<std::size_t>> result(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        if(cpus.size() < n)
+        {
+            result[i].push_back(cpus[i % cpus.size()]);
+            continue;
+        }
+        result[i].assign(cpus.begin() + i * cpus.size() / n,
+                         cpus.begin() + (i + 1) * cpus.size() / n);
+    }
+    return result;
+}
+
+// A thread for each group of cpus, which stays bound to its group, so the
+// threads that the kernels start are only created once. The contexts of the
+// sub-batch that runs on the thread only use the cpus of its group.
+struct batch_workers
+{
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable start;
+    std::condition_variable done;
+    std::function<void(std::size_t)> job = nullptr;
+    std::vector<std::exception_ptr> errors;
+    std::size_t generation = 0;
+    std::size_t pending    = 0;
+    bool closed            = false;
+    // Only one eval runs the workers at a time
+    std::mutex run_mutex;
+
+    explicit batch_workers(const std::vector<std::vector<std::size_t>>& groups)
+        : errors(groups.size())
+    {
+        for(std::size_t i = 0; i < groups.size(); i++)
+        {
+            threads.emplace_back([=] {
+                // The thread is dedicated to its group, so it is never unbound
+                bind_to_cpus(groups[i]);
+                this->work(i);
+            });
+        }
+    }
+
+    batch_workers(const batch_workers&) = delete;
+    batch_workers& operator=(const batch_workers&) = delete;
+
+    ~batch_workers() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            closed = true;
+        }
+        start.notify_all();
+        for(auto&& t : threads)
+            t.join();
+    }
+
+    void work(std::size_t i)
+    {
+        std::size_t seen = 0;
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m);
+                start.wait(lock, [&] { return closed or generation != seen; });
+                if(closed)
+                    return;
+                seen = generation;
+            }
+            try
+            {
+                job(i);
+            }
+            catch(...)
+            {
+                errors[i] = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(m);
+            if(--pending == 0)
+                done.notify_all();
+        }
+    }
+
+    // Calls f with the index of each worker, and waits for all of them
+    void run(std::function<void(std::size_t)> f)
+    {
+        std::lock_guard<std::mutex> run_lock(run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(m);
+            job     = std::move(f);
+            pending = threads.size();
+            std::fill(errors.begin(), errors.end(), nullptr);
+            generation++;
+        }
+        start.notify_all();
+        {
+            std::unique_lock<std::mutex> lock(m);
+            done.wait(lock, [&] { return pending == 0; });
+        }
+        for(const auto& e : errors)
+        {
+            if(e)
+                std::rethrow_exception(e);
+        }
+    }
+};
+
+// Runs each sub-batch on its own group of cpus, and writes the outputs into
+// the buffers that are passed as the last inputs
+struct cpu_run_parallel : auto_register_op<cpu_run_parallel>
+{
+    op::run_parallel op;
+    std::shared_ptr<batch_workers> workers = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::run_parallel"; }
+
+    shape compute_shape(std::vector<shape> inputs, const std::vector<module_ref>& mods) const
+    {
+        if(mods.empty())
+            MIGRAPHX_THROW("CPU_RUN_PARALLEL: there must be at least one submodule");
+        auto n = mods.front()->get_output_shapes().size();
+        if(inputs.size() < n)
+            MIGRAPHX_THROW("CPU_RUN_PARALLEL: missing output buffers");
+        inputs.resize(inputs.size() - n);
+        return op.compute_shape(inputs, mods);
+    }
+
+    // The workers are shared by the copies of the program, which take turns
+    void finalize(context& ctx, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        if(op.names.empty())
+            return;
+        auto n = (inputs.size() - output_shape.sub_shapes().size()) / op.names.size();
+        if(n < 2)
+            return;
+        auto cpus = ctx.get_cpus();
+        if(cpus.empty())
+            cpus = allowed_cpus();
+        workers = std::make_shared<batch_workers>(partition_cpus(cpus, n));
+    }
+
+    argument compute(context& ctx,
+                     const shape& output_shape,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const op::run_parallel::run_function& run) const
+    {
+        auto n = output_shape.sub_shapes().size();
+        std::vector<argument> inputs(args.begin(), args.end() - n);
+        std::vector<argument> outputs(args.end() - n, args.end());
+        auto run_module = [&](std::size_t i) { op.run_module(i, inputs, mods, outputs, run); };
+        if(workers != nullptr and workers->threads.size() == mods.size())
+        {
+            workers->run(run_module);
+        }
+        else
+        {
+            auto binding = ctx.bind_thread();
+            for(std::size_t i = 0; i < mods.size(); i++)
+                run_module(i);
+        }
+        return argument{outputs};
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
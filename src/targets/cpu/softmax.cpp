@@ -8,6 +8,11 @@ namespace cpu {
 
 struct dnnl_softmax : dnnl_extend_op<dnnl_softmax, dnnl::softmax_forward, op::softmax>
 {
+    bool is_row_input(const shape&, const std::vector<shape>&, std::size_t) const
+    {
+        return this->op.axis != 0;
+    }
+
     dnnl::softmax_forward::desc get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         int axis = this->op.axis;
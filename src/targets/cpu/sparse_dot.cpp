@@ -0,0 +1,157 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/sparse_dot.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+const std::size_t row_tile = 4;
+
+// Multiplies Rows rows of x with each row of blocks of the weights in
+// [start, end). Each block is only read once for the rows, and the products
+// are accumulated in BlockCols partial sums for each output, so the inner loop
+// can be vectorized without reassociating a single sum.
+template <std::size_t BlockRows, std::size_t BlockCols, std::size_t Rows, class T, class U>
+static void sparse_rows(const float* const* x,
+                        const U* values,
+                        const std::int32_t* indices,
+                        const std::int32_t* offsets,
+                        std::size_t start,
+                        std::size_t end,
+                        T* const* output)
+{
+    for(auto r = start; r < end; r++)
+    {
+        float acc[Rows][BlockRows][BlockCols] = {};
+        for(auto j = offsets[r]; j < offsets[r + 1]; j++)
+        {
+            const auto* block = values + j * BlockRows * BlockCols;
+            auto col          = indices[j] * BlockCols;
+            for(std::size_t rr = 0; rr < Rows; rr++)
+            {
+                const auto* xp = x[rr] + col;
+                for(std::size_t i = 0; i < BlockRows; i++)
+                {
+                    for(std::size_t c = 0; c < BlockCols; c++)
+                        acc[rr][i][c] += float(block[i * BlockCols + c]) * xp[c];
+                }
+            }
+        }
+        for(std::size_t rr = 0; rr < Rows; rr++)
+        {
+            for(std::size_t i = 0; i < BlockRows; i++)
+            {
+                float sum = 0;
+                for(std::size_t c = 0; c < BlockCols; c++)
+                    sum += acc[rr][i][c];
+                output[rr][r * BlockRows + i] = sum;
+            }
+        }
+    }
+}
+
+// Only the blocks with a nonzero weight are multiplied, so the time goes down
+// with the number of stored blocks instead of the size of the weights.
+struct cpu_sparse_dot : auto_register_op<cpu_sparse_dot>
+{
+    op::sparse_dot op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::sparse_dot"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(5);
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+
+    template <std::size_t BlockRows, std::size_t BlockCols>
+    void run(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& as       = args[0].get_shape();
+        auto k               = as.lens().back();
+        auto n               = output_shape.lens().back();
+        auto rows            = output_shape.elements() / n;
+        const auto* indices  = args[2].cast<std::int32_t>();
+        const auto* offsets  = args[3].cast<std::int32_t>();
+        auto block_row_count = n / BlockRows;
+        assert(output_shape.standard());
+        visit_all(args.back(), args[0], args[1])([&](auto output, auto a, auto values) {
+            // Copy the rows of a to contiguous floats, unless they already are
+            std::vector<float> packed;
+            std::vector<const float*> x(rows);
+            using type = typename decltype(a)::value_type;
+            if(std::is_same<type, float>{} and as.strides().back() == 1)
+            {
+                for(std::size_t r = 0; r < rows; r++)
+                    x[r] = reinterpret_cast<const float*>(a.data()) + as.index(r * k);
+            }
+            else
+            {
+                packed.resize(rows * k);
+                std::copy(a.begin(), a.end(), packed.begin());
+                for(std::size_t r = 0; r < rows; r++)
+                    x[r] = packed.data() + r * k;
+            }
+            ctx.bulk_execute(block_row_count, 16, [&](auto start, auto end) {
+                std::size_t r0 = 0;
+                for(; r0 + row_tile <= rows; r0 += row_tile)
+                {
+                    const float* xs[row_tile];
+                    type* ys[row_tile];
+                    for(std::size_t rr = 0; rr < row_tile; rr++)
+                    {
+                        xs[rr] = x[r0 + rr];
+                        ys[rr] = output.data() + (r0 + rr) * n;
+                    }
+                    sparse_rows<BlockRows, BlockCols, row_tile>(
+                        xs, values.data(), indices, offsets, start, end, ys);
+                }
+                for(; r0 < rows; r0++)
+                {
+                    type* y = output.data() + r0 * n;
+                    sparse_rows<BlockRows, BlockCols, 1>(
+                        &x[r0], values.data(), indices, offsets, start, end, &y);
+                }
+            });
+        });
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        if(op.block_rows == 4 and op.block_cols == 8)
+            run<4, 8>(ctx, output_shape, args);
+        else if(op.block_rows == 1 and op.block_cols == 8)
+            run<1, 8>(ctx, output_shape, args);
+        else if(op.block_rows == 8 and op.block_cols == 8)
+            run<8, 8>(ctx, output_shape, args);
+        else
+            args.back().visit([&](auto output) {
+                auto result = op.compute(output_shape, {args.begin(), args.end() - 1});
+                result.visit([&](auto x) { std::copy(x.begin(), x.end(), output.begin()); });
+            });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
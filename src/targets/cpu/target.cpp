@@ -10,6 +10,7 @@
 #include <migraphx/eliminate_data_type.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
+#include <migraphx/layout_nhwc.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/register_target.hpp>
@@ -22,6 +23,8 @@
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/simplify_reshapes.hpp>
+#include <migraphx/sparsify_weights.hpp>
+#include <migraphx/split_batch.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
 #include <migraphx/cpu/write_literals.hpp>
@@ -32,19 +35,41 @@
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_NHWC)
+// Percent of the blocks of the weights of a dot or convolution that must be
+// zero for them to be stored as block sparse
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_SPARSE_WEIGHTS)
+
 std::string target::name() const { return "cpu"; }
 
+struct id_pass
+{
+    std::string name() const { return "id"; }
+    void apply(const module&) const {}
+};
+
+pass enable_pass(bool enabled, pass p)
+{
+    if(enabled)
+        return p;
+    return id_pass{};
+}
+
 // cppcheck-suppress constParameter
-std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options&) const
+std::vector<pass> target::get_passes(migraphx::context& gctx,
+                                     const compile_options& options) const
 {
     auto& ctx = any_cast<context>(gctx);
     std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
     unsupported_types.erase(shape::type_t::float_type);
+    // The weights are only made sparse when the variable is set
+    auto sparse_threshold = value_of(MIGRAPHX_CPU_SPARSE_WEIGHTS{}, 101) / 100.0;
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
@@ -63,10 +88,16 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_algebra{},
             simplify_reshapes{},
             simplify_algebra{},
+            enable_pass(enabled(MIGRAPHX_ENABLE_NHWC{}), layout_nhwc{}),
+            dead_code_elimination{},
             auto_contiguous{},
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
+            enable_pass(sparse_threshold <= 1, sparsify_weights{sparse_threshold}),
+            dead_code_elimination{},
+            enable_pass(options.split_batch > 1, split_batch{options.split_batch}),
+            dead_code_elimination{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
@@ -0,0 +1,93 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/topk.hpp>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_topk : auto_register_op<cpu_topk>
+{
+    op::topk op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::topk"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        return migraphx::compute_shape(op, std::move(inputs));
+    }
+
+    // Each row along the axis is copied into a contiguous buffer, and then the
+    // k elements are selected with nth_element and only those are sorted. Ties
+    // are broken by picking the lower index first.
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        auto vec_ss = output_shape.sub_shapes();
+        argument res_val{vec_ss.front()};
+        argument res_ind{vec_ss.back()};
+        auto in_s       = args.front().get_shape();
+        auto out_s      = vec_ss.front();
+        auto axis       = op.axis;
+        auto k          = static_cast<std::size_t>(op.k);
+        auto comp_lens  = in_s.lens();
+        auto axis_dim   = comp_lens[axis];
+        auto in_stride  = in_s.strides()[axis];
+        auto out_stride = out_s.strides()[axis];
+        comp_lens[axis] = 1;
+        shape comp_s{in_s.type(), comp_lens};
+
+        visit_all(res_val, args.front())([&](auto out_val, auto input) {
+            using type    = typename decltype(input)::value_type;
+            auto* out_ptr = out_val.data();
+            auto* out_ind = res_ind.cast<int64_t>();
+            auto select   = [&](auto compare) {
+                ctx.bulk_execute(comp_s.elements(), 1, [&](auto start, auto end) {
+                    std::vector<type> row(axis_dim);
+                    std::vector<int64_t> indices(axis_dim);
+                    auto comp = [&](auto i1, auto i2) {
+                        if(compare(row[i1], row[i2]))
+                            return true;
+                        return not compare(row[i2], row[i1]) and i1 < i2;
+                    };
+                    for(auto i = start; i < end; i++)
+                    {
+                        auto idx        = comp_s.multi(i);
+                        const auto* src = input.data() + in_s.index(idx);
+                        auto out_offset = out_s.index(idx);
+                        for(std::size_t j = 0; j < axis_dim; j++)
+                            row[j] = src[j * in_stride];
+                        std::iota(indices.begin(), indices.end(), 0);
+                        if(k < axis_dim)
+                            std::nth_element(
+                                indices.begin(), indices.begin() + k, indices.end(), comp);
+                        std::sort(indices.begin(), indices.begin() + k, comp);
+                        for(std::size_t j = 0; j < k; j++)
+                        {
+                            out_ptr[out_offset + j * out_stride] = row[indices[j]];
+                            out_ind[out_offset + j * out_stride] = indices[j];
+                        }
+                    }
+                });
+            };
+            if(op.largest)
+                select(std::greater<>{});
+            else
+                select(std::less<>{});
+        });
+
+        return {{res_val, res_ind}};
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
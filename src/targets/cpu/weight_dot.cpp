@@ -0,0 +1,179 @@
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/weight_dot.hpp>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Dequantizes n weights of a row, starting at the k-th one
+static void unpack_weights(const std::int8_t* row,
+                           std::size_t k,
+                           std::size_t n,
+                           std::size_t bits,
+                           float scale,
+                           float* out)
+{
+    if(bits == 8)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            out[i] = row[k + i] * scale;
+    }
+    else if(k % 2 == 0 and n % 2 == 0)
+    {
+        const auto* packed = reinterpret_cast<const std::uint8_t*>(row) + k / 2;
+        for(std::size_t i = 0; i < n / 2; i++)
+        {
+            out[2 * i]     = (static_cast<std::int8_t>(packed[i] << 4) >> 4) * scale;
+            out[2 * i + 1] = (static_cast<std::int8_t>(packed[i]) >> 4) * scale;
+        }
+    }
+    else
+    {
+        for(std::size_t i = 0; i < n; i++)
+            out[i] = op::unpack_weight(row, k + i, bits) * scale;
+    }
+}
+
+const std::size_t lanes = 8;
+
+// Accumulates into several partial sums, so the loop can be vectorized
+// without reassociating a single sum. The partial sums are only added up once
+// all the groups are done.
+template <class T>
+static void dot_weights(const T* x, std::size_t stride, const float* w, std::size_t n, float* acc)
+{
+    // Accumulate in a local copy, which the compiler can keep in registers
+    float partial[lanes];
+    std::copy(acc, acc + lanes, partial);
+    std::size_t i = 0;
+    if(stride == 1)
+    {
+        for(; i + lanes <= n; i += lanes)
+        {
+            for(std::size_t l = 0; l < lanes; l++)
+                partial[l] += float(x[i + l]) * w[i + l];
+        }
+    }
+    for(; i < n; i++)
+        partial[i % lanes] += float(x[i * stride]) * w[i];
+    std::copy(partial, partial + lanes, acc);
+}
+
+// The weights are read once for a tile of rows and dequantized a block at a
+// time, so they stay compressed in memory and only the block being used is
+// expanded to floats.
+struct cpu_weight_dot : auto_register_op<cpu_weight_dot>
+{
+    op::weight_dot op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "cpu::weight_dot"; }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        check_shapes{inputs, *this}.has(4);
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        const auto& as = args[0].get_shape();
+        const auto& ss = args[2].get_shape();
+        auto k         = as.lens().back();
+        auto n         = output_shape.lens().back();
+        auto rows      = output_shape.elements() / n;
+        auto a_col     = as.strides().back();
+        auto s_row     = ss.strides()[0];
+        auto s_col     = ss.strides()[1];
+        auto row       = args[1].get_shape().lens()[1];
+        auto gsize     = op.group_size;
+        const auto* b  = args[1].cast<std::int8_t>();
+        std::vector<std::size_t> a_rows(rows);
+        for(std::size_t r = 0; r < rows; r++)
+            a_rows[r] = as.index(r * k);
+        assert(output_shape.standard());
+        const std::size_t col_tile = 8;
+        const std::size_t row_tile = 32;
+        auto col_tiles             = (n + col_tile - 1) / col_tile;
+        // Dequantize several small groups at once, so each row of weights is
+        // read in longer runs
+        auto block = gsize * std::max<std::size_t>(1, std::min(k, std::size_t{1024}) / gsize);
+
+        visit_all(args.back(), args[0], args[2])([&](auto output, auto a, auto scales) {
+            const auto* s = scales.data();
+            ctx.bulk_execute(col_tiles, 1, [&](auto start, auto end) {
+                std::vector<float> w(col_tile * block);
+                std::vector<float> acc(row_tile * col_tile * lanes);
+                for(auto t = start; t < end; t++)
+                {
+                    auto j0 = t * col_tile;
+                    auto nj = std::min(col_tile, n - j0);
+                    for(std::size_t r0 = 0; r0 < rows; r0 += row_tile)
+                    {
+                        auto nr = std::min(row_tile, rows - r0);
+                        std::fill(acc.begin(), acc.end(), 0.0f);
+                        for(std::size_t k0 = 0; k0 < k; k0 += block)
+                        {
+                            auto nk = std::min(block, k - k0);
+                            for(std::size_t jj = 0; jj < nj; jj++)
+                            {
+                                for(std::size_t i = 0; i < nk; i += gsize)
+                                {
+                                    unpack_weights(b + (j0 + jj) * row,
+                                                   k0 + i,
+                                                   gsize,
+                                                   op.bits,
+                                                   s[(j0 + jj) * s_row + (k0 + i) / gsize * s_col],
+                                                   w.data() + jj * block + i);
+                                }
+                            }
+                            for(std::size_t rr = 0; rr < nr; rr++)
+                            {
+                                const auto* x = a.data() + a_rows[r0 + rr] + k0 * a_col;
+                                for(std::size_t jj = 0; jj < nj; jj++)
+                                    dot_weights(x,
+                                                a_col,
+                                                w.data() + jj * block,
+                                                nk,
+                                                acc.data() + (rr * col_tile + jj) * lanes);
+                            }
+                        }
+                        for(std::size_t rr = 0; rr < nr; rr++)
+                        {
+                            for(std::size_t jj = 0; jj < nj; jj++)
+                            {
+                                const auto* p = acc.data() + (rr * col_tile + jj) * lanes;
+                                output[(r0 + rr) * n + j0 + jj] =
+                                    std::accumulate(p, p + lanes, 0.0f);
+                            }
+                        }
+                    }
+                }
+            });
+        });
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
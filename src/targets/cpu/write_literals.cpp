@@ -2,26 +2,57 @@
 #include <migraphx/module.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/iterator_for.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/cpu/dnnl.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
+#include <algorithm>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_PACK_WEIGHTS)
+
 struct cpu_literal
 {
     argument data;
+    // The op that reads the literal as weights in the layout its primitive
+    // prefers. That layout depends on the isa of the cpu, so only the plain
+    // weights are serialized and they are packed again in finalize.
+    value packer;
+    std::vector<shape> packer_inputs;
+    argument packed;
+    std::shared_ptr<numa_replicas> replicas = std::make_shared<numa_replicas>();
 
     template <class Self, class F>
     static auto reflect(Self& self, F f)
     {
-        return pack(f(self.data, "data"));
+        return pack(f(self.data, "data"),
+                    f(self.packer, "packer"),
+                    f(self.packer_inputs, "packer_inputs"));
     }
 
     std::string name() const { return "cpu::literal"; }
 
     shape compute_shape(const std::vector<shape>&) const { return data.get_shape(); }
 
-    argument compute(const shape&, const std::vector<argument>&) const { return data; }
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        if(packer.is_null())
+            return;
+        auto op = from_value<operation>(packer);
+        packed  = get_weights_packer(op.name())(op, packer_inputs, data);
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        const auto& result = packed.empty() ? data : packed;
+        if(ctx.numa_node < 0)
+            return result;
+        return replicas->get(result, ctx.numa_node);
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const cpu_literal& x)
     {
@@ -30,13 +61,41 @@ struct cpu_literal
     }
 };
 
+// Reorder constant weights once into the layout the primitive prefers,
+// instead of letting dnnl reorder them on every evaluation
+static cpu_literal pack_weights(module& m, instruction_ref ins)
+{
+    cpu_literal result{ins->get_literal().get_argument()};
+    if(enabled(MIGRAPHX_DISABLE_DNNL_PACK_WEIGHTS{}) or ins->outputs().size() != 1)
+        return result;
+    auto output = ins->outputs().front();
+    auto inputs = output->inputs();
+    if(inputs.size() < 2 or inputs[1] != ins or std::count(inputs.begin(), inputs.end(), ins) != 1)
+        return result;
+    auto packer = get_weights_packer(output->name());
+    if(packer == nullptr)
+        return result;
+    auto op = output->get_operator();
+    auto v  = op.to_value();
+    if(v.at("packed_weights").to<bool>())
+        return result;
+    v["packed_weights"] = true;
+    op.from_value(v);
+    if(packer(op, to_shapes(inputs), result.data).empty())
+        return result;
+    m.replace_instruction(output, op, inputs);
+    result.packer        = to_value(op);
+    result.packer_inputs = to_shapes(inputs);
+    return result;
+}
+
 void write_literals::apply(module& m) const
 {
     for(auto ins : iterator_for(m))
     {
         if(ins->name() != "@literal")
             continue;
-        m.replace_instruction(ins, cpu_literal{ins->get_literal().get_argument()});
+        m.replace_instruction(ins, pack_weights(m, ins));
     }
 }
 
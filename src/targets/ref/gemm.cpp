@@ -3,6 +3,8 @@
 #include <migraphx/requires.hpp>
 #include <migraphx/par_for.hpp>
 #include <blaze/math/CustomMatrix.h>
+#include <array>
+#include <numeric>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -62,30 +64,75 @@ void migemm_impl(
     });
 }
 
+// Offset of the matrix for batch b, which handles broadcasted batch dimensions
+static std::size_t batch_offset(const shape& s, const std::vector<std::size_t>& batch_idx)
+{
+    return std::inner_product(
+        batch_idx.begin(), batch_idx.end(), s.strides().begin(), std::size_t{0});
+}
+
 template <class T, class F>
 void migemm_impl(
     tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta, std::false_type)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
+    // Number of columns of c accumulated together, so each row of b is read
+    // contiguously instead of once per output element
+    const std::size_t tile = 16;
+
+    const auto& cs     = cmat.get_shape();
+    const auto& as     = amat.get_shape();
+    const auto& bs     = bmat.get_shape();
+    std::size_t n_dims = cs.lens().size();
     std::size_t dim_0  = n_dims - 2;
     std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
-
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
-
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+    auto m             = cs.lens()[dim_0];
+    auto n             = cs.lens()[dim_1];
+    auto k             = as.lens()[dim_1];
+
+    assert(as.lens()[dim_1] == bs.lens()[dim_0]);
+    assert(cs.lens()[dim_0] == as.lens()[dim_0]);
+    assert(cs.lens()[dim_1] == bs.lens()[dim_1]);
+
+    auto a_stride_m = as.strides()[dim_0];
+    auto a_stride_k = as.strides()[dim_1];
+    auto b_stride_k = bs.strides()[dim_0];
+    auto b_stride_n = bs.strides()[dim_1];
+    auto c_stride_m = cs.strides()[dim_0];
+    auto c_stride_n = cs.strides()[dim_1];
+
+    std::vector<std::size_t> batch_lens(cs.lens().begin(), cs.lens().begin() + dim_0);
+    auto nbatch = std::accumulate(
+        batch_lens.begin(), batch_lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+
+    par_for(nbatch * m, [&](auto bi) {
+        auto b = bi / m;
+        auto i = bi % m;
+        std::vector<std::size_t> batch_idx;
+        if(not batch_lens.empty())
+            batch_idx = shape{cs.type(), batch_lens}.multi(b);
+        const T* a  = amat.data() + batch_offset(as, batch_idx) + i * a_stride_m;
+        const T* bp = bmat.data() + batch_offset(bs, batch_idx);
+        T* c        = cmat.data() + batch_offset(cs, batch_idx) + i * c_stride_m;
+        std::array<double, tile> s{};
+        for(std::size_t j0 = 0; j0 < n; j0 += tile)
+        {
+            auto nj = std::min(tile, n - j0);
+            std::fill(s.begin(), s.begin() + nj, 0.0);
+            // Each output is still accumulated in double in order of k, so
+            // the results are the same as the untiled loop
+            for(std::size_t kk = 0; kk < k; kk++)
+            {
+                auto x         = a[kk * a_stride_k];
+                const T* b_row = bp + kk * b_stride_k + j0 * b_stride_n;
+                for(std::size_t j = 0; j < nj; j++)
+                    s[j] += x * b_row[j * b_stride_n];
+            }
+            for(std::size_t j = 0; j < nj; j++)
+            {
+                auto& y = c[(j0 + j) * c_stride_n];
+                y       = alpha * s[j] + y * beta;
+            }
+        }
     });
 }
 
@@ -28,6 +28,7 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/tune_axis.hpp>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -212,56 +213,75 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
     {
         argument result{output_shape};
         visit_quantize(result, args[0], args[1])([&](auto output, auto input, auto weights) {
-            auto in_lens = input.get_shape().lens();
-
-            auto wei_lens = weights.get_shape().lens();
-            auto wei_n    = wei_lens[0];
-            auto wei_c    = wei_lens[1];
+            const auto& in_lens     = input.get_shape().lens();
+            const auto& in_strides  = input.get_shape().strides();
+            const auto& wei_lens    = weights.get_shape().lens();
+            const auto& wei_strides = weights.get_shape().strides();
+            const auto& out_lens    = output_shape.lens();
+            auto wei_n              = wei_lens[0];
+            auto wei_c              = wei_lens[1];
+            auto n_dim              = out_lens.size();
+            auto n_spatial          = n_dim - 2;
             std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
+            shape win_shape{output_shape.type(), win_size};
+
+            // Precompute the channel, spatial position and weight offset of every
+            // element in the window so the inner loop only does pointer arithmetic.
+            // The window is traversed in the same order as before so the
+            // accumulation stays bit-identical.
+            std::vector<std::size_t> win_ch;
+            std::vector<std::ptrdiff_t> win_pos;
+            std::vector<std::size_t> win_wei;
+            win_ch.reserve(win_shape.elements());
+            win_pos.reserve(win_shape.elements() * n_spatial);
+            win_wei.reserve(win_shape.elements());
+            shape_for_each(win_shape, [&](const auto& idx_win) {
+                win_ch.push_back(idx_win[0]);
+                win_pos.insert(win_pos.end(), idx_win.begin() + 1, idx_win.end());
+                win_wei.push_back(std::inner_product(
+                    idx_win.begin(), idx_win.end(), wei_strides.begin() + 1, std::size_t{0}));
+            });
 
-            par_for(output_shape.elements(), [&](auto i) {
-                auto idx_o = output_shape.multi(i);
-                auto w     = idx_o[1];
-                auto n_dim = idx_o.size();
-
-                std::vector<std::ptrdiff_t> win_start;
-                for(std::size_t dim = 2; dim < n_dim; ++dim)
-                {
-                    auto d_2 = dim - 2;
-                    win_start.push_back(std::ptrdiff_t(idx_o[dim] * op.stride[d_2]) -
-                                        std::ptrdiff_t(op.padding[d_2]));
-                }
+            shape out_spatial{output_shape.type(),
+                              std::vector<std::size_t>(out_lens.begin() + 2, out_lens.end())};
+            const auto* in_data  = input.data();
+            const auto* wei_data = weights.data();
+            par_for(out_lens[0] * out_lens[1], [&](auto nw) {
+                auto n              = nw / out_lens[1];
+                auto w              = nw % out_lens[1];
                 const auto group_id = w / (wei_n / op.group);
-
-                shape win_shape{output_shape.type(), win_size};
-
-                double acc = 0.0;
-                shape_for_each(win_shape, [&](auto idx_win) {
-                    auto k           = idx_win[0];
-                    const auto in_ch = group_id * wei_c + k;
-                    std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-                    idx[1] = in_ch;
-                    std::transform(idx_win.begin() + 1,
-                                   idx_win.end(),
-                                   win_start.begin(),
-                                   idx.begin() + 2,
-                                   [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-                    std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-                    idx_wei[0] = w;
-                    std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-                    if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-                       std::equal(idx.begin(),
-                                  idx.end(),
-                                  in_lens.begin(),
-                                  in_lens.end(),
-                                  std::less<std::ptrdiff_t>{}))
+                const auto* in_n =
+                    in_data + n * in_strides[0] + group_id * wei_c * in_strides[1];
+                const auto* wei_w   = wei_data + w * wei_strides[0];
+                std::vector<std::ptrdiff_t> win_start(n_spatial);
+                std::size_t i = nw * out_spatial.elements();
+                shape_for_each(out_spatial, [&](const auto& idx_o) {
+                    for(std::size_t d = 0; d < n_spatial; ++d)
+                        win_start[d] = std::ptrdiff_t(idx_o[d] * op.stride[d]) -
+                                       std::ptrdiff_t(op.padding[d]);
+
+                    double acc = 0.0;
+                    for(std::size_t j = 0; j < win_ch.size(); ++j)
                     {
-                        acc +=
-                            input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
+                        const auto* pos     = win_pos.data() + j * n_spatial;
+                        std::size_t in_offset = win_ch[j] * in_strides[1];
+                        bool in_bounds        = true;
+                        for(std::size_t d = 0; d < n_spatial; ++d)
+                        {
+                            auto x = win_start[d] + pos[d];
+                            if(x < 0 or x >= std::ptrdiff_t(in_lens[d + 2]))
+                            {
+                                in_bounds = false;
+                                break;
+                            }
+                            in_offset += x * in_strides[d + 2];
+                        }
+                        if(in_bounds)
+                            acc += in_n[in_offset] * wei_w[win_wei[j]];
                     }
+                    output[i] = acc;
+                    i++;
                 });
-
-                output[i] = acc;
             });
         });
         return result;
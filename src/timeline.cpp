@@ -0,0 +1,307 @@
+#include <migraphx/timeline.hpp>
+#include <migraphx/marker.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/json.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIMELINE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIMELINE_SIZE)
+
+struct timeline_entry
+{
+    std::string_view name;
+    std::string_view category;
+    double start      = 0;
+    double duration   = 0;
+    std::size_t depth = 0;
+    std::size_t bytes = 0;
+};
+
+struct timeline::thread_buffer
+{
+    std::size_t tid = 0;
+    // Only taken by the thread itself, unless the events are being read
+    std::mutex m;
+    std::vector<timeline_entry> ring;
+    std::size_t total = 0;
+    // A deque so the views of the names stay valid as it grows
+    std::deque<std::string> names;
+    std::unordered_set<std::string_view> interned;
+};
+
+static std::size_t next_timeline_id()
+{
+    static std::atomic<std::size_t> id{1};
+    return id++;
+}
+
+timeline::timeline(std::size_t n)
+    : id(next_timeline_id()), capacity(n), epoch(std::chrono::steady_clock::now())
+{
+    if(capacity == 0)
+        MIGRAPHX_THROW("Timeline capacity must be greater than zero");
+}
+
+timeline::~timeline() = default;
+
+double timeline::now() const
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch)
+        .count();
+}
+
+timeline::thread_buffer& timeline::local()
+{
+    // The ids are never reused, so a buffer of a timeline that was destroyed
+    // is never found again. The ids of threads are reused, so they can't be
+    // used to find the buffer.
+    thread_local std::size_t cached_id = 0;
+    thread_local thread_buffer* cached = nullptr;
+    thread_local std::unordered_map<std::size_t, thread_buffer*> thread_buffers;
+    if(cached_id == id)
+        return *cached;
+    auto it = thread_buffers.find(id);
+    if(it == thread_buffers.end())
+    {
+        std::lock_guard<std::mutex> lock(m);
+        auto b = std::make_unique<thread_buffer>();
+        b->tid = buffers.size();
+        b->ring.resize(capacity);
+        it = thread_buffers.emplace(id, b.get()).first;
+        buffers.push_back(std::move(b));
+    }
+    cached_id = id;
+    cached    = it->second;
+    return *cached;
+}
+
+std::size_t timeline::thread_id() { return local().tid; }
+
+std::string_view timeline::intern(std::string_view name)
+{
+    auto& b = local();
+    auto it = b.interned.find(name);
+    if(it != b.interned.end())
+        return *it;
+    return *b.interned.insert(b.names.emplace_back(name)).first;
+}
+
+void timeline::record(const timeline_event& e)
+{
+    this->record(intern(e.name), intern(e.category), e.start, e.duration, e.depth, e.bytes);
+}
+
+void timeline::record(std::string_view name,
+                      std::string_view category,
+                      double start,
+                      double duration,
+                      std::size_t depth,
+                      std::size_t bytes)
+{
+    auto& b = local();
+    std::lock_guard<std::mutex> lock(b.m);
+    b.ring[b.total % b.ring.size()] = {name, category, start, duration, depth, bytes};
+    b.total++;
+}
+
+std::vector<timeline_event> timeline::events() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    std::vector<timeline_event> result;
+    for(const auto& b : buffers)
+    {
+        std::lock_guard<std::mutex> block(b->m);
+        auto n     = std::min(b->total, b->ring.size());
+        auto first = b->total > b->ring.size() ? b->total % b->ring.size() : 0;
+        for(std::size_t i = 0; i < n; i++)
+        {
+            const auto& x = b->ring[(first + i) % b->ring.size()];
+            timeline_event e;
+            e.name     = std::string(x.name);
+            e.category = std::string(x.category);
+            e.start    = x.start;
+            e.duration = x.duration;
+            e.tid      = b->tid;
+            e.depth    = x.depth;
+            e.bytes    = x.bytes;
+            result.push_back(std::move(e));
+        }
+    }
+    return result;
+}
+
+std::size_t timeline::dropped() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    std::size_t result = 0;
+    for(const auto& b : buffers)
+    {
+        std::lock_guard<std::mutex> block(b->m);
+        if(b->total > b->ring.size())
+            result += b->total - b->ring.size();
+    }
+    return result;
+}
+
+void timeline::clear()
+{
+    std::lock_guard<std::mutex> lock(m);
+    for(const auto& b : buffers)
+    {
+        std::lock_guard<std::mutex> block(b->m);
+        b->total = 0;
+    }
+}
+
+value timeline::to_chrome_trace() const
+{
+    std::vector<value> trace_events;
+    for(const auto& e : this->events())
+    {
+        value args = {{"depth", e.depth}};
+        if(e.bytes > 0)
+            args["bytes"] = e.bytes;
+        trace_events.push_back(value{{"name", e.name},
+                                      {"cat", e.category},
+                                      {"ph", "X"},
+                                      {"ts", e.start},
+                                      {"dur", e.duration},
+                                      {"pid", 0},
+                                      {"tid", e.tid},
+                                      {"args", args}});
+    }
+    value result;
+    result["traceEvents"]     = value(trace_events);
+    result["displayTimeUnit"] = "ms";
+    auto n                    = this->dropped();
+    if(n > 0)
+        result["otherData"] = {{"dropped_events", n}};
+    return result;
+}
+
+void timeline::write_chrome_trace(const std::string& filename) const
+{
+    auto s = to_json_string(this->to_chrome_trace());
+    write_buffer(filename, s.data(), s.size());
+}
+
+timeline_scope::timeline_scope(timeline* pt, std::string name, std::string category) : t(pt)
+{
+    if(t == nullptr)
+        return;
+    e.name     = std::move(name);
+    e.category = std::move(category);
+    e.start    = t->now();
+}
+
+timeline_scope::~timeline_scope()
+{
+    if(t == nullptr)
+        return;
+    e.duration = t->now() - e.start;
+    t->record(e);
+}
+
+struct timeline_marker
+{
+    timeline* t       = nullptr;
+    double prog_start = 0;
+    std::vector<double> starts;
+    // The interned name of each instruction, so the name is not copied for
+    // every event
+    std::unordered_map<const instruction*, std::string_view> names;
+
+    std::string_view name_of(instruction_ref ins)
+    {
+        auto it = names.find(std::addressof(*ins));
+        if(it != names.end())
+            return it->second;
+        return names.emplace(std::addressof(*ins), t->intern(ins->name())).first->second;
+    }
+
+    void mark_start(instruction_ref) { starts.push_back(t->now()); }
+
+    void mark_stop(instruction_ref ins)
+    {
+        assert(not starts.empty());
+        auto start = starts.back();
+        starts.pop_back();
+        t->record(name_of(ins),
+                  "instruction",
+                  start,
+                  t->now() - start,
+                  starts.size(),
+                  ins->get_shape().bytes());
+    }
+
+    void mark_start(const program&) { prog_start = t->now(); }
+
+    void mark_stop(const program&)
+    {
+        t->record("eval", "program", prog_start, t->now() - prog_start);
+    }
+};
+
+marker make_timeline_marker(timeline& t)
+{
+    timeline_marker m;
+    m.t = &t;
+    return m;
+}
+
+struct timeline_file
+{
+    std::string filename;
+    timeline t;
+
+    timeline_file(std::string fname, std::size_t capacity)
+        : filename(std::move(fname)), t(capacity)
+    {
+    }
+
+    timeline_file(const timeline_file&) = delete;
+    timeline_file& operator=(const timeline_file&) = delete;
+
+    ~timeline_file()
+    {
+        try
+        {
+            t.write_chrome_trace(filename);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << "Failed to write timeline to " << filename << ": " << ex.what()
+                      << std::endl;
+        }
+    }
+};
+
+timeline* get_timeline()
+{
+    static std::unique_ptr<timeline_file> tf = []() -> std::unique_ptr<timeline_file> {
+        auto filename = string_value_of(MIGRAPHX_TIMELINE{});
+        if(filename.empty())
+            return nullptr;
+        return std::make_unique<timeline_file>(filename,
+                                               value_of(MIGRAPHX_TIMELINE_SIZE{}, 65536));
+    }();
+    if(tf == nullptr)
+        return nullptr;
+    return &tf->t;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
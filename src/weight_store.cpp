@@ -0,0 +1,98 @@
+#include <migraphx/weight_store.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_WEIGHT_SHARING)
+
+struct weight_store
+{
+    struct entry
+    {
+        shape s;
+        std::weak_ptr<char> buffer;
+    };
+    std::mutex m;
+    std::unordered_multimap<std::size_t, entry> buffers;
+
+    // Must be called with the mutex locked
+    std::shared_ptr<char> find(std::size_t h, const shape& s, const char* data)
+    {
+        auto r  = buffers.equal_range(h);
+        auto it = r.first;
+        while(it != r.second)
+        {
+            auto b = it->second.buffer.lock();
+            if(b == nullptr)
+            {
+                it = buffers.erase(it);
+                continue;
+            }
+            if(it->second.s == s and std::memcmp(b.get(), data, s.bytes()) == 0)
+                return b;
+            it++;
+        }
+        return nullptr;
+    }
+
+    template <class F>
+    literal share(const shape& s, const char* data, std::size_t h, F make_buffer)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        auto b = find(h, s, data);
+        if(b == nullptr)
+        {
+            b = make_buffer();
+            buffers.emplace(h, entry{s, b});
+        }
+        return {s, b};
+    }
+
+    std::size_t count()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        return std::count_if(buffers.begin(), buffers.end(), [](const auto& p) {
+            return not p.second.buffer.expired();
+        });
+    }
+};
+
+static weight_store& get_weight_store()
+{
+    static weight_store ws;
+    return ws;
+}
+
+static bool can_share(const shape& s)
+{
+    return s.type() != shape::tuple_type and s.bytes() > 0 and
+           not enabled(MIGRAPHX_DISABLE_WEIGHT_SHARING{});
+}
+
+literal share_literal(const literal& l)
+{
+    if(l.empty() or not can_share(l.get_shape()))
+        return l;
+    return get_weight_store().share(
+        l.get_shape(), l.data(), l.hash(), [&] { return l.buffer; });
+}
+
+literal share_literal(const shape& s, const char* data)
+{
+    if(not can_share(s))
+        return literal{s, data};
+    return get_weight_store().share(s, data, hash_literal_data(s, data), [&] {
+        return make_shared_array<char>(data, data + s.bytes());
+    });
+}
+
+std::size_t shared_literal_count() { return get_weight_store().count(); }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -78,6 +78,25 @@ TEST_CASE(quantize_int8)
     CHECK(bool{p1 == p2});
 }
 
+TEST_CASE(quantize_weights)
+{
+    migraphx::program p;
+    auto m = p.get_main_module();
+    migraphx::shape xs{migraphx_shape_float_type, {2, 16}};
+    migraphx::shape ws{migraphx_shape_float_type, {16, 4}};
+    std::vector<float> w(16 * 4, 0.5f);
+    auto x = m.add_parameter("x", xs);
+    m.add_return({m.add_instruction(migraphx::operation("dot"), {x, m.add_literal(ws, w.data())})});
+    migraphx::quantize_weights(p, 4, 8);
+    p.compile(migraphx::target("ref"));
+
+    std::vector<float> xd(2 * 16, 1.0f);
+    auto outputs = p.eval({{"x", migraphx::argument(xs, xd.data())}});
+    auto* result = reinterpret_cast<float*>(outputs[0].data());
+    for(int i = 0; i < 8; i++)
+        CHECK(result[i] > 7.99f and result[i] < 8.01f);
+}
+
 TEST_CASE(load_and_run_user_input_shape)
 {
     migraphx::onnx_options options;
@@ -175,4 +194,30 @@ TEST_CASE(set_loop_default_iter_num)
     EXPECT(out_shapes[1].lengths() == out_lens1);
 }
 
+TEST_CASE(run_async)
+{
+    auto p = migraphx::parse_onnx("conv_relu_maxpool_test.onnx");
+    p.compile(migraphx::target("ref"));
+    migraphx::program_parameters pp;
+    auto param_shapes = p.get_parameter_shapes();
+    for(auto&& name : param_shapes.names())
+    {
+        pp.add(name, migraphx::argument::generate(param_shapes[name]));
+    }
+    auto gold = p.eval(pp);
+    std::vector<migraphx::async_result> results;
+    {
+        migraphx::executor e{p, 2};
+        for(int i = 0; i < 4; i++)
+            results.push_back(e.run_async(pp));
+    }
+    for(auto&& r : results)
+    {
+        EXPECT(r.ready());
+        auto outputs = r.get();
+        EXPECT(outputs.size() == gold.size());
+        EXPECT(bool{outputs.front() == gold.front()});
+    }
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
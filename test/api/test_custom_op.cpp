@@ -1,3 +1,5 @@
+#include <atomic>
+#include <thread>
 #include <migraphx/migraphx.h>
 #include <migraphx/migraphx.hpp>
 #include "test.hpp"
@@ -20,4 +22,156 @@ TEST_CASE(register_custom_op)
     EXPECT(op.name() == "simple_custom_op");
 }
 
+static std::size_t elements(const migraphx::shape& s) { return s.bytes() / sizeof(float); }
+
+// Writes the negation of its input into its own output
+struct negate_custom_op final : migraphx::experimental_custom_op_base
+{
+    virtual std::string name() const override { return "negate_custom_op"; }
+    virtual migraphx::shape compute_shape(migraphx::shapes inputs) const override
+    {
+        return inputs.front();
+    }
+    virtual migraphx::argument compute(migraphx::context,
+                                       migraphx::argument output,
+                                       migraphx::arguments inputs) const override
+    {
+        auto* x = reinterpret_cast<float*>(inputs[0].data());
+        auto* y = reinterpret_cast<float*>(output.data());
+        for(std::size_t i = 0; i < elements(output.get_shape()); i++)
+            y[i] = -x[i];
+        return output;
+    }
+};
+
+// Adds its second input into the first one, and returns the first one
+struct add_inplace_custom_op final : migraphx::experimental_custom_op_base
+{
+    virtual std::string name() const override { return "add_inplace_custom_op"; }
+    virtual migraphx::shape compute_shape(migraphx::shapes inputs) const override
+    {
+        return inputs.front();
+    }
+    virtual int64_t output_alias(migraphx::shapes) const override { return 0; }
+    virtual migraphx::argument compute(migraphx::context,
+                                       migraphx::argument output,
+                                       migraphx::arguments inputs) const override
+    {
+        auto* x = reinterpret_cast<float*>(output.data());
+        auto* y = reinterpret_cast<float*>(inputs[1].data());
+        for(std::size_t i = 0; i < elements(output.get_shape()); i++)
+            x[i] += y[i];
+        return output;
+    }
+};
+
+TEST_CASE(run_custom_op)
+{
+    negate_custom_op negate_op;
+    migraphx::register_experimental_custom_op(negate_op);
+
+    migraphx::program p;
+    migraphx::module m = p.get_main_module();
+    migraphx::shape s{migraphx_shape_float_type, {3, 3}};
+    auto x   = m.add_parameter("x", s);
+    auto neg = m.add_instruction(migraphx::operation("negate_custom_op"), {x});
+    auto r   = m.add_instruction(migraphx::operation("relu"), {neg});
+    m.add_return({r});
+    p.compile(migraphx::target("ref"));
+
+    std::vector<float> x_data = {-3, -2, -1, 0, 1, 2, 3, 4, 5};
+    auto outputs              = p.eval({{"x", migraphx::argument(s, x_data.data())}});
+    std::vector<float> expected = {3, 2, 1, 0, 0, 0, 0, 0, 0};
+    CHECK(bool{outputs[0] == migraphx::argument(s, expected.data())});
+}
+
+TEST_CASE(run_custom_op_not_computable)
+{
+    simple_custom_op simple_op;
+    migraphx::register_experimental_custom_op(simple_op);
+
+    migraphx::program p;
+    migraphx::module m = p.get_main_module();
+    migraphx::shape s{migraphx_shape_float_type, {4}};
+    auto x = m.add_parameter("x", s);
+    m.add_return({m.add_instruction(migraphx::operation("simple_custom_op"), {x})});
+    p.compile(migraphx::target("ref"));
+
+    std::vector<float> x_data = {1, 2, 3, 4};
+    EXPECT(test::throws([&] { p.eval({{"x", migraphx::argument(s, x_data.data())}}); }));
+}
+
+TEST_CASE(run_custom_op_alias)
+{
+    add_inplace_custom_op add_op;
+    migraphx::register_experimental_custom_op(add_op);
+
+    migraphx::program p;
+    migraphx::module m = p.get_main_module();
+    migraphx::shape s{migraphx_shape_float_type, {4}};
+    auto x   = m.add_parameter("x", s);
+    auto y   = m.add_parameter("y", s);
+    auto sum = m.add_instruction(migraphx::operation("add"), {x, y});
+    auto r   = m.add_instruction(migraphx::operation("add_inplace_custom_op"), {sum, y});
+    m.add_return({r});
+    p.compile(migraphx::target("ref"));
+
+    std::vector<float> x_data = {1, 2, 3, 4};
+    std::vector<float> y_data = {1, 1, 2, 2};
+    auto outputs              = p.eval(
+        {{"x", migraphx::argument(s, x_data.data())}, {"y", migraphx::argument(s, y_data.data())}});
+    std::vector<float> expected = {3, 4, 7, 8};
+    CHECK(bool{outputs[0] == migraphx::argument(s, expected.data())});
+}
+
+// Counts how many calls of compute overlap
+struct overlap_custom_op final : migraphx::experimental_custom_op_base
+{
+    std::shared_ptr<std::atomic<int>> running = std::make_shared<std::atomic<int>>(0);
+    std::shared_ptr<std::atomic<int>> overlaps = std::make_shared<std::atomic<int>>(0);
+
+    virtual std::string name() const override { return "overlap_custom_op"; }
+    virtual migraphx::shape compute_shape(migraphx::shapes inputs) const override
+    {
+        return inputs.front();
+    }
+    virtual int64_t output_alias(migraphx::shapes) const override { return 0; }
+    virtual migraphx::argument compute(migraphx::context,
+                                       migraphx::argument output,
+                                       migraphx::arguments) const override
+    {
+        if((*running)++ > 0)
+            (*overlaps)++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        (*running)--;
+        return output;
+    }
+};
+
+TEST_CASE(run_custom_op_serialized)
+{
+    overlap_custom_op overlap_op;
+    migraphx::register_experimental_custom_op(overlap_op);
+
+    migraphx::shape s{migraphx_shape_float_type, {4}};
+    std::vector<float> x_data = {1, 2, 3, 4};
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&] {
+            migraphx::program p;
+            migraphx::module m = p.get_main_module();
+            auto x             = m.add_parameter("x", s);
+            m.add_return({m.add_instruction(migraphx::operation("overlap_custom_op"), {x})});
+            p.compile(migraphx::target("ref"));
+            std::vector<float> data = x_data;
+            for(int j = 0; j < 10; j++)
+                p.eval({{"x", migraphx::argument(s, data.data())}});
+        });
+    }
+    for(auto&& t : threads)
+        t.join();
+    EXPECT(overlap_op.overlaps->load() == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -70,4 +70,23 @@ TEST_CASE(if_then_else_op)
     CHECK(bool{else_res == y_arg});
 }
 
+TEST_CASE(bind_parameters)
+{
+    migraphx::program p;
+    migraphx::module m = p.get_main_module();
+    migraphx::shape param_shape{migraphx_shape_float_type, {4}};
+    auto x = m.add_parameter("x", param_shape);
+    m.add_return({m.add_instruction(migraphx::operation("relu"), {x})});
+    p.compile(migraphx::target("ref"));
+
+    std::vector<float> x_data = {-1, 2, -3, 4};
+    migraphx::parameter_binding binding{p, {{"x", migraphx::argument(param_shape, x_data.data())}}};
+    std::vector<float> expected = {0, 2, 0, 4};
+    CHECK(bool{p.eval(binding)[0] == migraphx::argument(param_shape, expected.data())});
+    // The binding reads the same buffer on every run
+    x_data[0] = 5;
+    expected  = {5, 2, 0, 4};
+    CHECK(bool{p.eval(binding)[0] == migraphx::argument(param_shape, expected.data())});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
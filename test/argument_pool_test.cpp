@@ -0,0 +1,95 @@
+#include <migraphx/argument_pool.hpp>
+#include <algorithm>
+#include <cstring>
+#include "test.hpp"
+
+TEST_CASE(size_class_fits)
+{
+    for(std::size_t n : {1, 63, 64, 65, 80, 81, 127, 128, 129, 1000, 4096, 4097, 1000000})
+    {
+        auto c = migraphx::argument_pool::size_class(n);
+        EXPECT(migraphx::argument_pool::class_size(c) >= n);
+        // At most a quarter of the buffer is wasted
+        EXPECT(migraphx::argument_pool::class_size(c) - n <
+               std::max<std::size_t>(n / 4 + 1, 64));
+        if(c > 0)
+            EXPECT(migraphx::argument_pool::class_size(c - 1) < n);
+    }
+}
+
+TEST_CASE(size_class_increasing)
+{
+    for(std::size_t c = 1; c < 64; c++)
+        EXPECT(migraphx::argument_pool::class_size(c - 1) <
+               migraphx::argument_pool::class_size(c));
+}
+
+TEST_CASE(reuse_zeroed)
+{
+    migraphx::argument_pool pool;
+    char* p = nullptr;
+    {
+        auto b = pool.allocate(100);
+        p      = b.get();
+        std::fill(p, p + 100, 1);
+    }
+    EXPECT(pool.stats().cached_bytes > 0);
+    auto b = pool.allocate(99);
+    EXPECT(b.get() == p);
+    EXPECT(std::all_of(b.get(), b.get() + 99, [](char x) { return x == 0; }));
+    auto stats = pool.stats();
+    EXPECT(stats.allocations == 2);
+    EXPECT(stats.bytes == 199);
+    EXPECT(stats.reused == 1);
+    EXPECT(stats.cached_bytes == 0);
+}
+
+TEST_CASE(different_class)
+{
+    migraphx::argument_pool pool;
+    pool.allocate(100);
+    auto b = pool.allocate(1000);
+    EXPECT(pool.stats().reused == 0);
+    EXPECT(pool.stats().cached_bytes > 0);
+}
+
+TEST_CASE(trim)
+{
+    migraphx::argument_pool pool;
+    pool.allocate(100);
+    pool.allocate(1000);
+    EXPECT(pool.stats().cached_bytes > 0);
+    pool.trim(0);
+    EXPECT(pool.stats().cached_bytes == 0);
+}
+
+TEST_CASE(end_eval)
+{
+    migraphx::argument_pool pool;
+    {
+        auto b1 = pool.allocate(1000);
+        auto b2 = pool.allocate(1000);
+    }
+    // Both buffers were in use at once, so they are kept
+    pool.end_eval();
+    auto cached = pool.stats().cached_bytes;
+    EXPECT(cached >= 2000);
+    pool.allocate(1000);
+    // Only one buffer was in use during this eval
+    pool.end_eval();
+    EXPECT(pool.stats().cached_bytes < cached);
+    EXPECT(pool.stats().cached_bytes >= 1000);
+}
+
+TEST_CASE(outlive_pool)
+{
+    std::shared_ptr<char> b;
+    {
+        migraphx::argument_pool pool;
+        b = pool.allocate(100);
+    }
+    std::memset(b.get(), 1, 100);
+    b.reset();
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
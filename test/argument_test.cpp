@@ -1,4 +1,5 @@
 #include <migraphx/argument.hpp>
+#include <migraphx/extent.hpp>
 #include <migraphx/literal.hpp>
 #include <migraphx/serialize.hpp>
 #include <sstream>
@@ -199,4 +200,94 @@ TEST_CASE(argument_share)
     EXPECT(a4.data() == a3.data());
 }
 
+TEST_CASE(argument_extent)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3}};
+    migraphx::argument a{s};
+    EXPECT(not a.padded());
+    EXPECT(a.extent() == s.lens());
+
+    auto b = a.with_extent({2, 3});
+    EXPECT(b.padded());
+    EXPECT(b.extent() == std::vector<std::size_t>{2, 3});
+    EXPECT(b.data() == a.data());
+    EXPECT(not a.padded());
+    EXPECT(b.share().extent() == b.extent());
+    EXPECT(b.copy().extent() == b.extent());
+
+    // An extent that is the whole shape is no extent
+    EXPECT(not b.with_extent({4, 3}).padded());
+    EXPECT(test::throws([&] { a.with_extent({5, 3}); }));
+    EXPECT(test::throws([&] { a.with_extent({2}); }));
+}
+
+TEST_CASE(argument_extent_reshape)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3}};
+    auto a = migraphx::argument{s}.with_extent({2, 3});
+
+    auto r1 = a.reshape({migraphx::shape::float_type, {12}});
+    EXPECT(r1.extent() == std::vector<std::size_t>{6});
+    auto r2 = a.reshape({migraphx::shape::float_type, {2, 2, 3}});
+    EXPECT(r2.extent() == std::vector<std::size_t>{1, 2, 3});
+    auto r3 = a.reshape({migraphx::shape::float_type, {4, 3, 1}});
+    EXPECT(r3.extent() == std::vector<std::size_t>{2, 3, 1});
+    // The values are not a box of the new lens
+    auto r4 = a.reshape({migraphx::shape::float_type, {3, 4}});
+    EXPECT(not r4.padded());
+    // The values are no longer in the same place
+    auto r5 = a.reshape({migraphx::shape::float_type, {3, 4}, {1, 3}});
+    EXPECT(not r5.padded());
+}
+
+TEST_CASE(argument_extent_tuple)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3}};
+    auto a1 = migraphx::argument{s}.with_extent({1, 3});
+    migraphx::argument a2{s};
+    migraphx::argument t{{a1, a2}};
+    auto subs = t.get_sub_objects();
+    EXPECT(subs.front().extent() == std::vector<std::size_t>{1, 3});
+    EXPECT(not subs.back().padded());
+}
+
+TEST_CASE(argument_zero_padding)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 3}};
+    std::vector<float> data(9, 1);
+    auto a = migraphx::argument{s, data.data()}.with_extent({2, 2});
+    migraphx::zero_padding(a);
+    EXPECT(data == std::vector<float>{1, 1, 0, 1, 1, 0, 0, 0, 0});
+}
+
+TEST_CASE(argument_fill_padding)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 3}};
+    std::vector<float> data(9, 1);
+    auto a = migraphx::argument{s, data.data()}.with_extent({2, 2});
+    migraphx::fill_padding(a, migraphx::literal{2.0f}.get_argument());
+    EXPECT(data == std::vector<float>{1, 1, 2, 1, 1, 2, 2, 2, 2});
+    EXPECT(not migraphx::all_zero(a));
+    migraphx::zero_padding(a);
+    // The last column, which is strided
+    migraphx::shape column{s.type(), {3, 1}, {3, 1}};
+    EXPECT(migraphx::all_zero(migraphx::argument{column, data.data() + 2}));
+    EXPECT(not migraphx::all_zero(migraphx::argument{column, data.data() + 1}));
+    EXPECT(test::throws([&] { migraphx::fill_padding(a, migraphx::literal{2}.get_argument()); }));
+}
+
+TEST_CASE(pointwise_extent_same)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3, 3}};
+    auto a = migraphx::argument{s}.with_extent({2, 3});
+    auto b = migraphx::argument{s}.with_extent({2, 3});
+    auto c = migraphx::argument{s}.with_extent({1, 3});
+    migraphx::argument d{s};
+    EXPECT(migraphx::pointwise_extent(s, {a, b}) == std::vector<std::size_t>{2, 3});
+    // The padding of the output is only computed from zeros when all of the
+    // inputs are padded the same
+    EXPECT(migraphx::pointwise_extent(s, {a, c}).empty());
+    EXPECT(migraphx::pointwise_extent(s, {a, d}).empty());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
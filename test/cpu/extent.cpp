@@ -0,0 +1,58 @@
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+#include <cmath>
+#include <cstdlib>
+
+static std::vector<float> run(migraphx::program p, std::vector<float> mask)
+{
+    p.compile(migraphx::cpu::target{});
+    migraphx::parameter_map m;
+    m["mask"] = migraphx::argument{p.get_parameter_shape("mask"), mask.data()};
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+TEST_CASE(exp_reduce_padding)
+{
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto mask = mm->add_parameter("mask", {migraphx::shape::float_type, {8}});
+    // The indices are padded past the number of elements that are set
+    auto nz = mm->add_instruction(migraphx::make_op("nonzero"), mask);
+    auto x  = mm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), nz);
+    auto e = mm->add_instruction(migraphx::make_op("exp"), x);
+    mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), e);
+
+    std::vector<float> mask_data = {0, 1, 0, 1, 1, 0, 0, 0};
+    // The padding holds index 0, which exp makes 1
+    std::vector<float> gold = {std::exp(1.0f) + std::exp(3.0f) + std::exp(4.0f) + 5};
+    EXPECT(migraphx::verify_range(run(p, mask_data), gold));
+}
+
+TEST_CASE(softmax_padding)
+{
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto mask = mm->add_parameter("mask", {migraphx::shape::float_type, {4}});
+    auto nz   = mm->add_instruction(migraphx::make_op("nonzero"), mask);
+    auto x    = mm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), nz);
+    auto t = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+    mm->add_instruction(migraphx::make_op("softmax", {{"axis", 1}}), t);
+
+    // The rows of the padding are softmax of a zero, which is 1
+    std::vector<float> mask_data = {0, 1, 0, 0};
+    std::vector<float> gold      = {1, 1, 1, 1};
+    EXPECT(migraphx::verify_range(run(p, mask_data), gold));
+}
+
+int main(int argc, const char* argv[])
+{
+    setenv("MIGRAPHX_ENABLE_CPU_EXTENT", "1", 1); // NOLINT
+    test::run(argc, argv);
+}
@@ -0,0 +1,123 @@
+#include <migraphx/cpu/jit.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <test.hpp>
+#include <cmath>
+#include <numeric>
+
+static std::vector<float> run_kernel(const migraphx::cpu::jit_kernel& k,
+                                     std::vector<std::vector<float>> args)
+{
+    auto f = migraphx::cpu::compile_jit(k.src).get_function<migraphx::cpu::jit_function>(
+        k.symbol_name);
+    std::vector<void*> ptrs;
+    std::transform(args.begin(), args.end(), std::back_inserter(ptrs), [](auto& a) -> void* {
+        return a.data();
+    });
+    // Run the work items in two parts, like two threads would
+    f(ptrs.data(), 0, k.work / 2);
+    f(ptrs.data(), k.work / 2, k.work);
+    return args.back();
+}
+
+static std::vector<float> iota(std::size_t n, float start)
+{
+    std::vector<float> result(n);
+    std::iota(result.begin(), result.end(), start);
+    return result;
+}
+
+TEST_CASE(pointwise_transposed)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x   = m.add_parameter("x", s);
+    auto y   = m.add_parameter("y", {migraphx::shape::float_type, {3, 2}});
+    auto t   = m.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), y);
+    auto add = m.add_instruction(migraphx::make_op("add"), x, t);
+    auto neg = m.add_instruction(migraphx::make_op("neg"), add);
+
+    auto k = migraphx::cpu::generate_pointwise_kernel({add, neg}, neg->get_shape());
+    EXPECT(bool{k.inputs == std::vector<migraphx::instruction_ref>{x, t}});
+    EXPECT(k.shapes == std::vector<migraphx::shape>{s, t->get_shape(), s});
+    EXPECT(migraphx::contains(k.src, k.symbol_name));
+
+    // y is stored as [[0, 1], [2, 3], [4, 5]]
+    auto result = run_kernel(k, {iota(6, 0), iota(6, 0), std::vector<float>(6)});
+    EXPECT(result == std::vector<float>{0, -3, -6, -4, -7, -10});
+}
+
+TEST_CASE(pointwise_constant)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {4, 2}};
+    auto x   = m.add_parameter("x", s);
+    auto two = m.add_literal(2.0f);
+    auto b =
+        m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), two);
+    auto mul = m.add_instruction(migraphx::make_op("mul"), x, b);
+
+    auto k = migraphx::cpu::generate_pointwise_kernel({mul}, s);
+    // The constant is written into the kernel
+    EXPECT(bool{k.inputs == std::vector<migraphx::instruction_ref>{x}});
+    EXPECT(k.shapes == std::vector<migraphx::shape>{s, s});
+
+    auto result = run_kernel(k, {iota(8, 1), std::vector<float>(8)});
+    EXPECT(result == std::vector<float>{2, 4, 6, 8, 10, 12, 14, 16});
+}
+
+TEST_CASE(reduce_mean)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {3, 4}};
+    auto x   = m.add_parameter("x", s);
+    auto abs = m.add_instruction(migraphx::make_op("abs"), x);
+    auto r   = m.add_instruction(migraphx::make_op("reduce_mean", {{"axes", {1}}}), abs);
+
+    auto k = migraphx::cpu::generate_reduce_kernel({abs}, "mean", {1}, r->get_shape());
+    EXPECT(k.shapes == std::vector<migraphx::shape>{s, r->get_shape()});
+    EXPECT(k.work == 3);
+
+    auto input = iota(12, -6);
+    std::vector<float> gold(3);
+    for(std::size_t i = 0; i < 3; i++)
+    {
+        for(std::size_t j = 0; j < 4; j++)
+            gold[i] += std::abs(input[i * 4 + j]) / 4;
+    }
+    auto result = run_kernel(k, {input, std::vector<float>(3)});
+    EXPECT(result == gold);
+}
+
+TEST_CASE(reduce_max_all)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 2}};
+    auto x = m.add_parameter("x", s);
+    auto e = m.add_instruction(migraphx::make_op("neg"), x);
+    migraphx::shape rs{migraphx::shape::float_type, {1, 1, 1}};
+
+    auto k = migraphx::cpu::generate_reduce_kernel({e}, "max", {0, 1, 2}, rs);
+    EXPECT(k.work == 1);
+
+    auto result = run_kernel(k, {iota(12, 3), std::vector<float>(1)});
+    EXPECT(result == std::vector<float>{-3});
+}
+
+TEST_CASE(jit_op_shapes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape ts{migraphx::shape::float_type, {2, 3}, {1, 2}};
+    std::vector<migraphx::shape> shapes = {s, s};
+    auto op                             = migraphx::make_op(
+        "cpu::jit", {{"symbol_name", "kernel"}, {"shapes", migraphx::to_value(shapes)}});
+    EXPECT(op.compute_shape({s, s}) == s);
+    // The kernel can not read an input with other strides
+    EXPECT(test::throws([&] { op.compute_shape({ts, s}); }));
+    EXPECT(test::throws([&] { op.compute_shape({s}); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
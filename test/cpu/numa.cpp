@@ -0,0 +1,88 @@
+#include <migraphx/argument_pool.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/ranges.hpp>
+#include <test.hpp>
+#include <atomic>
+#include <thread>
+
+TEST_CASE(scoped_binding_restores)
+{
+    auto cpus = migraphx::cpu::allowed_cpus();
+    {
+        migraphx::cpu::scoped_cpu_binding binding{{cpus.front()}};
+        EXPECT(migraphx::cpu::allowed_cpus() == std::vector<std::size_t>{cpus.front()});
+    }
+    EXPECT(migraphx::cpu::allowed_cpus() == cpus);
+}
+
+TEST_CASE(nested_binding)
+{
+    auto cpus = migraphx::cpu::allowed_cpus();
+    {
+        migraphx::cpu::scoped_cpu_binding binding{{cpus.front()}};
+        {
+            // The thread is already bound, so this leaves it as it is
+            migraphx::cpu::scoped_cpu_binding inner{{cpus.front()}};
+        }
+        EXPECT(migraphx::cpu::allowed_cpus() == std::vector<std::size_t>{cpus.front()});
+    }
+    EXPECT(migraphx::cpu::allowed_cpus() == cpus);
+}
+
+TEST_CASE(pool_thread_binding)
+{
+    auto cpus = migraphx::cpu::allowed_cpus();
+    std::vector<std::vector<std::size_t>> bound;
+    std::thread{[&] {
+        migraphx::cpu::bind_pool_thread({cpus.front()});
+        bound.push_back(migraphx::cpu::allowed_cpus());
+        migraphx::cpu::bind_pool_thread({cpus.front()});
+        bound.push_back(migraphx::cpu::allowed_cpus());
+        migraphx::cpu::bind_pool_thread({});
+        bound.push_back(migraphx::cpu::allowed_cpus());
+    }}.join();
+    EXPECT(bound.size() == 3);
+    EXPECT(bound[0] == std::vector<std::size_t>{cpus.front()});
+    EXPECT(bound[1] == bound[0]);
+    // Without cpus the thread is bound back to the cpus it had before
+    EXPECT(bound[2] == cpus);
+}
+
+TEST_CASE(bulk_execute_restores)
+{
+    auto cpus = migraphx::cpu::allowed_cpus();
+    migraphx::cpu::context ctx;
+    ctx.numa_node = 0;
+    std::atomic<std::size_t> count{0};
+    std::atomic<bool> on_node{true};
+    ctx.bulk_execute(1024, 1, [&](auto start, auto end) {
+        for(auto cpu : migraphx::cpu::allowed_cpus())
+        {
+            if(not migraphx::contains(migraphx::cpu::numa_node_cpus(0), cpu))
+                on_node = false;
+        }
+        count += end - start;
+    });
+    EXPECT(count.load() == 1024);
+    EXPECT(on_node.load());
+    // The thread is not left on the node for the programs that run after it
+    EXPECT(migraphx::cpu::allowed_cpus() == cpus);
+}
+
+TEST_CASE(replicas_not_pooled)
+{
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    std::vector<float> data(s.elements(), 1);
+    migraphx::argument a{s, data.data()};
+    migraphx::cpu::numa_replicas replicas;
+    auto* pool  = migraphx::get_argument_pool();
+    auto before = pool == nullptr ? 0 : pool->stats().allocations;
+    auto r      = replicas.get(a, 0);
+    // The pages of a pooled buffer may have been touched on another node
+    EXPECT(pool == nullptr or pool->stats().allocations == before);
+    EXPECT(r.data() != a.data());
+    EXPECT(r == a);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
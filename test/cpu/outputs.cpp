@@ -0,0 +1,33 @@
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/ranges.hpp>
+#include <test.hpp>
+
+TEST_CASE(duplicate_return)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4}});
+    auto sum = mm->add_instruction(migraphx::make_op("add"), x, x);
+    mm->add_return({sum, sum});
+    p.compile(migraphx::cpu::target{});
+    // The second output aliases the first, instead of taking its name
+    auto shapes = p.get_parameter_shapes();
+    EXPECT(migraphx::contains(shapes, "main:#output_0"));
+    EXPECT(not migraphx::contains(shapes, "main:#output_1"));
+
+    std::vector<float> data = {1, 2, 3, 4};
+    std::vector<float> out(4);
+    migraphx::parameter_map m;
+    m["x"]              = migraphx::argument{shapes["x"], data.data()};
+    m["main:#output_0"] = migraphx::argument{shapes["main:#output_0"], out.data()};
+    auto results        = p.eval(m);
+    EXPECT(results.size() == 2);
+    EXPECT(results[0].data() == reinterpret_cast<char*>(out.data()));
+    EXPECT(results[1].data() == results[0].data());
+    EXPECT(out == std::vector<float>{2, 4, 6, 8});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
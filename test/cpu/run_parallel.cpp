@@ -0,0 +1,92 @@
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/numa.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <test.hpp>
+#include <algorithm>
+#include <mutex>
+
+// A sub-batch module that takes its output buffer as a parameter
+static migraphx::module create_sub_batch(const std::string& name, const migraphx::shape& s)
+{
+    migraphx::module m{name};
+    auto x = m.add_parameter("x", s);
+    m.add_parameter(name + ":#output_0", s);
+    m.add_return({x});
+    return m;
+}
+
+TEST_CASE(run_parallel_groups)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape out{migraphx::shape::float_type, {4, 3}};
+    auto m0 = create_sub_batch("main:batch0", s);
+    auto m1 = create_sub_batch("main:batch1", s);
+    std::vector<migraphx::module_ref> mods = {&m0, &m1};
+
+    migraphx::context ctx = migraphx::cpu::context{};
+    auto op               = migraphx::make_op("cpu::run_parallel", {{"names", {"x"}}});
+    auto output_shape     = migraphx::shape{std::vector<migraphx::shape>{out}};
+    op.finalize(ctx, output_shape, {s, s, out});
+
+    std::vector<float> x0 = {1, 2, 3, 4, 5, 6};
+    std::vector<float> x1 = {7, 8, 9, 10, 11, 12};
+    migraphx::argument output{out};
+    std::vector<migraphx::argument> args = {
+        migraphx::argument{s, x0.data()}, migraphx::argument{s, x1.data()}, output};
+
+    auto cpus = migraphx::cpu::allowed_cpus();
+    std::mutex m;
+    std::vector<std::vector<std::size_t>> groups;
+    bool bound_outputs = true;
+    bool on_group      = true;
+
+    using parameter_map = std::unordered_map<std::string, migraphx::argument>;
+    auto run = [&](migraphx::module_ref& mod, const parameter_map& params) {
+        // A copy of the context in the sub-batch only uses the cpus of its group
+        migraphx::cpu::context sctx;
+        auto group = sctx.get_cpus();
+        sctx.bulk_execute(64, 1, [&](auto, auto) {
+            auto allowed = migraphx::cpu::allowed_cpus();
+            std::lock_guard<std::mutex> lock(m);
+            on_group = on_group and std::all_of(allowed.begin(), allowed.end(), [&](auto cpu) {
+                           return migraphx::contains(group, cpu);
+                       });
+        });
+        // The output is written straight into the slice of the output buffer
+        auto y = params.at(mod->name() + ":#output_0");
+        auto x = params.at("x");
+        std::transform(reinterpret_cast<float*>(x.data()),
+                       reinterpret_cast<float*>(x.data()) + s.elements(),
+                       reinterpret_cast<float*>(y.data()),
+                       [](auto v) { return v * 2; });
+        std::lock_guard<std::mutex> lock(m);
+        groups.push_back(group);
+        auto offset   = mod == mods.front() ? 0 : s.bytes();
+        bound_outputs = bound_outputs and y.data() == output.data() + offset;
+        return std::vector<migraphx::argument>{y};
+    };
+    auto result = op.compute(ctx, output_shape, args, mods, run);
+
+    EXPECT(bound_outputs);
+    EXPECT(on_group);
+    // Each sub-batch ran on a worker that is bound to a group of the cpus
+    EXPECT(groups.size() == 2);
+    for(const auto& group : groups)
+    {
+        EXPECT(not group.empty());
+        EXPECT(std::all_of(
+            group.begin(), group.end(), [&](auto cpu) { return migraphx::contains(cpus, cpu); }));
+    }
+    // The calling thread is left as it was
+    EXPECT(migraphx::cpu::allowed_cpus() == cpus);
+    EXPECT(migraphx::cpu::dedicated_cpus().empty());
+
+    std::vector<float> results;
+    result.get_sub_objects().front().visit([&](auto y) { results.assign(y.begin(), y.end()); });
+    EXPECT(results == std::vector<float>{2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,65 @@
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+
+static migraphx::program create_program(const migraphx::literal& weights)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", migraphx::shape{migraphx::shape::float_type, {1, 64}});
+    auto b   = mm->add_literal(weights);
+    mm->add_instruction(migraphx::make_op("dot"), a, b);
+    return p;
+}
+
+static std::vector<float> run(migraphx::program p, const migraphx::parameter_map& m)
+{
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+TEST_CASE(packed_weights_serialize_plain)
+{
+    auto weights =
+        migraphx::generate_literal(migraphx::shape{migraphx::shape::float_type, {64, 96}});
+    auto p = create_program(weights);
+    p.compile(migraphx::cpu::target{});
+    // The weights are packed for the isa of the cpu, so only the plain
+    // weights are saved with the program
+    auto* mm = p.get_main_module();
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() != "cpu::literal")
+            continue;
+        auto v = ins->get_operator().to_value();
+        EXPECT(migraphx::from_value<migraphx::argument>(v.at("data")) == weights.get_argument());
+    }
+
+    migraphx::parameter_map m;
+    m["a"] = migraphx::generate_argument(p.get_parameter_shape("a"));
+
+    std::vector<float> gold(96);
+    m["a"].visit([&](auto a) {
+        weights.visit([&](auto b) {
+            for(std::size_t j = 0; j < 96; j++)
+            {
+                for(std::size_t k = 0; k < 64; k++)
+                    gold[j] += a[k] * b[k * 96 + j];
+            }
+        });
+    });
+
+    auto loaded = migraphx::load_buffer(migraphx::save_buffer(p));
+    EXPECT(migraphx::verify_range(run(p, m), gold));
+    EXPECT(migraphx::verify_range(run(loaded, m), gold));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
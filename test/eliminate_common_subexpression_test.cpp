@@ -148,6 +148,34 @@ TEST_CASE(cse_test_literal)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_many_literals)
+{
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    migraphx::module m1;
+    {
+        std::vector<migraphx::instruction_ref> args;
+        for(int i = 0; i < 3; i++)
+        {
+            for(int j = 0; j < 16; j++)
+                args.push_back(m1.add_literal(migraphx::literal{s, std::vector<float>(64, j)}));
+        }
+        m1.add_instruction(migraphx::make_op("concat", {{"axis", 0}}), args);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        std::vector<migraphx::instruction_ref> lits;
+        for(int j = 0; j < 16; j++)
+            lits.push_back(m2.add_literal(migraphx::literal{s, std::vector<float>(64, j)}));
+        std::vector<migraphx::instruction_ref> args;
+        for(int i = 0; i < 3; i++)
+            args.insert(args.end(), lits.begin(), lits.end());
+        m2.add_instruction(migraphx::make_op("concat", {{"axis", 0}}), args);
+    }
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_submodule)
 {
     migraphx::shape si{migraphx::shape::int64_type};
@@ -215,6 +215,93 @@ TEST_CASE(param_error_shape_test)
         "Incorrect shape {int32_type, {1}, {0}} for parameter: x"));
 }
 
+TEST_CASE(param_binding_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto y   = mm->add_parameter("y", {migraphx::shape::int32_type});
+
+    mm->add_instruction(sum_op{}, x, y);
+    auto xarg = migraphx::literal{1}.get_argument();
+    auto yarg = migraphx::literal{2}.get_argument();
+    migraphx::parameter_binding binding{p, {{"x", xarg}, {"y", yarg}}};
+    EXPECT(p.eval(binding).back() == migraphx::literal{3});
+    // Every eval reads the bound buffers
+    *reinterpret_cast<int*>(xarg.data()) = 5;
+    EXPECT(p.eval(binding).back() == migraphx::literal{7});
+}
+
+TEST_CASE(param_binding_error_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto y   = mm->add_parameter("y", {migraphx::shape::int32_type});
+
+    mm->add_instruction(sum_op{}, x, y);
+    EXPECT(test::throws<migraphx::exception>(
+        [&] {
+            migraphx::parameter_binding{p, {{"x", migraphx::literal{1}.get_argument()}}};
+        },
+        "Parameter not found: y"));
+}
+
+TEST_CASE(param_binding_program_test)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    mm->add_instruction(pass_op{}, x);
+    migraphx::program p2 = p1;
+
+    migraphx::parameter_binding binding{p1, {{"x", migraphx::literal{1}.get_argument()}}};
+    EXPECT(test::throws([&] { p2.eval(binding); }));
+}
+
+struct copy_to_op
+{
+    std::string name() const { return "copy_to"; }
+    migraphx::argument
+    compute(migraphx::context&, const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        std::copy(args[0].data(), args[0].data() + args[0].get_shape().bytes(), args[1].data());
+        return args[1];
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        if(inputs.size() != 2)
+            MIGRAPHX_THROW("Wrong inputs");
+        return inputs.back();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 1; }
+};
+
+TEST_CASE(output_param_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type};
+    auto x   = mm->add_parameter("x", s);
+    auto out = mm->add_parameter("main:#output_0", s);
+    mm->add_return({mm->add_instruction(copy_to_op{}, x, out)});
+    auto xarg = migraphx::literal{3}.get_argument();
+
+    // An output that is not passed is allocated
+    auto result = p.eval({{"x", xarg}}).back();
+    EXPECT(result == migraphx::literal{3});
+
+    auto outarg = migraphx::literal{0}.get_argument();
+    result      = p.eval({{"x", xarg}, {"main:#output_0", outarg}}).back();
+    EXPECT(result.data() == outarg.data());
+    EXPECT(outarg == migraphx::literal{3});
+
+    migraphx::parameter_binding binding{p, {{"x", xarg}}};
+    EXPECT(p.eval(binding).back() == migraphx::literal{3});
+    EXPECT(p.eval(binding).back().data() != outarg.data());
+}
+
 TEST_CASE(get_param1)
 {
     migraphx::program p;
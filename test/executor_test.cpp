@@ -0,0 +1,109 @@
+#include <migraphx/executor.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <atomic>
+#include <future>
+#include <vector>
+#include "test.hpp"
+#include <basic_ops.hpp>
+
+struct throw_op
+{
+    std::string name() const { return "throw_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        throw std::runtime_error("throw_op");
+    }
+};
+
+static migraphx::program create_add_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x = mm->add_parameter("x", s);
+    auto y = mm->add_parameter("y", s);
+    mm->add_instruction(migraphx::make_op("add"), x, y);
+    return p;
+}
+
+TEST_CASE(eval_async_future)
+{
+    auto p = create_add_program();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<float> x = {1, 2, 3, 4};
+    std::vector<float> y = {10, 20, 30, 40};
+    migraphx::executor e{p};
+    auto f = e.eval_async({{"x", migraphx::argument(s, x.data())},
+                           {"y", migraphx::argument(s, y.data())}});
+    auto results = f.get();
+    EXPECT(results.size() == 1);
+    std::vector<float> result;
+    results.front().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+    EXPECT(result == std::vector<float>{11, 22, 33, 44});
+}
+
+TEST_CASE(eval_async_queued)
+{
+    auto p = create_add_program();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<std::vector<float>> xs;
+    for(int i = 0; i < 16; i++)
+        xs.push_back(std::vector<float>(4, float(i)));
+    std::vector<std::future<std::vector<migraphx::argument>>> futures;
+    {
+        migraphx::executor e{p, 3};
+        EXPECT(e.workers() == 3);
+        for(auto& x : xs)
+            futures.push_back(e.eval_async({{"x", migraphx::argument(s, x.data())},
+                                            {"y", migraphx::argument(s, x.data())}}));
+        // Destroying the executor finishes the queued requests
+    }
+    for(std::size_t i = 0; i < futures.size(); i++)
+    {
+        auto results = futures[i].get();
+        std::vector<float> result;
+        results.front().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        EXPECT(result == std::vector<float>(4, 2.0f * i));
+    }
+}
+
+TEST_CASE(eval_async_callback)
+{
+    auto p = create_add_program();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<float> x = {1, 2, 3, 4};
+    std::promise<std::vector<float>> done;
+    migraphx::executor e{p};
+    e.eval_async({{"x", migraphx::argument(s, x.data())}, {"y", migraphx::argument(s, x.data())}},
+                 [&](std::vector<migraphx::argument> results, std::exception_ptr error) {
+                     std::vector<float> result;
+                     if(error == nullptr)
+                         results.front().visit(
+                             [&](auto v) { result.assign(v.begin(), v.end()); });
+                     done.set_value(result);
+                 });
+    EXPECT(done.get_future().get() == std::vector<float>{2, 4, 6, 8});
+}
+
+TEST_CASE(eval_async_error)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    mm->add_instruction(throw_op{}, mm->add_parameter("x", s));
+    migraphx::executor e{p};
+    std::vector<float> x = {1, 2, 3, 4};
+    auto f = e.eval_async({{"x", migraphx::argument(s, x.data())}});
+    EXPECT(test::throws([&] { f.get(); }));
+    // The worker keeps running after a failed request
+    auto missing = e.eval_async({});
+    EXPECT(test::throws([&] { missing.get(); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,122 @@
+#include <migraphx/layout_nhwc.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+
+#include <test.hpp>
+
+void run_pass(migraphx::module& m)
+{
+    migraphx::run_passes(m, {migraphx::layout_nhwc{}, migraphx::dead_code_elimination{}});
+}
+
+migraphx::operation layout(std::vector<int64_t> permutation = {0, 2, 3, 1})
+{
+    return migraphx::make_op("layout", {{"permutation", permutation}});
+}
+
+migraphx::instruction_ref add_weights(migraphx::module& m, std::size_t k, std::size_t c)
+{
+    return m.add_literal(
+        migraphx::generate_literal({migraphx::shape::float_type, {k, c, 3, 3}}, k * c));
+}
+
+std::size_t count_ops(const migraphx::module& m, const std::string& name)
+{
+    return std::count_if(m.begin(), m.end(), [&](auto&& ins) { return ins.name() == name; });
+}
+
+TEST_CASE(conv_relu)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1, 8, 16, 16}};
+    migraphx::module m1;
+    {
+        auto x    = m1.add_parameter("x", s);
+        auto w    = add_weights(m1, 16, 8);
+        auto conv = m1.add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+        auto relu = m1.add_instruction(migraphx::make_op("relu"), conv);
+        m1.add_return({relu});
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x    = m2.add_parameter("x", s);
+        auto w    = add_weights(m2, 16, 8);
+        auto lx   = m2.add_instruction(layout(), x);
+        auto conv = m2.add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), lx, w);
+        auto relu = m2.add_instruction(migraphx::make_op("relu"), conv);
+        m2.add_return({relu});
+    }
+    EXPECT(m1.sort() == m2.sort());
+    EXPECT(m1.get_output_shapes().front() ==
+           migraphx::shape::from_permutation(
+               migraphx::shape::float_type, {1, 16, 16, 16}, {0, 2, 3, 1}));
+}
+
+TEST_CASE(conv_chain)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1, 8, 16, 16}};
+    migraphx::module m1;
+    {
+        auto x     = m1.add_parameter("x", s);
+        auto conv1 = m1.add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, add_weights(m1, 8, 8));
+        auto relu  = m1.add_instruction(migraphx::make_op("relu"), conv1);
+        auto conv2 = m1.add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), relu, add_weights(m1, 8, 8));
+        auto add = m1.add_instruction(migraphx::make_op("add"), conv2, x);
+        m1.add_return({add});
+    }
+    run_pass(m1);
+    // Only the parameter is converted to NHWC
+    EXPECT(count_ops(m1, "layout") == 1);
+    EXPECT(count_ops(m1, "contiguous") == 0);
+}
+
+TEST_CASE(conv_transpose_reshape)
+{
+    // The nhwc transpose that the tf parser adds before a reshape does not
+    // need a copy, when the convolution already produces NHWC
+    migraphx::shape s{migraphx::shape::float_type, {1, 8, 4, 4}};
+    migraphx::module m1;
+    {
+        auto x    = m1.add_parameter("x", s);
+        auto conv = m1.add_instruction(
+            migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, add_weights(m1, 8, 8));
+        auto t = m1.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), conv);
+        auto c = m1.add_instruction(migraphx::make_op("contiguous"), t);
+        auto r = m1.add_instruction(migraphx::make_op("reshape", {{"dims", {1, 128}}}), c);
+        m1.add_return({r});
+    }
+    run_pass(m1);
+    EXPECT(count_ops(m1, "contiguous") == 0);
+    EXPECT(count_ops(m1, "layout") == 1);
+}
+
+TEST_CASE(conv_transpose_reshape_nchw)
+{
+    // Without the convolution the tensor is still NCHW, so the copy is kept
+    migraphx::shape s{migraphx::shape::float_type, {1, 8, 4, 4}};
+    migraphx::module m1;
+    {
+        auto x = m1.add_parameter("x", s);
+        auto t = m1.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {0, 2, 3, 1}}}), x);
+        auto c = m1.add_instruction(migraphx::make_op("contiguous"), t);
+        auto r = m1.add_instruction(migraphx::make_op("reshape", {{"dims", {1, 128}}}), c);
+        m1.add_return({r});
+    }
+    auto m2 = m1;
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1,6 +1,8 @@
 
 #include <migraphx/literal.hpp>
 #include <migraphx/serialize.hpp>
+#include <migraphx/weight_store.hpp>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include "test.hpp"
@@ -135,4 +137,43 @@ TEST_CASE(value_literal)
     EXPECT(l4 == l2);
 }
 
+TEST_CASE(literal_hash)
+{
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    migraphx::literal l1{s, {1, 2, 3}};
+    migraphx::literal l2{s, {1, 2, 3}};
+    migraphx::literal l3{s, {1, 2, 4}};
+    migraphx::literal l4{migraphx::shape{migraphx::shape::float_type, {3, 1}}, {1, 2, 3}};
+    EXPECT(l1.hash() == l2.hash());
+    EXPECT(l1.hash() != l3.hash());
+    EXPECT(l1.hash() != l4.hash());
+    migraphx::literal l5 = l1; // NOLINT
+    EXPECT(l5.hash() == l1.hash());
+    EXPECT(migraphx::literal{}.hash() == migraphx::literal{}.hash());
+}
+
+TEST_CASE(literal_share)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1021}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0.5f);
+    auto n = migraphx::shared_literal_count();
+    {
+        auto l1 = migraphx::share_literal(migraphx::literal{s, data});
+        auto l2 = migraphx::share_literal(migraphx::literal{s, data});
+        auto l3 = migraphx::share_literal(s, reinterpret_cast<const char*>(data.data()));
+        EXPECT(l1 == l2);
+        EXPECT(l1.data() == l2.data());
+        EXPECT(l1.data() == l3.data());
+        EXPECT(migraphx::shared_literal_count() == n + 1);
+
+        data.back() = 0;
+        auto l4     = migraphx::share_literal(migraphx::literal{s, data});
+        EXPECT(l4 != l1);
+        EXPECT(l4.data() != l1.data());
+        EXPECT(migraphx::shared_literal_count() == n + 2);
+    }
+    EXPECT(migraphx::shared_literal_count() == n);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
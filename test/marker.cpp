@@ -4,6 +4,9 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/timeline.hpp>
+#include <algorithm>
+#include <thread>
 
 #include "test.hpp"
 
@@ -54,4 +57,78 @@ TEST_CASE(marker)
     EXPECT(migraphx::contains(output, "Mock marker program stop."));
 }
 
+TEST_CASE(timeline_marker)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(migraphx::make_op("add"), one, two);
+    p.compile(migraphx::ref::target{});
+
+    migraphx::timeline t;
+    p.mark({}, migraphx::make_timeline_marker(t));
+
+    auto events = t.events();
+    EXPECT(events.size() == mm->size() + 1);
+    EXPECT(events.back().name == "eval");
+    EXPECT(std::all_of(events.begin(), events.end(), [&](const auto& e) {
+        return e.duration >= 0 and e.start >= events.back().start and e.depth == 0;
+    }));
+    EXPECT(std::any_of(events.begin(), events.end(), [](const auto& e) {
+        return e.category == "instruction" and e.bytes == sizeof(int32_t);
+    }));
+
+    auto trace = t.to_chrome_trace();
+    EXPECT(trace.at("traceEvents").size() == events.size());
+    EXPECT(trace.at("traceEvents").front().at("ph").to<std::string>() == "X");
+}
+
+TEST_CASE(timeline_ring_buffer)
+{
+    migraphx::timeline t{4};
+    for(std::size_t i = 0; i < 10; i++)
+    {
+        migraphx::timeline_event e;
+        e.name = std::to_string(i);
+        t.record(e);
+    }
+    auto events = t.events();
+    EXPECT(events.size() == 4);
+    EXPECT(t.dropped() == 6);
+    EXPECT(events.front().name == "6");
+    EXPECT(events.back().name == "9");
+    EXPECT(t.to_chrome_trace().at("otherData").at("dropped_events").to<std::size_t>() == 6);
+}
+
+TEST_CASE(timeline_threads)
+{
+    migraphx::timeline t{4};
+    auto record = [&](const std::string& name) {
+        for(std::size_t i = 0; i < 6; i++)
+            t.record(t.intern(name), "thread", t.now(), 0);
+    };
+    std::thread first{[&] { record("first"); }};
+    first.join();
+    std::thread second{[&] { record("second"); }};
+    second.join();
+
+    // Each thread keeps its own ring buffer with its own id
+    auto events = t.events();
+    EXPECT(events.size() == 8);
+    EXPECT(t.dropped() == 4);
+    EXPECT(std::all_of(events.begin(), events.begin() + 4, [](const auto& e) {
+        return e.name == "first" and e.tid == 0;
+    }));
+    EXPECT(std::all_of(events.begin() + 4, events.end(), [](const auto& e) {
+        return e.name == "second" and e.tid == 1;
+    }));
+    // A name is only stored once
+    EXPECT(t.intern("name").data() == t.intern(std::string("name")).data());
+
+    t.clear();
+    EXPECT(t.events().empty());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -124,4 +124,62 @@ TEST_CASE(test_msgpack_array_class)
     EXPECT(migraphx::from_msgpack(buffer) == v);
 }
 
+static migraphx::value literal_node(const migraphx::value::binary& data)
+{
+    return {{"name", "@literal"}, {"literal", {{"data", data}}}};
+}
+
+TEST_CASE(test_msgpack_binary_refs)
+{
+    std::vector<std::uint8_t> data1 = {1, 2, 3};
+    std::vector<std::uint8_t> data2 = {4, 5};
+    std::vector<std::uint8_t> attr  = {6, 7, 8, 9};
+    // The binary of the operator is not a placeholder
+    auto op = migraphx::value{{"name", "op"}, {"data", migraphx::value::binary{attr}}};
+    migraphx::value v = {literal_node(migraphx::value::binary{data1}),
+                         op,
+                         literal_node(migraphx::value::binary{data2})};
+    migraphx::value placeholder = {
+        literal_node(migraphx::value::binary{}), op, literal_node(migraphx::value::binary{})};
+    std::vector<migraphx::binary_ref> binaries = {
+        {reinterpret_cast<const char*>(data1.data()), data1.size()},
+        {reinterpret_cast<const char*>(data2.data()), data2.size()}};
+    auto buffer = migraphx::to_msgpack(placeholder, binaries);
+    EXPECT(buffer == migraphx::to_msgpack(v));
+    std::stringstream ss;
+    migraphx::to_msgpack(ss, placeholder, binaries);
+    auto str = ss.str();
+    EXPECT(buffer == std::vector<char>(str.begin(), str.end()));
+
+    std::vector<migraphx::binary_ref> result;
+    auto u = migraphx::from_msgpack(buffer.data(), buffer.size(), result);
+    EXPECT(u[0].at("literal").at("data").to<std::size_t>() == 0);
+    EXPECT(u[1] == op);
+    EXPECT(u[2].at("literal").at("data").to<std::size_t>() == 1);
+    EXPECT(result.size() == 2);
+    // The payloads are referenced in the buffer and not copied
+    EXPECT(result[0].first >= buffer.data() and result[0].first < buffer.data() + buffer.size());
+    EXPECT(std::vector<std::uint8_t>(result[0].first, result[0].first + result[0].second) ==
+           data1);
+    EXPECT(std::vector<std::uint8_t>(result[1].first, result[1].first + result[1].second) ==
+           data2);
+}
+
+TEST_CASE(test_msgpack_binary_refs_missing)
+{
+    migraphx::value v = {literal_node(migraphx::value::binary{}),
+                         literal_node(migraphx::value::binary{})};
+    std::vector<char> data(4);
+    std::vector<migraphx::binary_ref> binaries = {{data.data(), data.size()}};
+    EXPECT(test::throws([&] { migraphx::to_msgpack(v, binaries); }));
+}
+
+TEST_CASE(test_msgpack_binary_refs_unused)
+{
+    migraphx::value v = {{"data", migraphx::value::binary{}}};
+    std::vector<char> data(4);
+    std::vector<migraphx::binary_ref> binaries = {{data.data(), data.size()}};
+    EXPECT(test::throws([&] { migraphx::to_msgpack(v, binaries); }));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
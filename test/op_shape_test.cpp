@@ -1590,6 +1590,15 @@ TEST_CASE(test_unsqueeze_multiple_axes_2)
     expect_shape(s2, migraphx::make_op("unsqueeze", {{"axes", {0, 1}}}), s1);
 }
 
+TEST_CASE(layout_shape)
+{
+    migraphx::shape input{migraphx::shape::float_type, {2, 3, 4, 5}};
+    migraphx::shape output{migraphx::shape::float_type, {2, 3, 4, 5}, {60, 1, 15, 3}};
+    expect_shape(output, migraphx::make_op("layout", {{"permutation", {0, 2, 3, 1}}}), input);
+    expect_shape(input, migraphx::make_op("layout", {{"permutation", {0, 1, 2, 3}}}), output);
+    throws_shape(migraphx::make_op("layout", {{"permutation", {1, 0}}}), input);
+}
+
 TEST_CASE(transpose_shape)
 {
     migraphx::shape input{migraphx::shape::float_type, {2, 2}};
@@ -1664,4 +1673,57 @@ TEST_CASE(roialign_test)
     throws_shape(migraphx::make_op("roialign"), sx, srois2, sbi);
 }
 
+TEST_CASE(sparse_dot_shape)
+{
+    migraphx::shape a{migraphx::shape::float_type, {2, 3, 64}};
+    migraphx::shape values{migraphx::shape::float_type, {5, 4, 8}};
+    migraphx::shape indices{migraphx::shape::int32_type, {5}};
+    migraphx::shape offsets{migraphx::shape::int32_type, {5}};
+    migraphx::shape output{migraphx::shape::float_type, {2, 3, 16}};
+    auto op = migraphx::make_op("sparse_dot", {{"block_rows", 4}, {"block_cols", 8}});
+    expect_shape(output, op, a, values, indices, offsets);
+    throws_shape(
+        migraphx::make_op("sparse_dot", {{"block_rows", 4}, {"block_cols", 16}}),
+        a,
+        values,
+        indices,
+        offsets);
+    migraphx::shape a60{migraphx::shape::float_type, {2, 3, 60}};
+    throws_shape(op, a60, values, indices, offsets);
+    migraphx::shape indices4{migraphx::shape::int32_type, {4}};
+    throws_shape(op, a, values, indices4, offsets);
+    migraphx::shape offsets_float{migraphx::shape::float_type, {5}};
+    throws_shape(op, a, values, indices, offsets_float);
+    migraphx::shape values_half{migraphx::shape::half_type, {5, 4, 8}};
+    throws_shape(op, a, values_half, indices, offsets);
+}
+
+TEST_CASE(weight_dot_shape)
+{
+    migraphx::shape a{migraphx::shape::float_type, {2, 3, 64}};
+    migraphx::shape b8{migraphx::shape::int8_type, {16, 64}};
+    migraphx::shape b4{migraphx::shape::int8_type, {16, 32}};
+    migraphx::shape scales{migraphx::shape::float_type, {16, 2}};
+    migraphx::shape output{migraphx::shape::float_type, {2, 3, 16}};
+    expect_shape(output,
+                 migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}),
+                 a,
+                 b8,
+                 scales);
+    expect_shape(output,
+                 migraphx::make_op("weight_dot", {{"bits", 4}, {"group_size", 32}}),
+                 a,
+                 b4,
+                 scales);
+    throws_shape(
+        migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}), a, b4, scales);
+    throws_shape(
+        migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 16}}), a, b8, scales);
+    throws_shape(
+        migraphx::make_op("weight_dot", {{"bits", 2}, {"group_size", 32}}), a, b8, scales);
+    migraphx::shape bf{migraphx::shape::float_type, {16, 64}};
+    throws_shape(
+        migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}), a, bf, scales);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
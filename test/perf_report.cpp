@@ -25,6 +25,7 @@ TEST_CASE(perf_report)
     EXPECT(migraphx::contains(output, "Total instructions time:"));
     EXPECT(migraphx::contains(output, "Overhead time:"));
     EXPECT(migraphx::contains(output, "Overhead:"));
+    EXPECT(migraphx::contains(output, "Allocations per run:"));
     EXPECT(not migraphx::contains(output, "fast"));
 }
 
@@ -3,12 +3,62 @@
 #include <migraphx/pass_manager.hpp>
 #include <basic_ops.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/tmp_dir.hpp>
 
 #include <test.hpp>
 
-void run_pass(migraphx::module& m)
+void run_pass(migraphx::module& m, migraphx::propagate_constant pc = {})
 {
-    migraphx::run_passes(m, {migraphx::propagate_constant{}, migraphx::dead_code_elimination{}});
+    migraphx::run_passes(m, {pc, migraphx::dead_code_elimination{}});
+}
+
+// Counts how many times it is evaluated
+struct count_op
+{
+    static std::size_t& count()
+    {
+        static std::size_t result = 0;
+        return result;
+    }
+    std::string name() const { return "count"; }
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        count()++;
+        return args.front();
+    }
+};
+
+// Two folded literals that share the count_op
+migraphx::module shared_module()
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+    auto l  = m.add_literal(migraphx::literal(s, {1.0f, 2.0f, 3.0f, 4.0f}));
+    auto c  = m.add_instruction(count_op{}, l);
+    auto a  = m.add_instruction(migraphx::make_op("add"), c, c);
+    auto b  = m.add_instruction(migraphx::make_op("mul"), c, c);
+    auto x  = m.add_parameter("x", s);
+    auto ax = m.add_instruction(migraphx::make_op("add"), a, x);
+    auto bx = m.add_instruction(migraphx::make_op("add"), b, x);
+    m.add_return({ax, bx});
+    return m;
+}
+
+migraphx::module shared_module_folded()
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {2, 2}};
+    auto x  = m.add_parameter("x", s);
+    auto b  = m.add_literal(migraphx::literal(s, {1.0f, 4.0f, 9.0f, 16.0f}));
+    auto a  = m.add_literal(migraphx::literal(s, {2.0f, 4.0f, 6.0f, 8.0f}));
+    auto ax = m.add_instruction(migraphx::make_op("add"), a, x);
+    auto bx = m.add_instruction(migraphx::make_op("add"), b, x);
+    m.add_return({ax, bx});
+    return m;
 }
 
 TEST_CASE(const_add)
@@ -140,4 +190,65 @@ TEST_CASE(const_dot)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_shared)
+{
+    auto m1           = shared_module();
+    count_op::count() = 0;
+    run_pass(m1);
+    EXPECT(count_op::count() == 1);
+    EXPECT(m1.sort() == shared_module_folded().sort());
+}
+
+TEST_CASE(const_memory_budget)
+{
+    auto m1           = shared_module();
+    count_op::count() = 0;
+    // Only one instruction is evaluated at a time
+    run_pass(m1, migraphx::propagate_constant{0});
+    EXPECT(count_op::count() == 1);
+    EXPECT(m1.sort() == shared_module_folded().sort());
+}
+
+TEST_CASE(const_cache)
+{
+    migraphx::tmp_dir td{"propagate_constant"};
+    migraphx::propagate_constant pc;
+    pc.cache_dir = td.path.string();
+
+    auto m1           = shared_module();
+    count_op::count() = 0;
+    run_pass(m1, pc);
+    EXPECT(count_op::count() == 1);
+    EXPECT(m1.sort() == shared_module_folded().sort());
+
+    // The literals are loaded from the cache the second time
+    auto m2 = shared_module();
+    run_pass(m2, pc);
+    EXPECT(count_op::count() == 1);
+    EXPECT(m2.sort() == shared_module_folded().sort());
+}
+
+TEST_CASE(const_contiguous)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::module m1;
+    {
+        auto l = m1.add_literal(migraphx::literal(s, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+        auto t = m1.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), l);
+        auto c = m1.add_instruction(migraphx::make_op("contiguous"), t);
+        auto x = m1.add_parameter("x", {migraphx::shape::float_type, {3, 2}});
+        m1.add_instruction(migraphx::make_op("add"), c, x);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x = m2.add_parameter("x", {migraphx::shape::float_type, {3, 2}});
+        auto l = m2.add_literal(migraphx::literal({migraphx::shape::float_type, {3, 2}},
+                                                  {1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f}));
+        m2.add_instruction(migraphx::make_op("add"), l, x);
+    }
+    EXPECT(m1.sort() == m2.sort());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -60,7 +60,26 @@ def test_module():
     print(mm)
 
 
+def test_run_async():
+    import asyncio
+    p = migraphx.parse_onnx("conv_relu_maxpool_test.onnx")
+    p.compile(migraphx.get_target("ref"))
+    params = {}
+    for key, value in p.get_parameter_shapes().items():
+        params[key] = migraphx.generate_argument(value)
+    gold = p.run(params)[-1]
+
+    async def run_all(e):
+        return await asyncio.gather(*[e.run_async(params) for i in range(4)])
+
+    e = migraphx.executor(p, 2)
+    results = asyncio.get_event_loop().run_until_complete(run_all(e))
+    for r in results:
+        assert r[-1] == gold
+
+
 test_conv_relu()
 test_module()
 if sys.version_info >= (3, 0):
     test_add_scalar()
+    test_run_async()
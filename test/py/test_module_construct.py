@@ -60,7 +60,22 @@ def test_if_then_else():
     assert run_prog(False) == params["y"]
 
 
+def test_bind():
+    p = migraphx.program()
+    mm = p.get_main_module()
+    x = mm.add_parameter("x", migraphx.shape(lens=[4], type="float"))
+    mm.add_return([mm.add_instruction(migraphx.op("relu"), [x])])
+    p.compile(migraphx.get_target("ref"))
+    x_data = array.array('f', [-1.0, 2.0, -3.0, 4.0])
+    binding = p.bind({"x": x_data})
+    assert p.run(binding)[-1].tolist() == [0.0, 2.0, 0.0, 4.0]
+    # The binding reads the same buffer on every run
+    x_data[0] = 5.0
+    assert p.run(binding)[-1].tolist() == [5.0, 2.0, 0.0, 4.0]
+
+
 if __name__ == "__main__":
     if sys.version_info >= (3, 0):
         test_add_op()
+        test_bind()
     test_if_then_else()
@@ -1257,4 +1257,104 @@ TEST_CASE(test_op_capture)
     EXPECT(migraphx::verify_range(vec, cap_vec));
 }
 
+static std::vector<float> run_prog(migraphx::program p, const migraphx::parameter_map& m)
+{
+    p.compile(migraphx::ref::target{});
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static bool has_weight_dot(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "weight_dot"; });
+}
+
+TEST_CASE(quantize_weights_int8)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {4, 64}};
+    migraphx::shape sw{migraphx::shape::float_type, {64, 16}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(migraphx::generate_literal(sw, 1));
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto qp = p;
+    migraphx::quantize_weights(qp);
+    EXPECT(has_weight_dot(qp));
+    // The float weights are removed
+    auto* qmm = qp.get_main_module();
+    EXPECT(std::none_of(qmm->begin(), qmm->end(), [&](const auto& ins) {
+        return ins.name() == "@literal" and ins.get_shape() == sw;
+    }));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::rms_range(run_prog(p, m), run_prog(qp, m)) < 0.01);
+}
+
+TEST_CASE(quantize_weights_int4_group)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {2, 3, 32}};
+    migraphx::shape sw{migraphx::shape::float_type, {32, 8}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(migraphx::generate_literal(sw, 1));
+    auto bw  = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", {2, 32, 8}}}), w);
+    auto cw = mm->add_instruction(migraphx::make_op("contiguous"), bw);
+    mm->add_instruction(migraphx::make_op("dot"), x, cw);
+
+    auto qp = p;
+    migraphx::quantize_weights(qp, 4, 8);
+    EXPECT(has_weight_dot(qp));
+    EXPECT(p.get_output_shapes() == qp.get_output_shapes());
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::rms_range(run_prog(p, m), run_prog(qp, m)) < 0.1);
+}
+
+TEST_CASE(quantize_weights_exact)
+{
+    // Each group of weights is in [-7, 7] and reaches 7, so the scale is 1
+    // and int4 stores the weights exactly
+    migraphx::shape sx{migraphx::shape::float_type, {3, 8}};
+    migraphx::shape sw{migraphx::shape::float_type, {8, 3}};
+    std::vector<float> wd = {7,  -3, 0,  1, 7, -7, -2, 5,  3, 4, -1, 7,
+                             -7, 6,  -5, 0, 2, 7,  3,  -6, 1, 2, 7,  -4};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(migraphx::literal{sw, wd});
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto qp = p;
+    migraphx::quantize_weights(qp, 4, 4);
+    EXPECT(has_weight_dot(qp));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::verify_range(run_prog(p, m), run_prog(qp, m)));
+}
+
+TEST_CASE(quantize_weights_skip)
+{
+    // The weights are not constant, or k is not a multiple of the group
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 6}});
+    auto y   = mm->add_parameter("y", {migraphx::shape::float_type, {6, 4}});
+    auto w   = mm->add_literal(
+        migraphx::generate_literal({migraphx::shape::float_type, {6, 4}}, 1));
+    auto d1  = mm->add_instruction(migraphx::make_op("dot"), x, y);
+    auto d2  = mm->add_instruction(migraphx::make_op("dot"), x, w);
+    mm->add_return({d1, d2});
+
+    auto qp = p;
+    migraphx::quantize_weights(qp, 8, 4);
+    EXPECT(p == qp);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <numeric>
 #include <vector>
 #include <migraphx/literal.hpp>
 #include <migraphx/instruction.hpp>
@@ -1170,6 +1171,36 @@ TEST_CASE(matmul_mm2)
     }
 }
 
+TEST_CASE(matmul_batch_wide)
+{
+    // Output wider than the gemm tile with a broadcasted batch
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::double_type, {2, 3, 7}};
+    migraphx::shape b_shape{migraphx::shape::double_type, {7, 37}};
+    std::vector<double> a(a_shape.elements());
+    std::vector<double> b(b_shape.elements());
+    std::iota(a.begin(), a.end(), -4.0);
+    std::iota(b.begin(), b.end(), -100.0);
+    auto al  = mm->add_literal(migraphx::literal{a_shape, a});
+    auto bl  = mm->add_literal(migraphx::literal{b_shape, b});
+    auto bbl = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", {2, 7, 37}}}), bl);
+    mm->add_instruction(migraphx::make_op("dot"), al, bbl);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+    std::vector<double> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+
+    std::vector<double> gold(2 * 3 * 37, 0.0);
+    for(std::size_t n = 0; n < 2; n++)
+        for(std::size_t i = 0; i < 3; i++)
+            for(std::size_t j = 0; j < 37; j++)
+                for(std::size_t k = 0; k < 7; k++)
+                    gold[(n * 3 + i) * 37 + j] += a[(n * 3 + i) * 7 + k] * b[k * 37 + j];
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(quant_dot_2args_multi4)
 {
     {
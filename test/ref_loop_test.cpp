@@ -10,7 +10,7 @@
 
 #include "test.hpp"
 
-static auto run_prog(int64_t iter_num, bool cond, int64_t ini_val)
+static auto eval_prog(int64_t iter_num, bool cond, int64_t ini_val)
 {
     migraphx::shape si{migraphx::shape::int64_type};
     migraphx::shape s{migraphx::shape::int64_type, {1}};
@@ -54,8 +54,12 @@ static auto run_prog(int64_t iter_num, bool cond, int64_t ini_val)
     pp["iter_num"] = migraphx::argument(si, &iter_num);
     pp["ccond"]    = migraphx::argument(sc, &cond);
     pp["val"]      = migraphx::argument(s, &ini_val);
-    auto rets      = p.eval(pp);
+    return p.eval(pp);
+}
 
+static auto run_prog(int64_t iter_num, bool cond, int64_t ini_val)
+{
+    auto rets = eval_prog(iter_num, cond, ini_val);
     std::vector<std::vector<int64_t>> res;
     for(auto& arg : rets)
     {
@@ -76,6 +80,15 @@ TEST_CASE(loop_test1)
     EXPECT(ress.back() == gold_concat);
 }
 
+TEST_CASE(loop_scan_extent)
+{
+    // The scan output only holds values for the iterations that ran
+    auto rets = eval_prog(4, true, 1);
+    EXPECT(not rets.front().padded());
+    EXPECT(rets.back().extent() == std::vector<std::size_t>{4, 1});
+    EXPECT(eval_prog(2, true, 1).back().extent() == std::vector<std::size_t>{2, 1});
+}
+
 TEST_CASE(loop_test2)
 {
     auto ress                      = run_prog(4, true, 1);
@@ -2435,6 +2435,37 @@ TEST_CASE(imagescaler_test)
     EXPECT(migraphx::verify_range(results_vector, gold));
 }
 
+TEST_CASE(layout_test)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1, 2, 2, 2}};
+    std::vector<float> data(8);
+    std::iota(data.begin(), data.end(), 0);
+
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto l   = mm->add_literal(migraphx::literal{s, data});
+    mm->add_instruction(migraphx::make_op("layout", {{"permutation", {0, 2, 3, 1}}}), l);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+
+    // The elements keep their logical order
+    std::vector<float> results_vector(8);
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, data));
+
+    // The output of the program is made contiguous, so compute the op
+    // directly to check how it stores the buffer
+    auto op     = migraphx::make_op("layout", {{"permutation", {0, 2, 3, 1}}});
+    auto output = op.compute(op.compute_shape({s}), {migraphx::argument{s, data.data()}});
+    // The channels are the innermost dimension of the buffer
+    EXPECT(output.get_shape().lens() == s.lens());
+    EXPECT(output.get_shape().strides() == std::vector<std::size_t>{8, 1, 4, 2});
+    const auto* raw = reinterpret_cast<const float*>(output.data());
+    std::vector<float> buffer(raw, raw + 8);
+    std::vector<float> gold = {0, 4, 1, 5, 2, 6, 3, 7};
+    EXPECT(migraphx::verify_range(buffer, gold));
+}
+
 TEST_CASE(leaky_relu_test)
 {
     migraphx::program p;
@@ -3183,6 +3214,28 @@ TEST_CASE(nonzero_test)
     EXPECT(migraphx::verify_range(result_vector, gold));
 }
 
+TEST_CASE(nonzero_extent_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    std::vector<float> data = {1.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f};
+    auto input = mm->add_literal(migraphx::literal(s, data));
+    auto nz    = mm->add_instruction(migraphx::make_op("nonzero"), input);
+    auto tr = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), nz);
+    mm->add_return({nz, tr});
+    p.compile(migraphx::ref::target{});
+    auto results = p.eval({});
+    // Only the first 2 of the 6 columns hold indices
+    EXPECT(results[0].extent() == std::vector<std::size_t>{2, 2});
+    EXPECT(results[1].extent() == std::vector<std::size_t>{2, 2});
+    EXPECT(results[1].get_shape().lens() == std::vector<std::size_t>{6, 2});
+    std::vector<int64_t> result_vector;
+    results[0].visit([&](auto output) { result_vector.assign(output.begin(), output.end()); });
+    std::vector<int64_t> gold = {0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0};
+    EXPECT(migraphx::verify_range(result_vector, gold));
+}
+
 TEST_CASE(not_test)
 {
     // int32
@@ -1,10 +1,15 @@
 #include <migraphx/program.hpp>
 #include <migraphx/ref/target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/msgpack.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/serialize.hpp>
 
 #include <cstdio>
+#include <numeric>
 
 migraphx::program create_program()
 {
@@ -56,6 +61,46 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+TEST_CASE(as_msgpack_literals)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64, 32}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0.5f);
+    auto x    = mm->add_parameter("x", s);
+    auto l1   = mm->add_literal(migraphx::literal{s, data});
+    auto l2   = mm->add_literal(migraphx::literal{migraphx::shape{migraphx::shape::int8_type}, {3}});
+    auto add  = mm->add_instruction(migraphx::make_op("add"), x, l1);
+    auto conv = mm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), l2);
+    auto mb = mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}),
+                                  conv);
+    mm->add_return({mm->add_instruction(migraphx::make_op("mul"), add, mb)});
+
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+
+    std::string filename = "migraphx_program_literals.mxr";
+    migraphx::save(p1, filename);
+    EXPECT(migraphx::read_buffer(filename) == buffer);
+    migraphx::program p3 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p3.sort());
+}
+
+TEST_CASE(msgpack_compatible)
+{
+    // The streaming writer must produce the same bytes as serializing the value
+    migraphx::program p1     = create_program();
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    EXPECT(buffer == migraphx::to_msgpack(p1.to_value()));
+    migraphx::program p2;
+    p2.from_value(migraphx::from_msgpack(buffer));
+    EXPECT(p1.sort() == p2.sort());
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
@@ -65,6 +110,60 @@ TEST_CASE(compiled)
     EXPECT(p1.sort() == p2.sort());
 }
 
+// An operator with a binary attribute, like the literals of a compiled program
+struct test_binary_op
+{
+    migraphx::argument data;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.data, "data"));
+    }
+
+    std::string name() const { return "serialize_program::binary_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const
+    {
+        return data.get_shape();
+    }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        return data;
+    }
+};
+
+TEST_CASE(compiled_binary_attribute)
+{
+    migraphx::register_op<test_binary_op>();
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x   = mm->add_parameter("x", s);
+    auto l   = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    auto b   = mm->add_instruction(
+        test_binary_op{migraphx::literal{s, {10, 20, 30, 40}}.get_argument()});
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, l);
+    auto l2  = mm->add_literal(migraphx::literal{s, {5, 6, 7, 8}});
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, b);
+    mm->add_return({mm->add_instruction(migraphx::make_op("add"), mul, l2)});
+    p1.compile(migraphx::ref::target{});
+
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    EXPECT(buffer == migraphx::to_msgpack(p1.to_value()));
+    migraphx::program p2 = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+
+    migraphx::parameter_map params;
+    params["x"] = migraphx::literal{s, {1, 1, 1, 1}}.get_argument();
+    auto r1     = p1.eval(params).back();
+    auto r2     = p2.eval(params).back();
+    EXPECT(r1 == r2);
+    std::vector<float> gold = {25, 66, 127, 208};
+    std::vector<float> result;
+    r2.visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    EXPECT(result == gold);
+}
+
 TEST_CASE(unknown_format)
 {
     migraphx::file_options options;
@@ -619,4 +619,38 @@ TEST_CASE(test_with_type)
     EXPECT(s.strides() == new_s.strides());
 }
 
+TEST_CASE(test_with_type_bytes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto new_s = s.with_type(migraphx::shape::int8_type);
+    EXPECT(s.bytes() == 24);
+    EXPECT(new_s.bytes() == 6);
+    EXPECT(new_s.type_size() == 1);
+    EXPECT(new_s.elements() == 6);
+    EXPECT(new_s.standard());
+}
+
+TEST_CASE(test_shape_scalar_shared)
+{
+    migraphx::shape s1{migraphx::shape::half_type};
+    migraphx::shape s2{migraphx::shape::half_type};
+    migraphx::shape s3{migraphx::shape::float_type};
+    EXPECT(s1 == s2);
+    EXPECT(s1 != s3);
+    EXPECT(s1.scalar());
+    EXPECT(s1.standard());
+    EXPECT(s1.elements() == 1);
+    EXPECT(s3.bytes() == 4);
+}
+
+TEST_CASE(test_shape_transposed_broadcasted)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}, {1, 0, 2}};
+    EXPECT(s.broadcasted());
+    EXPECT(s.transposed());
+    EXPECT(not s.standard());
+    EXPECT(not s.packed());
+    EXPECT(not s.scalar());
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,191 @@
+#include <migraphx/sparsify_weights.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/normalize_ops.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/float_equal.hpp>
+
+#include <test.hpp>
+
+static void run_pass(migraphx::program& p, double threshold = 0.5)
+{
+    migraphx::run_passes(*p.get_main_module(),
+                         {migraphx::normalize_ops{},
+                          migraphx::sparsify_weights{threshold},
+                          migraphx::dead_code_elimination{}});
+}
+
+static std::vector<float> run_prog(migraphx::program p, const migraphx::parameter_map& m)
+{
+    p.compile(migraphx::ref::target{});
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static bool has_sparse_dot(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "sparse_dot"; });
+}
+
+// The {n, k} weights with only one in every keep 4x8 blocks left
+static std::vector<float> pruned_values(std::size_t n, std::size_t k, std::size_t keep = 3)
+{
+    auto w = migraphx::generate_literal({migraphx::shape::float_type, {n, k}}, 1);
+    std::vector<float> v;
+    w.visit([&](auto x) { v.assign(x.begin(), x.end()); });
+    for(std::size_t i = 0; i < n; i++)
+    {
+        for(std::size_t j = 0; j < k; j++)
+        {
+            if((i / 4 + j / 8) % keep != 0)
+                v[i * k + j] = 0;
+        }
+    }
+    return v;
+}
+
+// The pruned weights of a dot, which are stored as {k, n}
+static migraphx::literal pruned_weights(std::size_t n, std::size_t k, std::size_t keep = 3)
+{
+    auto v = pruned_values(n, k, keep);
+    std::vector<float> t(v.size());
+    for(std::size_t i = 0; i < n; i++)
+    {
+        for(std::size_t j = 0; j < k; j++)
+            t[j * n + i] = v[i * k + j];
+    }
+    return {migraphx::shape{migraphx::shape::float_type, {k, n}}, t};
+}
+
+TEST_CASE(block_sparsity)
+{
+    std::vector<float> v(8 * 16, 0);
+    // One nonzero in the first block, and one in the last block
+    v[0]               = 1;
+    v[7 * 16 + 15]     = 1;
+    migraphx::shape s{migraphx::shape::float_type, {8, 16}};
+    migraphx::argument a{s, v.data()};
+    EXPECT(migraphx::float_equal(migraphx::block_sparsity(a, 4, 8), 0.5));
+    EXPECT(migraphx::float_equal(migraphx::block_sparsity(a, 8, 16), 0.0));
+    EXPECT(migraphx::float_equal(migraphx::block_sparsity(a, 1, 1), 1.0 - 2.0 / 128));
+}
+
+TEST_CASE(sparse_dot)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {3, 48}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(pruned_weights(16, 48));
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto sp = p;
+    run_pass(sp);
+    EXPECT(has_sparse_dot(sp));
+    // The dense weights are removed
+    auto* smm = sp.get_main_module();
+    EXPECT(std::none_of(smm->begin(), smm->end(), [&](const auto& ins) {
+        return ins.name() == "@literal" and ins.get_shape() == w->get_shape();
+    }));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::verify_range(run_prog(p, m), run_prog(sp, m)));
+}
+
+TEST_CASE(sparse_dot_batch)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {2, 3, 32}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(pruned_weights(8, 32));
+    auto wb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {2, 32, 8}}}), w);
+    mm->add_instruction(migraphx::make_op("dot"), x, wb);
+
+    auto sp = p;
+    run_pass(sp);
+    EXPECT(has_sparse_dot(sp));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::verify_range(run_prog(p, m), run_prog(sp, m)));
+}
+
+TEST_CASE(sparse_convolution)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {2, 8, 6, 6}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(
+        migraphx::literal{{migraphx::shape::float_type, {8, 8, 3, 3}}, pruned_values(8, 72)});
+    mm->add_instruction(
+        migraphx::make_op("convolution", {{"padding", {1, 1}}, {"stride", {2, 2}}}), x, w);
+
+    auto sp = p;
+    run_pass(sp);
+    EXPECT(has_sparse_dot(sp));
+    EXPECT(std::none_of(sp.get_main_module()->begin(),
+                        sp.get_main_module()->end(),
+                        [](const auto& ins) { return ins.name() == "convolution"; }));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::verify_range(run_prog(p, m), run_prog(sp, m)));
+}
+
+TEST_CASE(dense_weights)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {3, 48}});
+    // Two thirds of the blocks are zero, which is below the threshold
+    auto w = mm->add_literal(pruned_weights(16, 48));
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto sp = p;
+    run_pass(sp, 0.9);
+    EXPECT(not has_sparse_dot(sp));
+}
+
+TEST_CASE(uneven_blocks)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {3, 12}});
+    // n is not a multiple of the block rows
+    auto w = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {12, 6}},
+                                               std::vector<float>(72, 0)});
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto sp = p;
+    run_pass(sp);
+    EXPECT(not has_sparse_dot(sp));
+}
+
+TEST_CASE(zero_weights)
+{
+    migraphx::shape sx{migraphx::shape::float_type, {3, 16}};
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", sx);
+    auto w   = mm->add_literal(
+        migraphx::literal{{migraphx::shape::float_type, {16, 8}}, std::vector<float>(128, 0)});
+    mm->add_instruction(migraphx::make_op("dot"), x, w);
+
+    auto sp = p;
+    run_pass(sp);
+    EXPECT(has_sparse_dot(sp));
+
+    migraphx::parameter_map m{{"x", migraphx::generate_argument(sx, 2)}};
+    EXPECT(migraphx::verify_range(run_prog(p, m), run_prog(sp, m)));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,289 @@
+#include <migraphx/split_batch.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/marker.hpp>
+#include <migraphx/ref/target.hpp>
+#include <migraphx/verify.hpp>
+
+#include <test.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+static void run_pass(migraphx::program& p, std::size_t splits)
+{
+    migraphx::run_passes(p, {migraphx::split_batch{splits}, migraphx::dead_code_elimination{}});
+}
+
+static std::vector<std::vector<float>> run_prog(migraphx::program p,
+                                                const migraphx::parameter_map& m)
+{
+    p.compile(migraphx::ref::target{});
+    std::vector<std::vector<float>> result;
+    for(const auto& r : p.eval(m))
+    {
+        result.emplace_back();
+        r.visit([&](auto output) { result.back().assign(output.begin(), output.end()); });
+    }
+    return result;
+}
+
+static bool verify_outputs(const migraphx::program& p,
+                           const migraphx::program& sp,
+                           const migraphx::parameter_map& m)
+{
+    auto expected = run_prog(p, m);
+    auto results  = run_prog(sp, m);
+    if(expected.size() != results.size())
+        return false;
+    for(std::size_t i = 0; i < expected.size(); i++)
+    {
+        if(not migraphx::verify_range(expected[i], results[i]))
+            return false;
+    }
+    return true;
+}
+
+// The batch sizes of the sub-batch modules, or nothing when it is not split
+static std::vector<std::size_t> sub_batches(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    auto run       = std::find_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "run_parallel"; });
+    if(run == mm->end())
+        return {};
+    std::vector<std::size_t> result;
+    for(auto mod : run->module_inputs())
+    {
+        EXPECT(migraphx::is_batch_module(*mod));
+        result.push_back(mod->get_output_shapes().front().lens().front());
+    }
+    return result;
+}
+
+static migraphx::parameter_map generate_params(const migraphx::program& p)
+{
+    migraphx::parameter_map m;
+    std::size_t seed = 0;
+    for(auto&& x : p.get_parameter_shapes())
+        m[x.first] = migraphx::generate_argument(x.second, seed++);
+    return m;
+}
+
+TEST_CASE(split)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {6, 4}});
+    auto y   = mm->add_parameter("y", {migraphx::shape::float_type, {6, 4}});
+    auto w   = mm->add_literal(migraphx::generate_literal({migraphx::shape::float_type, {4, 3}}));
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto dot = mm->add_instruction(migraphx::make_op("dot"), add, w);
+    mm->add_instruction(migraphx::make_op("relu"), dot);
+
+    auto sp = p;
+    run_pass(sp, 3);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{2, 2, 2});
+    EXPECT(sp.get_output_shapes() == p.get_output_shapes());
+    EXPECT(verify_outputs(p, sp, generate_params(p)));
+}
+
+// Checks that each instruction is stopped before the one started before it
+struct nesting_marker
+{
+    struct state
+    {
+        std::mutex m;
+        std::vector<migraphx::instruction_ref> started;
+        std::size_t marked = 0;
+        bool nested        = true;
+    };
+    std::shared_ptr<state> s = std::make_shared<state>();
+
+    void mark_start(migraphx::instruction_ref ins)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s->m);
+            s->started.push_back(ins);
+            s->marked++;
+        }
+        // Give any other sub-batch time to start in between
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    void mark_stop(migraphx::instruction_ref ins)
+    {
+        std::lock_guard<std::mutex> lock(s->m);
+        s->nested = s->nested and not s->started.empty() and s->started.back() == ins;
+        if(not s->started.empty())
+            s->started.pop_back();
+    }
+    void mark_start(const migraphx::program&) {}
+    void mark_stop(const migraphx::program&) {}
+};
+
+TEST_CASE(mark_sub_batches)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {8, 64}});
+    auto e   = mm->add_instruction(migraphx::make_op("exp"), x);
+    mm->add_instruction(migraphx::make_op("relu"), e);
+
+    run_pass(p, 4);
+    EXPECT(sub_batches(p) == std::vector<std::size_t>{2, 2, 2, 2});
+    p.compile(migraphx::ref::target{});
+    // The sub-batches share the marker, so they take turns while marked
+    nesting_marker m;
+    p.mark(generate_params(p), m);
+    EXPECT(m.s->nested);
+    EXPECT(m.s->started.empty());
+    EXPECT(m.s->marked > 4);
+}
+
+TEST_CASE(uneven_batch)
+{
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto x    = mm->add_parameter("x", {migraphx::shape::float_type, {5, 3, 4}});
+    auto bias = mm->add_parameter("bias", {migraphx::shape::float_type, {4}});
+    auto b =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {5, 3, 4}}}), bias);
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, b);
+    auto sm  = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 2}}), add);
+    mm->add_return({sm});
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{3, 2});
+    EXPECT(verify_outputs(p, sp, generate_params(p)));
+}
+
+TEST_CASE(more_splits_than_batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {2, 8}});
+    mm->add_instruction(migraphx::make_op("tanh"), x);
+
+    auto sp = p;
+    run_pass(sp, 4);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{1, 1});
+    EXPECT(verify_outputs(p, sp, generate_params(p)));
+}
+
+TEST_CASE(channels_as_batch)
+{
+    migraphx::program p;
+    auto* mm  = p.get_main_module();
+    auto x    = mm->add_parameter("x", {migraphx::shape::float_type, {4, 4, 3, 3}});
+    auto bias = mm->add_parameter("bias", {migraphx::shape::float_type, {4}});
+    auto b    = mm->add_instruction(
+        migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", {4, 4, 3, 3}}}), bias);
+    mm->add_instruction(migraphx::make_op("add"), x, b);
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{2, 2});
+    EXPECT(verify_outputs(p, sp, generate_params(p)));
+}
+
+TEST_CASE(multiple_outputs)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 2, 6}});
+    auto r   = mm->add_instruction(migraphx::make_op("relu"), x);
+    auto t =
+        mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 1}}}), r);
+    auto rs = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), x);
+    auto rr = mm->add_instruction(migraphx::make_op("reshape", {{"dims", {4, 6}}}), rs);
+    mm->add_return({t, rr, t});
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{2, 2});
+    EXPECT(sp.get_output_shapes().size() == 3);
+    EXPECT(verify_outputs(p, sp, generate_params(p)));
+}
+
+TEST_CASE(reduce_batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8}});
+    auto r   = mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {0}}}), x);
+    mm->add_instruction(migraphx::make_op("relu"), r);
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp).empty());
+    EXPECT(sp == p);
+}
+
+TEST_CASE(gathernd_batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8}});
+    auto i   = mm->add_parameter("i", {migraphx::shape::int64_type, {4, 1}});
+    // The indices can read any item of the batch
+    auto g = mm->add_instruction(migraphx::make_op("gathernd"), x, i);
+    mm->add_instruction(migraphx::make_op("relu"), g);
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp).empty());
+    EXPECT(sp == p);
+}
+
+TEST_CASE(gathernd_batch_dims)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8}});
+    auto i   = mm->add_parameter("i", {migraphx::shape::int64_type, {4, 1}});
+    // The indices only read from their own item of the batch
+    auto g = mm->add_instruction(migraphx::make_op("gathernd", {{"batch_dims", 1}}), x, i);
+    mm->add_instruction(migraphx::make_op("relu"), g);
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp) == std::vector<std::size_t>{2, 2});
+
+    std::vector<int64_t> indices = {7, 0, 3, 5};
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(x->get_shape());
+    m["i"] = migraphx::argument{i->get_shape(), indices.data()};
+    EXPECT(verify_outputs(p, sp, m));
+}
+
+TEST_CASE(reshape_batch)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8}});
+    // The batch is merged with the other dimension
+    mm->add_instruction(migraphx::make_op("reshape", {{"dims", {8, 4}}}), x);
+
+    auto sp = p;
+    run_pass(sp, 2);
+    EXPECT(sub_batches(sp).empty());
+}
+
+TEST_CASE(batch_of_one)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {1, 8}});
+    mm->add_instruction(migraphx::make_op("relu"), x);
+
+    auto sp = p;
+    run_pass(sp, 4);
+    EXPECT(sub_batches(sp).empty());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
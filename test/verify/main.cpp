@@ -45,6 +45,12 @@ int main(int argc, const char* argv[])
     run_verify rv;
     rv.add_validation_for("gpu", &validate_gpu);
     rv.disable_test_for("cpu", {"test_if_lp", "test_if_param", "test_if_literal"});
-    rv.disable_test_for("gpu", {"test_conv_bn_add"});
+    rv.disable_test_for("gpu",
+                        {"test_conv_bn_add",
+                         "test_sparse_dot",
+                         "test_sparse_dot_blocks",
+                         "test_sparse_dot_rows",
+                         "test_weight_dot_int4",
+                         "test_weight_dot_int8"});
     rv.run(argc, argv);
 }
@@ -0,0 +1,62 @@
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+migraphx::instruction_ref add_scaled_scores(migraphx::module& m,
+                                            migraphx::instruction_ref q,
+                                            migraphx::instruction_ref k,
+                                            float scale)
+{
+    auto kt =
+        m.add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), k);
+    auto scores   = m.add_instruction(migraphx::make_op("dot"), q, kt);
+    auto s        = m.add_literal(scale);
+    auto s_mbcast = m.add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", scores->get_shape().lens()}}), s);
+    return m.add_instruction(migraphx::make_op("mul"), scores, s_mbcast);
+}
+
+struct test_attention : verify_program<test_attention>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape s{migraphx::shape::float_type, {1, 2, 12, 8}};
+        auto q      = mm->add_parameter("q", s);
+        auto k      = mm->add_parameter("k", s);
+        auto v      = mm->add_parameter("v", s);
+        auto scores = add_scaled_scores(*mm, q, k, 0.35f);
+        auto probs  = mm->add_instruction(migraphx::make_op("softmax", {{"axis", -1}}), scores);
+        mm->add_instruction(migraphx::make_op("dot"), probs, v);
+        return p;
+    }
+};
+
+struct test_attention_mask : verify_program<test_attention_mask>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape qs{migraphx::shape::float_type, {2, 3, 7, 16}};
+        migraphx::shape ks{migraphx::shape::float_type, {2, 3, 150, 16}};
+        migraphx::shape vs{migraphx::shape::float_type, {2, 3, 150, 5}};
+        migraphx::shape ms{migraphx::shape::float_type, {2, 1, 1, 150}};
+        auto q    = mm->add_parameter("q", qs);
+        auto k    = mm->add_parameter("k", ks);
+        auto v    = mm->add_parameter("v", vs);
+        auto mask = mm->add_parameter("mask", ms);
+        auto scaled = add_scaled_scores(*mm, q, k, 0.25f);
+        auto lens   = scaled->get_shape().lens();
+        auto mask_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", lens}}), mask);
+        auto masked = mm->add_instruction(migraphx::make_op("add"), scaled, mask_mbcast);
+        auto probs  = mm->add_instruction(migraphx::make_op("softmax", {{"axis", 3}}), masked);
+        mm->add_instruction(migraphx::make_op("dot"), probs, v);
+        return p;
+    }
+};
@@ -0,0 +1,19 @@
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_gemm_literal_weights : verify_program<test_gemm_literal_weights>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto a   = mm->add_parameter("a", migraphx::shape{migraphx::shape::float_type, {1, 64}});
+        auto b   = mm->add_literal(
+            migraphx::generate_literal(migraphx::shape{migraphx::shape::float_type, {64, 96}}));
+        mm->add_instruction(migraphx::make_op("dot"), a, b);
+        return p;
+    }
+};
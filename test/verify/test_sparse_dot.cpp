@@ -0,0 +1,55 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+// A sparse_dot of a transposed input with 4 rows of blocks, where each row of
+// blocks keeps a different number of the block columns, and the second one
+// keeps none
+static migraphx::program create_sparse_dot(std::size_t block_rows, std::size_t block_cols)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {2, 64, 5}});
+    auto xt = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 1}}}), x);
+    std::vector<std::int32_t> indices;
+    std::vector<std::int32_t> offsets = {0};
+    for(std::size_t r = 0; r < 4; r++)
+    {
+        for(std::size_t c = 0; c < 64 / block_cols; c++)
+        {
+            if(r != 1 and (c + r) % (r + 1) == 0)
+                indices.push_back(c);
+        }
+        offsets.push_back(indices.size());
+    }
+    auto values = mm->add_literal(migraphx::generate_literal(
+        migraphx::shape{migraphx::shape::float_type, {indices.size(), block_rows, block_cols}}));
+    auto idx = mm->add_literal(
+        migraphx::literal{migraphx::shape{migraphx::shape::int32_type, {indices.size()}}, indices});
+    auto off = mm->add_literal(
+        migraphx::literal{migraphx::shape{migraphx::shape::int32_type, {offsets.size()}}, offsets});
+    mm->add_instruction(
+        migraphx::make_op("sparse_dot", {{"block_rows", block_rows}, {"block_cols", block_cols}}),
+        xt,
+        values,
+        idx,
+        off);
+    return p;
+}
+
+struct test_sparse_dot : verify_program<test_sparse_dot>
+{
+    migraphx::program create_program() const { return create_sparse_dot(4, 8); }
+};
+
+struct test_sparse_dot_rows : verify_program<test_sparse_dot_rows>
+{
+    migraphx::program create_program() const { return create_sparse_dot(1, 8); }
+};
+
+// A block size without a specialized kernel on the cpu
+struct test_sparse_dot_blocks : verify_program<test_sparse_dot_blocks>
+{
+    migraphx::program create_program() const { return create_sparse_dot(2, 4); }
+};
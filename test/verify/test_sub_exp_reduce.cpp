@@ -0,0 +1,22 @@
+
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_sub_exp_reduce : verify_program<test_sub_exp_reduce>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {2, 3, 4, 5}});
+        auto y = mm->add_parameter("y", migraphx::shape{migraphx::shape::float_type, {2, 4, 5, 3}});
+        auto yt =
+            mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), y);
+        auto sub = mm->add_instruction(migraphx::make_op("sub"), x, yt);
+        auto exp = mm->add_instruction(migraphx::make_op("exp"), sub);
+        mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1, 3}}}), exp);
+        return p;
+    }
+};
@@ -0,0 +1,23 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_weight_dot_int4 : verify_program<test_weight_dot_int4>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {2, 40, 3}});
+        auto xt =
+            mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {0, 2, 1}}}), x);
+        auto w = mm->add_literal(
+            migraphx::generate_literal(migraphx::shape{migraphx::shape::int8_type, {12, 20}}));
+        auto s = mm->add_literal(
+            migraphx::generate_literal(migraphx::shape{migraphx::shape::float_type, {12, 5}}));
+        mm->add_instruction(
+            migraphx::make_op("weight_dot", {{"bits", 4}, {"group_size", 8}}), xt, w, s);
+        return p;
+    }
+};
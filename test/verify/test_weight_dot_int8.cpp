@@ -0,0 +1,21 @@
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_weight_dot_int8 : verify_program<test_weight_dot_int8>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, {40, 64}});
+        auto w   = mm->add_literal(
+            migraphx::generate_literal(migraphx::shape{migraphx::shape::int8_type, {20, 64}}));
+        auto s = mm->add_literal(
+            migraphx::generate_literal(migraphx::shape{migraphx::shape::float_type, {20, 2}}));
+        mm->add_instruction(
+            migraphx::make_op("weight_dot", {{"bits", 8}, {"group_size", 32}}), x, w, s);
+        return p;
+    }
+};
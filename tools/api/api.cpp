@@ -2,6 +2,7 @@
 #include <migraphx/rank.hpp>
 #include <migraphx/shape.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/executor.hpp>
 #include <migraphx/onnx.hpp>
 #include <migraphx/tf.hpp>
 #include <migraphx/instruction_ref.hpp>
@@ -15,7 +16,10 @@
 #include <migraphx/json.hpp>
 #include <migraphx/convert_to_json.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cstdarg>
+#include <future>
+#include <mutex>
 
 namespace migraphx {
 
@@ -207,6 +211,28 @@ bool equal(const T& x, const T& y)
 
 std::vector<argument> run(program& p, const parameter_map& params) { return p.eval(params); }
 
+std::vector<argument> run(program& p, const parameter_binding& binding) { return p.eval(binding); }
+
+// The result of a run that can be copied by the handles
+struct async_result
+{
+    std::shared_future<std::vector<argument>> future;
+};
+
+async_result run_async(executor& e, const parameter_map& params)
+{
+    return {e.eval_async(params).share()};
+}
+
+bool ready(const async_result& r)
+{
+    return r.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void wait(const async_result& r) { r.future.wait(); }
+
+std::vector<argument> get(const async_result& r) { return r.future.get(); }
+
 std::vector<shape> get_output_shapes(program& p) { return p.get_output_shapes(); }
 
 void print_program(const program& p) { std::cout << p << std::endl; }
@@ -224,26 +250,81 @@ struct experimental_custom_op
 template <class CustomOp>
 struct custom_operation
 {
+    CustomOp op;
+    // Set by the lowering of a target when the buffer of the output is
+    // passed as the last input, so it is part of the memory planning
+    bool output_buffer = false;
+    // Calls of ops that are not thread safe are serialized. The mutex is
+    // shared by every copy of the op.
+    bool thread_safe                  = false;
+    std::shared_ptr<std::mutex> guard = std::make_shared<std::mutex>();
+
     template <class Self, class F>
-    static auto reflect(Self&, F)
+    static auto reflect(Self& self, F f)
     {
-        return pack();
+        return pack(f(self.output_buffer, "output_buffer"));
     }
-    CustomOp op;
+
     std::string name() const { return op.xobject.name; }
 
+    value attributes() const { return {{"custom_op", true}}; }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
+        if(output_buffer)
+            inputs.pop_back();
         return op.compute_shape(std::move(inputs));
     }
 
-    argument compute(const std::vector<argument>&) const { MIGRAPHX_THROW("Not computable"); }
+    std::ptrdiff_t custom_alias(std::vector<shape> inputs) const
+    {
+        if(op.output_alias_f == nullptr)
+            return -1;
+        auto i = op.output_alias(std::move(inputs));
+        return i < 0 ? -1 : i;
+    }
+
+    std::ptrdiff_t output_alias(std::vector<shape> inputs) const
+    {
+        if(output_buffer)
+        {
+            inputs.pop_back();
+            auto i = custom_alias(inputs);
+            return i < 0 ? std::ptrdiff_t(inputs.size()) : i;
+        }
+        return custom_alias(std::move(inputs));
+    }
+
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> inputs) const
+    {
+        argument output;
+        if(output_buffer)
+        {
+            output = inputs.back();
+            inputs.pop_back();
+        }
+        else
+        {
+            std::vector<shape> shapes(inputs.size());
+            std::transform(inputs.begin(), inputs.end(), shapes.begin(), [](const auto& a) {
+                return a.get_shape();
+            });
+            auto i = custom_alias(shapes);
+            output = i < 0 ? argument{output_shape} : inputs.at(i);
+        }
+        if(thread_safe)
+            return op.compute(ctx, output, std::move(inputs));
+        std::lock_guard<std::mutex> lock(*guard);
+        return op.compute(ctx, output, std::move(inputs));
+    }
 };
 
 template <class CustomOp>
 void register_custom_op(const CustomOp& op)
 {
-    register_op(custom_operation<CustomOp>{op});
+    custom_operation<CustomOp> x{op};
+    x.thread_safe = op.thread_safe_f != nullptr and op.thread_safe();
+    register_op(x);
 }
 
 migraphx::context get_context(const program& p) { return p.get_context(); }